@@ -117,6 +117,10 @@ class BASE_EXPORT_PRIVATE JSONParser {
     // Appends a string to the std::string. Must be Convert()ed to use.
     void AppendString(const std::string& str);
 
+    // Appends |length| ASCII characters at |str|, which is the current
+    // position in the input, so this is O(1) unless Convert()ed.
+    void AppendRun(const char* str, int length);
+
     // Converts the builder from its default StringPiece to a full std::string,
     // performing a copy. Once a builder is converted, it cannot be made a
     // StringPiece again.
@@ -0,0 +1,110 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// Helpers locating the next byte of a JSON string body which cannot be
+// handled as part of a plain run, so callers copy clean runs in bulk. Scans
+// 16 bytes at a time where SSE2 is part of the baseline ISA.
+
+#ifndef BASE_JSON_JSON_STRING_SCAN_H_
+#define BASE_JSON_JSON_STRING_SCAN_H_
+
+#include <stddef.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BASE_JSON_SCAN_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace base {
+namespace internal {
+
+// True for bytes JsonDoubleQuote() never copies verbatim: controls, DEL,
+// non-ASCII, '"', '\\', '<' and '>'.
+inline bool IsJsonEscapeByte(unsigned char c) {
+  return c < 0x20 || c > 0x7E || c == '"' || c == '\\' || (c | 2) == '>';
+}
+
+// True for bytes terminating a plain run in a string body being parsed:
+// '"', '\\' and non-ASCII (which requires UTF-8 validation).
+inline bool IsJsonStringSpecialByte(unsigned char c) {
+  return c >= 0x80 || c == '"' || c == '\\';
+}
+
+#if defined(BASE_JSON_SCAN_SSE2)
+inline size_t LowestSetBit(int mask) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, static_cast<unsigned long>(mask));
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+// Returns offset of the first IsJsonEscapeByte() byte of |data|, or |length|.
+inline size_t FindJsonEscapeByte(const char* data, size_t length) {
+  size_t i = 0;
+#if defined(BASE_JSON_SCAN_SSE2)
+  const __m128i space = _mm_set1_epi8(0x20);
+  const __m128i del = _mm_set1_epi8(0x7F);
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i two = _mm_set1_epi8(2);
+  const __m128i angle = _mm_set1_epi8('>');
+  for (; i + 16 <= length; i += 16) {
+    const __m128i x =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    // Signed compare catches both controls and bytes >= 0x80.
+    __m128i special = _mm_cmplt_epi8(x, space);
+    special = _mm_or_si128(special, _mm_cmpeq_epi8(x, del));
+    special = _mm_or_si128(special, _mm_cmpeq_epi8(x, quote));
+    special = _mm_or_si128(special, _mm_cmpeq_epi8(x, backslash));
+    special = _mm_or_si128(special,
+                           _mm_cmpeq_epi8(_mm_or_si128(x, two), angle));
+    const int mask = _mm_movemask_epi8(special);
+    if (mask)
+      return i + LowestSetBit(mask);
+  }
+#endif
+  for (; i < length; ++i) {
+    if (IsJsonEscapeByte(static_cast<unsigned char>(data[i])))
+      return i;
+  }
+  return length;
+}
+
+// Returns offset of the first IsJsonStringSpecialByte() byte of |data|, or
+// |length|.
+inline size_t FindJsonStringSpecialByte(const char* data, size_t length) {
+  size_t i = 0;
+#if defined(BASE_JSON_SCAN_SSE2)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  for (; i + 16 <= length; i += 16) {
+    const __m128i x =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const __m128i special = _mm_or_si128(_mm_cmpeq_epi8(x, quote),
+                                         _mm_cmpeq_epi8(x, backslash));
+    // High bit of |x| itself marks non-ASCII bytes.
+    const int mask = _mm_movemask_epi8(_mm_or_si128(special, x));
+    if (mask)
+      return i + LowestSetBit(mask);
+  }
+#endif
+  for (; i < length; ++i) {
+    if (IsJsonStringSpecialByte(static_cast<unsigned char>(data[i])))
+      return i;
+  }
+  return length;
+}
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_JSON_JSON_STRING_SCAN_H_
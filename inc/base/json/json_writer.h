@@ -9,6 +9,7 @@
 
 #include "base/base_export.h"
 #include "base/basictypes.h"
+#include "base/string_piece.h"
 
 namespace base {
 
@@ -37,6 +38,16 @@ class BASE_EXPORT JSONWriter {
     OPTIONS_PRETTY_PRINT = 1 << 3
   };
 
+  // Receiver of JSON data produced by WriteToSink().
+  class BASE_EXPORT Sink {
+   public:
+    virtual ~Sink() {}
+
+    // Consumes next |length| bytes of JSON text. Returns false to abort
+    // writing.
+    virtual bool Write(const char* data, size_t length) = 0;
+  };
+
   // Given a root node, generates a JSON string and puts it into |json|.
   // TODO(tc): Should we generate json if it would be invalid json (e.g.,
   // |node| is not a DictionaryValue/ListValue or if there are inf/-inf float
@@ -48,6 +59,13 @@ class BASE_EXPORT JSONWriter {
   static void WriteWithOptions(const Value* const node, int options,
                                std::string* json);
 
+  // Same as WriteWithOptions() but does not build whole JSON string in
+  // memory: output is passed to |sink| in pieces of about |chunk_size| bytes,
+  // long string values are escaped piece by piece as well.
+  // Returns false if |sink| refused data.
+  static bool WriteToSink(const Value* const node, int options,
+                          size_t chunk_size, Sink* sink);
+
   // A static, constant JSON string representing an empty array.  Useful
   // for empty JSON argument passing.
   static const char* kEmptyArray;
@@ -64,6 +82,16 @@ class BASE_EXPORT JSONWriter {
   // Appends a quoted, escaped, version of (UTF-8) str to json_string_.
   void AppendQuotedString(const std::string& str);
 
+  // Same as above, but honours |escape_| and, when writing to a sink,
+  // splits |str| so that json_string_ never grows much beyond chunk_size_.
+  void AppendQuotedValue(const StringPiece& str);
+
+  // Passes json_string_ to sink_ once it holds at least chunk_size_ bytes.
+  void MaybeFlush();
+
+  // Passes whatever json_string_ holds to sink_.
+  void Flush();
+
   // Adds space to json_string_ for the indent level.
   void IndentLine(int depth);
 
@@ -75,6 +103,11 @@ class BASE_EXPORT JSONWriter {
   // Where we write JSON data as we generate it.
   std::string* json_string_;
 
+  // Optional receiver of json_string_ contents, see WriteToSink().
+  Sink* sink_;
+  size_t chunk_size_;
+  bool sink_failed_;
+
   DISALLOW_COPY_AND_ASSIGN(JSONWriter);
 };
 
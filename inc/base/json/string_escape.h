@@ -11,6 +11,7 @@
 
 #include "base/base_export.h"
 #include "base/string16.h"
+#include "base/string_piece.h"
 
 namespace base {
 
@@ -26,6 +27,13 @@ BASE_EXPORT void JsonDoubleQuote(const std::string& str,
 // Same as above, but always returns the result double quoted.
 BASE_EXPORT std::string GetDoubleQuotedJson(const std::string& str);
 
+// Same as JsonDoubleQuote(UTF8ToUTF16(str), ...), without the intermediate
+// UTF-16 copy: non-ASCII characters of UTF-8 |str| come out as \uXXXX escapes
+// of their UTF-16 code units.
+BASE_EXPORT void JsonDoubleQuoteUTF8(const StringPiece& str,
+                                     bool put_in_quotes,
+                                     std::string* dst);
+
 BASE_EXPORT void JsonDoubleQuote(const string16& str,
                                  bool put_in_quotes,
                                  std::string* dst);
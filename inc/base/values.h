@@ -30,6 +30,7 @@
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/string16.h"
+#include "base/string_piece.h"
 
 // This file declares "using base::Value", etc. at the bottom, so that
 // current code can use these classes without the base namespace. In
@@ -95,6 +96,9 @@ class BASE_EXPORT Value {
   virtual bool GetAsDouble(double* out_value) const;
   virtual bool GetAsString(std::string* out_value) const;
   virtual bool GetAsString(string16* out_value) const;
+  // Points |out_value| to UTF-8 string data without copying it. The data is
+  // valid while this value lives and is not changed.
+  virtual bool GetAsStringPiece(StringPiece* out_value) const;
   virtual bool GetAsList(ListValue** out_value);
   virtual bool GetAsList(const ListValue** out_value) const;
   virtual bool GetAsDictionary(DictionaryValue** out_value);
@@ -165,6 +169,7 @@ class BASE_EXPORT StringValue : public Value {
   // Overridden from Value:
   virtual bool GetAsString(std::string* out_value) const OVERRIDE;
   virtual bool GetAsString(string16* out_value) const OVERRIDE;
+  virtual bool GetAsStringPiece(StringPiece* out_value) const OVERRIDE;
   virtual StringValue* DeepCopy() const OVERRIDE;
   virtual bool Equals(const Value* other) const OVERRIDE;
 
@@ -0,0 +1,59 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef WEBDRIVER_COMMANDS_ACTIONS_COMMAND_H_
+#define WEBDRIVER_COMMANDS_ACTIONS_COMMAND_H_
+
+#include <string>
+#include <vector>
+
+#include "commands/webdriver_command.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace webdriver {
+
+class Response;
+
+/// Performs or releases W3C input actions. See:
+/// https://www.w3.org/TR/webdriver/#actions
+/// POST parameter "actions" - list of input sources (key, pointer with
+/// mouse/pen/touch type, none) with their action sequences. Whole sequence
+/// is scheduled on view thread, so events of all sources keep exact timing.
+/// DELETE releases keys, buttons and touches left pressed by previous calls.
+class ActionsCommand : public ViewCommand {
+public:
+    ActionsCommand(const std::vector<std::string>& path_segments,
+                   const base::DictionaryValue* const parameters);
+    virtual ~ActionsCommand();
+
+    virtual bool DoesPost() const OVERRIDE;
+    virtual bool DoesDelete() const OVERRIDE;
+    virtual void ExecutePost(Response* const response) OVERRIDE;
+    virtual void ExecuteDelete(Response* const response) OVERRIDE;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(ActionsCommand);
+};
+
+}  // namespace webdriver
+
+#endif  // WEBDRIVER_COMMANDS_ACTIONS_COMMAND_H_
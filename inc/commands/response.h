@@ -8,11 +8,24 @@
 #include <sstream>
 #include <string>
 
+#include "base/json/json_writer.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/values.h"
 #include "webdriver_error.h"
 
 namespace webdriver {
 
+/// Producer of non-JSON response body. It is invoked after command is
+/// finished, so it may keep connection busy as long as needed.
+class ResponseBodyStream {
+public:
+    virtual ~ResponseBodyStream() {}
+
+    /// Writes body to |sink| piece by piece.
+    /// @return false if sink refused data
+    virtual bool WriteBody(base::JSONWriter::Sink* sink) = 0;
+};
+
 /// A simple class that encapsulates the information describing the response to
 /// a Command. In Webdriver all responses must be sent back as a JSON value,
 /// conforming to the spec found at:
@@ -47,11 +60,56 @@ public:
     /// Returns a pointer to the actual response dictionary.
     const base::Value* GetDictionary() const;
 
+    /// Transfers response dictionary to caller without copying, this
+    /// response is left empty.
+    base::DictionaryValue* TakeDictionary();
+
     /// Returns this response as a JSON string.
     std::string ToJSON() const;
 
+    /// Serializes this response to JSON piece by piece, without building
+    /// whole string in memory.
+    /// @param chunk_size approximate size of pieces passed to sink
+    /// @param sink receiver of serialized data
+    /// @return false if sink refused data
+    bool WriteJSON(size_t chunk_size, base::JSONWriter::Sink* sink) const;
+
+    /// Replaces JSON body of successful response with binary data.
+    /// Content of |body| is swapped into this object.
+    void SetRawBody(const std::string& mime_type, std::string* body);
+
+    /// Replaces JSON body of successful response with data produced by
+    /// |stream|. This object assumes ownership of stream.
+    void SetBodyStream(const std::string& mime_type, ResponseBodyStream* stream);
+
+    /// Sets entity tag of raw body. If it matches If-None-Match header of
+    /// request, server replies with 304 Not Modified and no body.
+    void SetRawBodyETag(const std::string& etag);
+
+    /// Entity tag of raw body, empty if not set.
+    const std::string& GetRawBodyETag() const;
+
+    /// Returns true if response carries raw body instead of JSON.
+    bool HasRawBody() const;
+
+    /// MIME type of raw body.
+    const std::string& GetRawMimeType() const;
+
+    /// Returns true if raw body is produced by stream of unknown length.
+    bool IsRawBodyStreamed() const;
+
+    /// Writes raw body to |sink|.
+    /// @return false if sink refused data
+    bool WriteRawBody(base::JSONWriter::Sink* sink) const;
+
 private:
+    void ClearRawBody();
+
     base::DictionaryValue data_;
+    std::string raw_mime_type_;
+    std::string raw_body_;
+    std::string raw_body_etag_;
+    scoped_ptr<ResponseBodyStream> body_stream_;
 
     DISALLOW_COPY_AND_ASSIGN(Response);
 };
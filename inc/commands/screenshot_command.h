@@ -33,6 +33,47 @@ private:
   	DISALLOW_COPY_AND_ASSIGN(ScreenshotCommand);
 };
 
+/// Take a screenshot of the current view and return it as binary body,
+/// without base64 and JSON wrapping. Last path segment selects format:
+/// "png" (image/png) or "rgba" (application/octet-stream, see ScreenshotFormat).
+/// Response has ETag, so client can revalidate with If-None-Match and get
+/// 304 Not Modified while view is unchanged.
+class RawScreenshotCommand : public ViewCommand {
+public:
+    RawScreenshotCommand(const std::vector<std::string>& path_segments,
+                         const base::DictionaryValue* const parameters);
+    virtual ~RawScreenshotCommand();
+
+    virtual bool DoesGet() const OVERRIDE;
+    virtual void ExecuteGet(Response* const response) OVERRIDE;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(RawScreenshotCommand);
+};
+
+/// Streams screenshots of the current view as multipart/x-mixed-replace body.
+/// New frame is sent only if view was repainted since previous one (views
+/// that can't track repaints are grabbed on every tick).
+/// POST parameters (all optional): "fps" - frame rate, default 5;
+/// "format" - "png" or "rgba"; "frames" - max number of frames;
+/// "duration" - max duration of stream in milliseconds, default 60000 if
+/// no frames limit is given. GET uses defaults.
+/// Stream ends when client disconnects, view or session is closed or limit is reached.
+class ScreenshotStreamCommand : public ViewCommand {
+public:
+    ScreenshotStreamCommand(const std::vector<std::string>& path_segments,
+                            const base::DictionaryValue* const parameters);
+    virtual ~ScreenshotStreamCommand();
+
+    virtual bool DoesGet() const OVERRIDE;
+    virtual bool DoesPost() const OVERRIDE;
+    virtual void ExecuteGet(Response* const response) OVERRIDE;
+    virtual void ExecutePost(Response* const response) OVERRIDE;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(ScreenshotStreamCommand);
+};
+
 }  // namespace webdriver
 
 #endif  // WEBDRIVER_COMMANDS_SCREENSHOT_COMMAND_H_
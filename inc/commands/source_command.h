@@ -33,6 +33,30 @@ private:
   	DISALLOW_COPY_AND_ASSIGN(SourceCommand);
 };
 
+/// Returns page source as changes against source returned by previous call.
+/// POST parameter "revision" - revision of source known to client. If it is
+/// not latest revision (or GET is used), full source is returned.
+/// Response value: {"revision", "full", "source"} or
+/// {"revision", "full": false, "changed": [{"id", "parent", "index", "source"}], "removed": [ids]}.
+/// Nodes are identified by elementId attributes of native views, by their
+/// position in parent for web views.
+class IncrementalSourceCommand : public ViewCommand {
+public:
+    IncrementalSourceCommand(const std::vector<std::string>& path_segments,
+                             const base::DictionaryValue* const parameters);
+    virtual ~IncrementalSourceCommand();
+
+    virtual bool DoesGet() const OVERRIDE;
+    virtual bool DoesPost() const OVERRIDE;
+    virtual void ExecuteGet(Response* const response) OVERRIDE;
+    virtual void ExecutePost(Response* const response) OVERRIDE;
+
+private:
+    void SendChanges(int base_revision, Response* const response);
+
+    DISALLOW_COPY_AND_ASSIGN(IncrementalSourceCommand);
+};
+
 }  // namespace webdriver
 
 #endif  // WEBDRIVER_COMMANDS_SOURCE_COMMAND_H_
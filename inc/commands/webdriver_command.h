@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 
+#include "base/memory/ref_counted.h"
 #include "commands/command.h"
 
 namespace base {
@@ -58,7 +59,7 @@ public:
     virtual bool Init(Response* const response) OVERRIDE;
 
 protected:
-    scoped_ptr<ViewCmdExecutor> executor_;
+    scoped_refptr<ViewCmdExecutor> executor_;
 
 private:
     DISALLOW_COPY_AND_ASSIGN(ViewCommand);
@@ -29,18 +29,28 @@ namespace webdriver {
 
 class Response;
 
+/// Cross-domain RPC: runs command described by {"method", "path", "data"}
+/// parameters. With {"calls": [...]} parameters runs list of such calls in
+/// order and returns list of their responses ({"status", "value"}).
 class XDRPCCommand : public Command {
 public:
+    /// @param parameters owned by command, calls move their "data" out of them
     XDRPCCommand(const std::vector<std::string>& path_segments,
-                 const DictionaryValue* const parameters);
+                 DictionaryValue* const parameters);
     virtual ~XDRPCCommand();
 
     virtual bool DoesPost() const OVERRIDE;
     virtual void ExecutePost(Response* const response) OVERRIDE;
 
 private:
+    // Runs single call, its "data" is moved to called command.
+    void DispatchCall(base::DictionaryValue* call, Response* const response);
+
     static std::string getSessionId(const std::string& url);
 
+    // same dictionary as parameters_, which owns it
+    DictionaryValue* const request_;
+
     DISALLOW_COPY_AND_ASSIGN(XDRPCCommand);
 };
 
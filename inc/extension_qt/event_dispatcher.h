@@ -26,9 +26,17 @@
 class EventDispatcher
 {
 public:
+    virtual ~EventDispatcher() {}
 
     /// Abstract method, should be implemented in descendants
     virtual bool dispatch(QEvent *event, bool consumed)=0;
+
+    /// Called before group of events is dispatched. Dispatchers may queue
+    /// events until endBatch() instead of delivering them one by one.
+    virtual void beginBatch() {}
+
+    /// Called when group of events is dispatched, queued events should be delivered
+    virtual void endBatch() {}
 };
 
 #endif // EVENTDISPATCHER_H
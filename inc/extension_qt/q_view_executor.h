@@ -30,6 +30,7 @@
 
 
 #include <QtCore/QDebug>
+#include <QtCore/QPointer>
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
 #include <QtWidgets/QWidget>
 #include <QtGui/QTouchDevice>
@@ -56,6 +57,8 @@ public:
     virtual void SetBounds(const Rect& bounds, Error** error);
     virtual void Maximize(Error** error);
     virtual void GetScreenShot(std::string* png, Error** error);
+    virtual void GetScreenShotImage(ScreenshotFormat format, std::string* data, Error** error);
+    virtual void GetRepaintCount(int* count, Error** error);
     virtual void SendKeys(const string16& keys, Error** error);
     virtual void Close(Error** error);
     virtual void SwitchTo(Error** error);
@@ -65,6 +68,7 @@ public:
     virtual void AcceptOrDismissAlert(bool accept, Error** error);
     virtual void SetOrientation(const std::string &orientation, Error **error);
     virtual void GetOrientation(std::string *orientation, Error **error);
+    virtual void PlayInputTimeline(const InputTimeline& timeline, Error** error);
 
 protected:
     QWidget* getView(const ViewId& viewId, Error** error);
@@ -78,6 +82,11 @@ protected:
 #endif
 
     void saveScreenshot(QPixmap& pixmap, std::string* png, Error** error);
+    /// synthesizes single event of input timeline
+    void DispatchInputAction(const InputAction& action, Error** error);
+
+    // widget that got TouchBegin, receives rest of touch sequence
+    QPointer<QWidget> touch_receiver_;
 
 private:
     DISALLOW_COPY_AND_ASSIGN(QViewCmdExecutor);
@@ -21,13 +21,17 @@
 #define NETWORK_ACCESS_MANAGER_H
 
 #include <string>
+#include <QtCore/QSet>
 #include <QtNetwork/QNetworkAccessManager>
 
+#include "webdriver_logging.h"
+
 namespace webdriver {
 class Session;
 }
 
-/// Auxiliary class for performance logging support.<br>
+/// Auxiliary class for performance logging, networkRules capability and
+/// networkIdle page load strategy support.<br>
 /// Limitation: It is currently not supported to change the network access manager after the QWebPage has used it.
 class QNetworkAccessManagerTracer: public QNetworkAccessManager {
     Q_OBJECT
@@ -39,8 +43,19 @@ public:
 
     virtual ~QNetworkAccessManagerTracer();
 
+    /// @return number of created requests which are not finished yet.
+    int requestsInFlight() const;
+
+signals:
+    /// Emitted when new request is created.
+    void requestStarted();
+    /// Emitted when last request in flight finishes.
+    void networkIdle();
+
 protected:
     /// Overrided, additional write a JSON entry for every received reply.
+    /// Requests matching session's networkRules capability are either
+    /// failed immediately with ContentAccessDenied or sent to rewritten URL.
     virtual QNetworkReply* createRequest(Operation op, const QNetworkRequest& req, QIODevice* outgoingData = 0);
 
 protected slots:
@@ -58,17 +73,31 @@ protected slots:
     ///         },
     ///         "tid": "thread_id",
     ///         "ts": "timestamp",
-    ///         "tts": "thread-specific_CPU-time"
+    ///         "tts": "thread-specific_CPU-time",
+    ///         "blocked": "total_blocked_requests",
+    ///         "rewritten": "total_rewritten_requests"
     ///     }
     /// }
     /// @endcode
     /// @param reply pointer to reply, that contains the data which will be written to PerfLog.
     void writeReply(QNetworkReply* reply);
 
+private slots:
+    void replyFinished();
+    void replyDestroyed(QObject* reply);
+
 private:
     std::string getMethod(Operation op);
+    void removeReplyInFlight(QObject* reply);
+    void addLogEntry(webdriver::LogLevel level,
+                     const std::string& method,
+                     const std::string& status,
+                     const std::string& path);
     webdriver::Session* session_;
     double timeStamp_;
+    QSet<QObject*> replies_in_flight_;
+    int blocked_count_;
+    int rewritten_count_;
 };
 
 #endif //NETWORK_ACCESS_MANAGER_H
@@ -27,6 +27,8 @@
 #include <QtQuick/QQuickView>
 #include <QtQuick/QQuickItem>
 #include <QtQuick/QQuickWindow>
+#include <QtQml/QJSValue>
+#include <QtQml/QQmlEngine>
 
 namespace webdriver {
 
@@ -91,9 +93,11 @@ public:
     virtual void NavigateToURL(const std::string& url, bool sync, Error** error);
     virtual void GetURL(std::string* url, Error** error);
     virtual void GetScreenShot(std::string* png, Error** error);
+    virtual void GetScreenShotImage(ScreenshotFormat format, std::string* data, Error** error);
+    virtual void GetRepaintCount(int* count, Error** error);
     virtual void GetElementScreenShot(const ElementId& element, std::string* png, Error** error);
     virtual void ExecuteScript(const std::string& script, const base::ListValue* const args, base::Value** value, Error** error);
-    virtual void ExecuteAsyncScript(const std::string& script, const base::ListValue* const args, base::Value** value, Error** error) NOT_SUPPORTED_IMPL;
+    virtual void ExecuteAsyncScript(const std::string& script, const base::ListValue* const args, AsyncScriptResult* result, Error** error) NOT_SUPPORTED_IMPL;
     virtual void GetAppCacheStatus(int* status, Error** error) NOT_SUPPORTED_IMPL;
     virtual void GetCookies(const std::string& url, base::ListValue** cookies, Error** error) NOT_SUPPORTED_IMPL;
     virtual void SetCookie(const std::string& url, base::DictionaryValue* cookie_dict, Error** error) NOT_SUPPORTED_IMPL;
@@ -136,6 +140,7 @@ public:
 
     virtual void SetOnline(bool, Error** error) NOT_SUPPORTED_IMPL;
     virtual void IsOnline(bool*, Error** error) NOT_SUPPORTED_IMPL;
+    virtual void PlayInputTimeline(const InputTimeline& timeline, Error** error);
 
 protected:
     QQuickWindow* getView(const ViewId& viewId, Error** error);
@@ -147,6 +152,12 @@ protected:
     void FindElementsByXpath(QQuickItem* parent, const std::string &query, std::vector<ElementId>* elements, Error **error);
     void FindElements(QQuickItem* parent, const std::string& locator, const std::string& query, std::vector<ElementId>* elements, Error** error);
     void moveMouseInternal(QQuickWindow* view, QPointF& point);
+    /// synthesizes single event of input timeline
+    void DispatchInputAction(const InputAction& action, Error** error);
+    // evaluates script without function cache, result is limited to primitives
+    void ExecuteScriptAsExpression(QQuickWindow* view, const std::string& script, const base::ListValue* const args, base::Value** value, Error** error);
+    QJSValue ConvertValueToJS(QQmlEngine* engine, const base::Value* arg, int depth, Error** error);
+    base::Value* ConvertJSToValue(const QJSValue& result, int depth, Error** error);
     
 private:
     DISALLOW_COPY_AND_ASSIGN(Quick2ViewCmdExecutor);
@@ -39,6 +39,10 @@ public:
     /// @param consumed - flag whether event was consumed by previous dispatchers
     /// @return true, if event was consumed, else false
     virtual bool dispatch(QEvent *event, bool consumed);
+    /// Starts collecting uinput events
+    virtual void beginBatch();
+    /// Writes collected uinput events
+    virtual void endBatch();
 
 private:
     UInputManager* _eventManager;
@@ -20,7 +20,10 @@
 /*! \file uinput_manager.h
     \page UInput manager
   UInput manager - WebDriver module, which allows sending events to Linux OS.
-  UInput manager register new device as /dev/uinput and transmit events through it.
+  UInput manager register new devices as /dev/uinput and transmit events through them:
+  key device for key events and absolute pointer device for mouse and touch events.
+  Events of one dispatch (or batch, see beginBatch()) are collected and terminated
+  with EV_SYN, then written with single write() call, see writeBatch().
 
   Currently supported keys for Remote Control:
     0xE000U   POWER
@@ -58,7 +61,15 @@
 
 #ifdef OS_LINUX
 
+#include <vector>
+
+#include <linux/input.h>
+
+#include <QtCore/QMap>
+#include <QtCore/QRect>
 #include <QtGui/QKeyEvent>
+#include <QtGui/QMouseEvent>
+#include <QtGui/QTouchEvent>
 
 #include "webdriver_logging.h"
 
@@ -83,8 +94,9 @@ public:
     ~UInputManager();
 
     /**
-      Register user input devices in OS
-      @return true, if device registered successfully, else - false
+      Register user input devices in OS. Pointer device covers primary
+      screen, failure to create it doesn't fail key device.
+      @return true, if key device registered successfully, else - false
      */
     bool registerUinputDevice();
 
@@ -95,21 +107,75 @@ public:
      */
     int injectKeyEvent(QKeyEvent *event);
 
+    /**
+      Send mouse event to pointer device, global position of event is used
+      @param event - pointer to event data
+      @return true, if event was sent, false if event or device is not supported
+     */
+    bool injectMouseEvent(QMouseEvent *event);
+
+    /**
+      Send touch event to pointer device as multitouch slots,
+      screen positions of touch points are used
+      @param event - pointer to event data
+      @return true, if event was sent, false if device is not ready
+     */
+    bool injectTouchEvent(QTouchEvent *event);
+
+    /**
+      Starts batch, following events are collected
+      and written together by @sa endBatch. Batches can be nested.
+     */
+    void beginBatch();
+
+    /**
+      Finishes batch, writes collected events
+     */
+    void endBatch();
+
     /**
       Check wether uinput device initialized
       @return true, if device initialized, false if not
      */
     bool isReady();
 
+    /**
+      Check wether pointer device initialized
+      @return true, if device initialized, false if not
+     */
+    bool isPointerReady();
+
+    /**
+      Writes events to descriptor with single write() call
+      @param descriptor - uinput device or any other file descriptor
+      @param events - events to write
+      @return number of written events, less than events.size() on error
+     */
+    static size_t writeBatch(int descriptor, const std::vector<struct input_event> &events);
+
 private:
     UInputManager();
     void registerHandledKeys();
-    int injectSynEvent();
+    bool registerPointerDevice(const QRect &screen);
+    int freeTouchSlot() const;
+    void queueEvent(std::vector<struct input_event> &queue, int type, int code, int value);
+    void queuePosition(int codeX, int codeY, const QPoint &globalPos);
+    void flushEvents();
+    int writeEvents(int descriptor, std::vector<struct input_event> &events);
 
 private:
     int _deviceDescriptor;
+    int _pointerDescriptor;
     Logger *_logger;
     bool _isReady;
+    bool _isPointerReady;
+    int _batchDepth;
+    QRect _screen;
+    // touch point id -> multitouch slot
+    QMap<int, int> _touchSlots;
+    int _nextTrackingId;
+    std::vector<struct input_event> _keyEvents;
+    std::vector<struct input_event> _pointerEvents;
 
     static UInputManager* _instance;
 };
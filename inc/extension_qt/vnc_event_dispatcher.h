@@ -38,6 +38,10 @@ public:
     /// @param consumed - flag, whether event was consumed by previous dispatchers
     /// @return if event consumed - return true, else false
     bool dispatch(QEvent *event, bool consumed);
+    /// Starts collecting VNC messages
+    void beginBatch();
+    /// Sends collected VNC messages
+    void endBatch();
 
 private:
     bool isRemoteControlEvent(QEvent *event);
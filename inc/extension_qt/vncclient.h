@@ -22,8 +22,9 @@
   vncclient - WebDriver module, which allows connect to VNC server.
   It works via RFB protocol (http://www.realvnc.com/docs/rfbproto.pdf)
   and allow to do coonection, authentication and
-  send key and mouse events. It is allowed to create only
-  one client instance.
+  send key and mouse events. It also can keep copy of remote
+  framebuffer, that is used as screenshot source.
+  It is allowed to create only one client instance.
 */
 
 #ifndef VNCCLIENT_H
@@ -31,11 +32,14 @@
 
 #include <QtNetwork/QTcpSocket>
 #include <QtGui/QKeyEvent>
+#include <QtGui/QImage>
 #include <QtCore/QMap>
 
 #include "vncserverparameters.h"
 #include "webdriver_logging.h"
 
+class RfbFramebuffer;
+
 /**
   VNCClient - class provides main functionality of VNC client.
 */
@@ -90,17 +94,47 @@ public:
     void sendKeyEvent(QKeyEvent *key);
 
     /**
-      Sends Qt mouse event to VNC server
+      Sends Qt mouse event (press, release, double click or move) to VNC server
       @param mouse - pointer to QMouseEvent instance
     */
     void sendMouseEvent(QMouseEvent *mouse);
 
+    /**
+      Starts batch, following key and mouse messages are collected
+      and sent together by @sa endBatch. Batches can be nested.
+    */
+    void beginBatch();
+
+    /**
+      Finishes batch, sends collected messages with single write
+    */
+    void endBatch();
+
     /**
       Indicates whether VNC client is initialized
       @return true, if client initialized, else false
     */
     bool isReady();
 
+    /**
+      Returns copy of remote framebuffer. On first call client sets up
+      pixel format and encodings and requests full update, afterwards
+      framebuffer is kept current with incremental updates, so only
+      damaged rectangles are transferred and decoded. Every grab asks
+      for fresh damage and waits shortly for it.
+      @param rect - area to copy, null rect means whole framebuffer
+      @param [out] image - framebuffer content
+      @param timeoutMs - how long to wait for first update
+      @return true if image is filled, else false
+    */
+    bool grabFramebuffer(const QRect &rect, QImage *image, int timeoutMs);
+
+signals:
+    /**
+      Emitted when FramebufferUpdate message is completely decoded
+    */
+    void framebufferUpdated();
+
 public slots:
 
     /**
@@ -130,6 +164,13 @@ private:
     bool finishHandshaking(QByteArray& data);
     bool initServerParameters(QByteArray& data);
     void sendDoubleClick(QMouseEvent *event);
+    void queueMessage(const char *msg, int size);
+    void flushMessages();
+    void traceBytes(const std::string& prefix, const QByteArray& data);
+    void startFramebufferUpdates();
+    void waitForFramebufferUpdate(int timeoutMs);
+    void requestFramebufferUpdate(bool incremental);
+    void processFramebufferData(const QByteArray& data);
 
     void handleZeroError(QByteArray& data);
     quint16 convertQtKeyToX11Key(QKeyEvent *key);
@@ -184,6 +225,13 @@ private:
     Encodings _establishedSecurity;
     ServerParameters* _serverParameters;
     webdriver::StdOutLog *_logger;
+    QByteArray _outgoing;
+    int _batchDepth;
+    RfbFramebuffer *_framebuffer;
+    QByteArray _inBuffer;
+    bool _framebufferRequested;
+    bool _framebufferFailed;
+    int _framebufferUpdates;
 
     QString *_password;
 };
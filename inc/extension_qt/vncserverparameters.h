@@ -70,7 +70,7 @@ public:
       @param pixelFormat - pointer to struct with pixel format information
       @param desktopName - pointer to string with remote desktop name
      */
-    ServerParameters(qint16 width, qint16 height, PIXEL_FORMAT* pixelFormat, QString* desktopName);
+    ServerParameters(quint16 width, quint16 height, PIXEL_FORMAT* pixelFormat, QString* desktopName);
 
     /**
       Destructor
@@ -81,13 +81,13 @@ public:
       Width parameter setter
       @param width - display horizontal resolution
      */
-    void setWidth(qint16 width);
+    void setWidth(quint16 width);
 
     /**
       Height parameter setter
       @param height - display vertical resolution
      */
-    void setHeight(qint16 height);
+    void setHeight(quint16 height);
 
     /**
       Pixel format setter
@@ -105,13 +105,13 @@ public:
       Display resolution width getter
       @return horizontal display resolution
      */
-    qint16 getWidth() const;
+    quint16 getWidth() const;
 
     /**
       Display resolution height getter
       @return vertical display resolution
      */
-    qint16 getHeight() const;
+    quint16 getHeight() const;
 
     /**
       Display resolution height getter
@@ -127,8 +127,8 @@ public:
 
 private:
 
-    qint16 _width;
-    qint16 _height;
+    quint16 _width;
+    quint16 _height;
     PIXEL_FORMAT* _pixelsFormat;
     QString *_name;
 };
@@ -47,10 +47,26 @@ public:
     /// @param event - event for dispatching
     /// @return true if event was consumed, else false
     bool dispatch(QEvent *event);
+    /// Notify dispatchers that group of events follows
+    void beginBatch();
+    /// Notify dispatchers that group of events is finished
+    void endBatch();
 
 private:
     static WDEventDispatcher *_instance;
     QVector<EventDispatcher*> _dispatchers;
 };
 
+/// Scoped helper, events dispatched during its lifetime are delivered
+/// by batching dispatchers (e.g. VNC) at once on destruction.
+class WDEventDispatchBatch
+{
+public:
+    WDEventDispatchBatch() { WDEventDispatcher::getInstance()->beginBatch(); }
+    ~WDEventDispatchBatch() { WDEventDispatcher::getInstance()->endBatch(); }
+
+private:
+    Q_DISABLE_COPY(WDEventDispatchBatch)
+};
+
 #endif // WDEVENTDISPATCHER_H
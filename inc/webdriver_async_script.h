@@ -0,0 +1,78 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef WEBDRIVER_ASYNC_SCRIPT_H_
+#define WEBDRIVER_ASYNC_SCRIPT_H_
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/time.h"
+
+namespace base {
+class Value;
+}
+
+namespace webdriver {
+
+class Error;
+
+/// Result of asynchronous script. View executor starts script on view thread
+/// and returns at once, script callback (or executor's watchdog) completes
+/// result later. Command waits for completion on its own thread, so view
+/// thread keeps processing events and several scripts can be in flight.
+class AsyncScriptResult : public base::RefCountedThreadSafe<AsyncScriptResult> {
+public:
+    AsyncScriptResult();
+
+    /// Completes script with |value| or |error|, takes ownership of both.
+    /// Only first completion is kept, later ones (e.g. callback that comes
+    /// after timeout) are dropped.
+    /// @return true if this call completed result
+    bool Complete(base::Value* value, Error* error);
+
+    /// Waits for completion.
+    /// @return false if |timeout| expired first
+    bool TimedWait(const base::TimeDelta& timeout);
+
+    bool IsCompleted() const;
+
+    /// Transfers result to caller, only valid after completion.
+    /// @param value receives script value, NULL on error
+    /// @return script error, NULL on success
+    Error* TakeResult(base::Value** value);
+
+private:
+    friend class base::RefCountedThreadSafe<AsyncScriptResult>;
+    ~AsyncScriptResult();
+
+    mutable base::Lock lock_;
+    base::WaitableEvent completed_event_;
+    bool completed_;
+    scoped_ptr<base::Value> value_;
+    scoped_ptr<Error> error_;
+
+    DISALLOW_COPY_AND_ASSIGN(AsyncScriptResult);
+};
+
+}  // namespace webdriver
+
+#endif  // WEBDRIVER_ASYNC_SCRIPT_H_
@@ -33,6 +33,14 @@ enum PlayerState{
     Paused = 2
 };
 
+///@enum ScreenshotFormat encodings of screenshot returned without base64
+enum ScreenshotFormat {
+    kPngScreenshot = 0,
+    /// "RGBA" magic, width and height as 32-bit big-endian integers,
+    /// followed by rows of 8-bit R,G,B,A pixels
+    kRgbaScreenshot = 1
+};
+
 class Point {
 public:
     Point();
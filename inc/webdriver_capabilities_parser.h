@@ -14,6 +14,21 @@ There are two capabilities which define strategy what view will be current after
 - "reuseUI" - HWD checks this caps, if it is not specified,
 in case of attempt to create second session we get exception of "one session only",<br/>
 otherwise prev session will be terminated without closing windows and new session can reuse those windows
+- "bulkTextInput" - if true, sendKeys commits runs of plain text (no special keys, no modifiers held)
+with single QInputMethodEvent to editors that accept input methods, instead of key events per character
+- "pageLoadStrategy" - when navigation commands return: "none" - right after navigation is started,
+"eager" - once DOM of main frame is ready (DOMContentLoaded), "normal" (default) - once page is fully loaded,
+"networkIdle" - once DOM is ready and page has no network requests in flight for a while.
+Navigation which does not complete within page load timeout fails with timeout error.
+- "networkRules" - requests of web views to block or redirect, as a dictionary:
+{"block": [patterns], "allow": [patterns], "rewrite": {"url_prefix": "replacement_prefix"}}.
+Pattern is URL prefix or host suffix like "*.example.com". Blocked requests (unless matched by "allow")
+get empty failed reply without touching network, rewrites can point e.g. CDN to "file:///" mirror.
+- "screenshotSource" - where screenshots are taken from: "view" (default) - rendered by Qt,
+"vnc" - framebuffer of VNC server the driver is connected to (see "vnc-login" switch), useful when
+application renders to hardware planes invisible for Qt.
+- "reuseScreenshots" - if true, screenshot of view which was not repainted since previous one
+is returned from cache instead of grabbing view again (false by default).
 
 For browserClass customizer can define some generic classes. In example in default 
 QT extension there is handling of "WidgetView" and "WebView" values for this capability.
@@ -34,6 +49,7 @@ Both options can be passed in desired and required capabilities.
 #include "base/file_path.h"
 #include "base/memory/scoped_ptr.h"
 #include "webdriver_logging.h"
+#include "webdriver_network_rules.h"
 
 namespace base {
 class DictionaryValue;
@@ -44,6 +60,26 @@ namespace webdriver {
 
 class Error;
 
+/// Defines when navigation commands return, see Capabilities::kPageLoadStrategy.
+enum PageLoadStrategy {
+    kNonePageLoad = 0,
+    kEagerPageLoad,
+    kNormalPageLoad,
+    kNetworkIdlePageLoad
+};
+
+/// Returns capability value for |strategy|, e.g. "eager".
+const char* PageLoadStrategyToString(PageLoadStrategy strategy);
+
+/// Defines where screenshots are taken from, see Capabilities::kScreenshotSource.
+enum ScreenshotSource {
+    kViewScreenshotSource = 0,
+    kVncScreenshotSource
+};
+
+/// Returns capability value for |source|, e.g. "vnc".
+const char* ScreenshotSourceToString(ScreenshotSource source);
+
 /// Contains all the capabilities that a user may request when starting a
 /// new session.
 struct Capabilities {
@@ -79,6 +115,20 @@ struct Capabilities {
     static const char kMaximize[];
 
     static const char kReuseUI[];
+    /// type plain text with single input method event instead of key events
+    static const char kBulkTextInput[];
+
+    /// when navigation commands return: "none", "eager", "normal" or "networkIdle"
+    static const char kPageLoadStrategy[];
+
+    /// requests blocking and URL rewriting rules, see NetworkRules
+    static const char kNetworkRules[];
+
+    /// where screenshots are taken from: "view" or "vnc"
+    static const char kScreenshotSource[];
+
+    /// return cached screenshot while view is not repainted
+    static const char kReuseScreenshots[];
 
     Capabilities();
     ~Capabilities();
@@ -89,6 +139,21 @@ struct Capabilities {
     /// Whether Chrome should not block when loading.
     bool load_async;
 
+    /// Whether sendKeys may commit plain text at once, see kBulkTextInput.
+    bool bulk_text_input;
+
+    /// When navigation commands return, see kPageLoadStrategy.
+    PageLoadStrategy page_load_strategy;
+
+    /// Blocking and rewriting rules for web view requests.
+    NetworkRules network_rules;
+
+    /// Where screenshots are taken from, see kScreenshotSource.
+    ScreenshotSource screenshot_source;
+
+    /// Whether unchanged view may return cached screenshot, see kReuseScreenshots.
+    bool reuse_screenshots;
+
     /// The minimum level to log for each log type.
     LogLevel log_levels[LogType::kNum];
 
@@ -125,6 +190,11 @@ public:
 
 private:
     Error* ParseLoadAsync(const base::Value* option);
+    Error* ParseBulkTextInput(const base::Value* option);
+    Error* ParsePageLoadStrategy(const base::Value* option);
+    Error* ParseNetworkRules(const base::Value* option);
+    Error* ParseScreenshotSource(const base::Value* option);
+    Error* ParseReuseScreenshots(const base::Value* option);
     Error* ParseLoggingPrefs(const base::Value* option);
     Error* ParseBrowserStartWindow(const base::Value* option);
     Error* ParseBrowserClass(const base::Value* option);
@@ -0,0 +1,179 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef WEBDRIVER_INPUT_ACTIONS_H_
+#define WEBDRIVER_INPUT_ACTIONS_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/string16.h"
+#include "webdriver_basic_types.h"
+
+namespace base {
+class DictionaryValue;
+class ListValue;
+}
+
+namespace webdriver {
+
+class Error;
+class ViewCmdExecutor;
+
+/// @enum PointerType type of W3C pointer input source
+enum PointerType {
+    kMousePointer = 0,
+    kPenPointer = 1,
+    kTouchPointer = 2
+};
+
+/// Single contact of synthesized touch event.
+struct InputTouchPoint {
+    enum State {
+        kPressed = 0,
+        kMoved,
+        kStationary,
+        kReleased
+    };
+
+    InputTouchPoint(int id, State state, const Point& position);
+
+    int id;
+    State state;
+    Point position;
+};
+
+/// Input event to be synthesized at |time| ms after timeline start.
+/// All positions are in view coordinates.
+struct InputAction {
+    enum Type {
+        kKeyDown = 0,
+        kKeyUp,
+        kPointerDown,
+        kPointerUp,
+        kPointerMove,
+        // touch sources are coalesced, so one event carries all contacts
+        kTouch
+    };
+
+    InputAction();
+
+    Type type;
+    int time;
+    /// key for kKeyDown/kKeyUp
+    string16 key;
+    /// changed button for kPointerDown/kPointerUp
+    MouseButton button;
+    /// buttons held after event, bit (1 << MouseButton) per button
+    int buttons;
+    /// pointer position for kPointerDown/kPointerUp/kPointerMove
+    Point position;
+    /// all active contacts for kTouch
+    std::vector<InputTouchPoint> touch_points;
+};
+
+typedef std::vector<InputAction> InputTimeline;
+
+/// State of input sources kept by session between action requests, so
+/// keys and buttons can be held across commands and released later.
+/// Copyable, builders work on a copy until timeline is performed.
+class InputState {
+public:
+    InputState();
+    ~InputState();
+
+private:
+    friend class InputTimelineBuilder;
+
+    struct Source {
+        Source();
+
+        std::string type;
+        PointerType pointer_type;
+        Point position;
+        int buttons;
+        bool touching;
+        int touch_id;
+        std::set<string16> pressed_keys;
+    };
+
+    typedef std::map<std::string, Source> SourcesMap;
+    SourcesMap sources_;
+    int next_touch_id_;
+};
+
+/// Translates W3C action sequences into time ordered list of input events.
+/// Ticks are executed one after another, tick lasts as long as its longest
+/// pause or pointer move; pointer moves are interpolated over its duration.
+class InputTimelineBuilder {
+public:
+    /// @param executor used to resolve element origins of pointer moves
+    /// @param state input state of session, builder works on its copy
+    /// @param mouse_position mouse position of session
+    InputTimelineBuilder(ViewCmdExecutor* executor, const InputState& state,
+                         const Point& mouse_position);
+    ~InputTimelineBuilder();
+
+    /// Builds timeline for "actions" parameter of POST /session/:id/actions.
+    /// Builder's copy of input state is updated as if timeline was already
+    /// performed, session keeps its state until caller stores state().
+    bool Build(const base::ListValue* actions, InputTimeline* timeline, Error** error);
+
+    /// Builds timeline that releases all keys, buttons and touches held
+    /// by session input sources.
+    void BuildRelease(InputTimeline* timeline);
+
+    /// Input state after built timeline, to be stored into session
+    /// only when timeline was performed successfully.
+    const InputState& state() const { return state_; }
+
+    /// Mouse position after built timeline.
+    const Point& mouse_position() const { return mouse_position_; }
+
+    /// Interval between interpolated pointer moves, in ms.
+    static const int kPointerMoveInterval;
+
+private:
+    struct RawEvent;
+    typedef std::map<std::string, InputTouchPoint::State> TouchedMap;
+
+    bool ParseKeyAction(const std::string& source_id, const base::DictionaryValue* action,
+                        const std::string& subtype, int time, Error** error);
+    bool ParsePointerAction(const std::string& source_id, const base::DictionaryValue* action,
+                            const std::string& subtype, int time, int* duration, Error** error);
+    bool GetMoveTarget(const std::string& source_id, const base::DictionaryValue* action,
+                       Point* target, Error** error);
+    void AddRawEvent(const std::string& source_id, InputAction::Type type, int time);
+    void ComposeTimeline(InputTimeline* timeline);
+    void FlushTouch(int time, TouchedMap* touched, InputTimeline* timeline);
+
+    ViewCmdExecutor* executor_;
+    InputState state_;
+    Point mouse_position_;
+    std::vector<RawEvent> raw_events_;
+
+    DISALLOW_COPY_AND_ASSIGN(InputTimelineBuilder);
+};
+
+}  // namespace webdriver
+
+#endif  // WEBDRIVER_INPUT_ACTIONS_H_
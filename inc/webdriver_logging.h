@@ -137,6 +137,8 @@ public:
 
     void set_min_log_level(LogLevel level);
 
+    LogLevel min_log_level() const;
+
 private:
     static StdOutLog* singleton_;
 
@@ -156,6 +158,10 @@ public:
     const base::ListValue* entries_list() const;
     void clear_entries_list();
 
+    /// Moves collected entries out of the log, leaving it empty.
+    /// @return new list owned by caller
+    base::ListValue* TakeEntries();
+
 private:
     base::ListValue entries_list_;
     base::Lock entries_lock_;
@@ -210,6 +216,10 @@ public:
     void Log(LogLevel level, const std::string& message) const;
     void AddHandler(LogHandler* log_handler);
 
+    /// Returns true if message of |level| would be logged, so callers can
+    /// skip building expensive messages.
+    bool IsLoggable(LogLevel level) const;
+
     void set_min_log_level(LogLevel level);
 
 private:
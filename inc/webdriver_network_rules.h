@@ -0,0 +1,122 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef WEBDRIVER_NETWORK_RULES_H_
+#define WEBDRIVER_NETWORK_RULES_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/basictypes.h"
+
+namespace base {
+class Value;
+}
+
+namespace webdriver {
+
+class Error;
+
+/// Byte trie mapping string keys to values, answers longest prefix queries
+/// in time linear in the query length regardless of number of keys.
+class PrefixTrie {
+public:
+    PrefixTrie();
+    ~PrefixTrie();
+
+    /// Adds |key| with |value|, replacing value of same key.
+    void Insert(const std::string& key, int value);
+
+    /// Finds longest key which is prefix of |text|.
+    /// @param length if not NULL, receives length of found key
+    /// @return value of found key, -1 if none matches
+    int FindLongestPrefix(const std::string& text, size_t* length) const;
+
+    bool empty() const { return nodes_.size() == 1; }
+
+private:
+    struct Node {
+        Node() : value(-1) {}
+        // Sorted by byte, nodes have few children.
+        std::vector<std::pair<unsigned char, int> > children;
+        int value;
+    };
+
+    int FindChild(int node, unsigned char c) const;
+
+    std::vector<Node> nodes_;
+};
+
+/// Request blocking and URL rewriting rules of session, see
+/// Capabilities::kNetworkRules.<br>
+/// Pattern is either URL prefix, e.g. "https://cdn.example.com/fonts/", or
+/// host suffix starting with "*.", e.g. "*.doubleclick.net", which matches
+/// the host itself and all its subdomains.
+class NetworkRules {
+public:
+    enum Action {
+        kAllowRequest = 0,
+        kBlockRequest,
+        kRewriteRequest
+    };
+
+    NetworkRules();
+    ~NetworkRules();
+
+    /// Parses capability value:
+    /// {"block": [patterns], "allow": [patterns], "rewrite": {prefix: replacement}}
+    /// @return NULL if ok, Error otherwise
+    Error* Parse(const base::Value* value);
+
+    void AddBlockPattern(const std::string& pattern);
+    /// Allow patterns exempt requests from blocking, not from rewriting.
+    void AddAllowPattern(const std::string& pattern);
+    /// Requests with URL starting with |prefix| are sent to
+    /// |replacement| + rest of URL, e.g. to local "file:///" mirror.
+    void AddRewrite(const std::string& prefix, const std::string& replacement);
+
+    bool empty() const;
+
+    /// Decides what to do with request for |url| with host |host|.
+    /// @param rewritten_url receives new URL for kRewriteRequest
+    Action Match(const std::string& url,
+                 const std::string& host,
+                 std::string* rewritten_url) const;
+
+private:
+    // URL prefix and reversed host suffix tries of one pattern list.
+    struct PatternSet {
+        PrefixTrie url_prefixes;
+        PrefixTrie reversed_hosts;
+
+        void Add(const std::string& pattern);
+        bool Matches(const std::string& url, const std::string& reversed_host) const;
+        bool empty() const;
+    };
+
+    PatternSet blocked_;
+    PatternSet allowed_;
+    PrefixTrie rewrite_prefixes_;
+    std::vector<std::string> rewrite_replacements_;
+};
+
+}  // namespace webdriver
+
+#endif  // WEBDRIVER_NETWORK_RULES_H_
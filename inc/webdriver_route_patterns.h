@@ -95,6 +95,7 @@ public:
     static const char kTouchDoubleClick[];
     static const char kTouchLongClick[];
     static const char kTouchFlick[];
+    static const char kActions[];
     static const char kOrientation[];
     static const char kXdrpc[];
     static const char kCiscoPlayerState[];
@@ -104,6 +105,9 @@ public:
     static const char kCiscoPlayerPlayingSpeed[];
     static const char kVisualizerSource[];
     static const char kVisualizerShowPoint[];
+    static const char kCiscoScreenshot[];
+    static const char kCiscoScreenshotStream[];
+    static const char kCiscoSourceDiff[];
     static const char kTouchPinchZoom[];
     static const char kTouchPinchRotate[];
     static const char kShutdown[];
@@ -150,6 +150,7 @@
 
 #include "base/basictypes.h"
 #include "base/memory/ref_counted.h"
+#include "base/string_split.h"
 
 namespace base {
 class DictionaryValue;
@@ -164,8 +165,10 @@ class AbstractCommandCreator : public base::RefCounted<AbstractCommandCreator>
 {
 public:
     virtual ~AbstractCommandCreator() {}
+    /// @param parameters request parameters, command takes ownership. Commands
+    /// which move parts of parameters out accept them as non-const.
     virtual Command* create(const std::vector<std::string>& path_segments,
-                            const base::DictionaryValue* const parameters) const = 0;
+                            base::DictionaryValue* const parameters) const = 0;
 };
 
 typedef scoped_refptr<AbstractCommandCreator> CommandCreatorPtr;
@@ -176,7 +179,7 @@ class CommandCreator: public AbstractCommandCreator
 {
 public:
     virtual Command* create(const std::vector<std::string>& path_segments,
-                            const base::DictionaryValue* const parameters) const { return new C(path_segments, parameters); }
+                            base::DictionaryValue* const parameters) const { return new C(path_segments, parameters); }
 };
 
 namespace internal {
@@ -189,10 +192,13 @@ struct RouteDetails {
                  const webdriver::CommandCreatorPtr& creator)
         : uri_regex_(uri_regex),
           creator_(creator) {
+        base::SplitString(uri_regex_, '/', &segments_);
     }
 
     std::string uri_regex_;
     webdriver::CommandCreatorPtr creator_;
+    // pattern split once, matched against url segments
+    std::vector<std::string> segments_;
 };
 
 }  // namespace internal
@@ -239,6 +245,12 @@ public:
     /// @return pointer to CommandCreator, NULL if route not found
     CommandCreatorPtr GetRouteForURL(const std::string& url, std::string* pattern = NULL) const;
 
+    /// Same as above for url already split into path segments.
+    /// @param url_segments path segments of url to handle
+    /// @param[out] pattern optional output - matched pattern for url
+    /// @return pointer to CommandCreator, NULL if route not found
+    CommandCreatorPtr GetRouteForURL(const std::vector<std::string>& url_segments, std::string* pattern = NULL) const;
+
     /// Returns list of registered routes
     /// @return vector of registered patterns
     std::vector<std::string> GetRoutes();
@@ -256,7 +268,8 @@ private:
     // return true if pattern1 is bestmatch then pattern2
     bool CompareBestMatch(const std::string& uri_pattern1, const std::string& uri_pattern2);
 
-    bool MatchPattern(const std::string& url, const std::string& pattern) const;
+    bool MatchPattern(const std::vector<std::string>& url_segments,
+                      const std::vector<std::string>& pattern_segments) const;
 
     std::vector<webdriver::internal::RouteDetails> routes_;
 };
@@ -36,6 +36,7 @@ Some project-related topics:
 - \subpage page_url_post
 - \subpage page_hybrid_capabilities
 - \subpage page_whitelist
+- \subpage page_startup
 */
 
 //-----------------------------------------------------------
@@ -121,6 +122,11 @@ public:
     /// @return 0 - if success, error code otherwise.
     int SetRouteTable(RouteTable* routeTable);
 
+    /// Route table of this server for adding custom routes in place, without
+    /// copying the table. Server should be stopped.
+    /// @return pointer to route table, NULL if server is not idle.
+    RouteTable* GetMutableRouteTable();
+
     /// Start server 
     /// @return 0 - if success, error code otherwise.
     int Start();
@@ -153,6 +159,9 @@ private:
     std::string url_base_;
     struct mg_context* mg_ctx_;
     State state_;
+    size_t max_body_size_;
+    int compression_level_;
+    size_t compression_threshold_;
     AccessValidator accessValidor;
 
     void DispatchCommand(const std::string& matched_route,
@@ -165,8 +174,10 @@ private:
                               const struct mg_request_info* request_info);
 
     // Converts a |Response| into a |HttpResponse| to be returned to the client.
+    // Returns true if |command_response| itself should be streamed as body,
+    // false if |http_response| already carries its own (error) body.
     // This function is exposed for testing.
-    void PrepareHttpResponse(const std::string& request_method,
+    bool PrepareHttpResponse(const std::string& request_method,
                              const Response& command_response,
                              HttpResponse* const http_response);
 
@@ -180,9 +191,20 @@ private:
                       base::DictionaryValue** parameters,
                       Response* const response);
 
-    void ReadRequestBody(const struct mg_request_info* const request_info,
-                     struct mg_connection* const connection,
-                     std::string* request_body);
+    // Reads body of current request (plain or chunked). Fails if body exceeds
+    // |max_body_size_| or connection is dropped before body is complete.
+    bool ReadRequestBody(struct mg_connection* const connection,
+                     std::string* request_body,
+                     std::string* error_msg);
+
+    // Decodes request body sent with gzip/deflate Content-Encoding.
+    bool DecodeRequestBody(struct mg_connection* const connection,
+                     std::string* request_body,
+                     std::string* error_msg);
+
+    bool ReadChunkedRequestBody(struct mg_connection* const connection,
+                     std::string* request_body,
+                     std::string* error_msg);
 
     void SendNoContentResponse(struct mg_connection* connection,
                            const struct mg_request_info* request_info);
@@ -192,7 +214,14 @@ private:
                   const Response& response);
 
     void WriteHttpResponse(struct mg_connection* connection,
-                       const HttpResponse& response);
+                       HttpResponse* response);
+
+    // Writes headers of |http_response| and then serializes |response|
+    // as JSON directly to connection. Large bodies are sent with chunked
+    // transfer coding and compressed if client accepts it.
+    void WriteStreamedHttpResponse(struct mg_connection* connection,
+                       HttpResponse* http_response,
+                       const Response& response);
 
     static ListValue* ListCommandSupportedMethods(const Command& command);
 
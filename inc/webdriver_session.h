@@ -52,9 +52,11 @@ session's create or session's terminate.
 
 #include "base/callback_forward.h"
 #include "base/file_path.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/scoped_temp_dir.h"
 #include "base/string16.h"
+#include "base/synchronization/lock.h"
 #include "base/threading/thread.h"
 #include "base/values.h"
 #include "frame_path.h"
@@ -79,6 +81,9 @@ class Error;
 class ValueParser;
 class ViewRunner;
 class SessionLifeCycleActions;
+class SourceSnapshot;
+class InputState;
+class ViewCmdExecutor;
 
 /// Every connection made by WebDriver maps to a session object.
 /// This object creates the browser instance and keeps track of the
@@ -154,6 +159,9 @@ public:
 
     void set_sticky_modifiers(int mods) { sticky_modifiers_ = mods; }
 
+    /// State of W3C input sources used by actions commands.
+    InputState* input_state() { return input_state_.get(); }
+
     const DictionaryValue* get_desired_caps() const { return desired_caps_.get(); }
     const DictionaryValue* get_required_caps() const { return required_caps_.get(); }
 
@@ -185,6 +193,19 @@ public:
     /// @return valid viewId if found
     ViewId GetViewForHandle(ViewHandle* handle) const;
 
+    /// Get executor cached for view. Reference is taken under session lock,
+    /// so executor stays alive even if view is removed meanwhile.
+    /// @param viewId requested view
+    /// @return cached executor, NULL if there is no one or view handle is not valid anymore
+    scoped_refptr<ViewCmdExecutor> GetViewExecutor(const ViewId& viewId);
+
+    /// Cache executor for view. It is released when view is removed or its handle replaced.
+    /// @param viewId view executor operates on
+    /// @param executor executor to cache, session keeps a reference
+    /// @return cached executor, it is one cached by other thread if that was first;
+    /// NULL if view not found
+    scoped_refptr<ViewCmdExecutor> SetViewExecutor(const ViewId& viewId, ViewCmdExecutor* executor);
+
     /// Invalidate viewIdRemove it from map
     /// @param viewId requested view
     void RemoveView(const ViewId& viewId);
@@ -205,6 +226,12 @@ public:
     /// @return elementId
     ElementId GetElementIdForHandle(const ViewId& viewId, const ElementHandle* handle) const;
 
+    /// Get all element mappings of specific view, allows caller to build
+    /// its own index instead of GetElementIdForHandle() call per element
+    /// @param viewId requested view
+    /// @param elements returned pairs of elementId and handle, handles are owned by session
+    void GetElements(const ViewId& viewId, std::vector<std::pair<ElementId, ElementHandle*> >* elements) const;
+
     /// Add element mapping
     /// @param viewId target view
     /// @param handle pointer to element handle, no need to delete
@@ -212,6 +239,17 @@ public:
     /// @return true if ok
     bool AddElement(const ViewId& viewId, ElementHandle* handle, ElementId* elementId);
 
+    /// Compare source of view with one passed on previous call and fill
+    /// |result| with changed subtrees
+    /// @param viewId source owner
+    /// @param source current source of view
+    /// @param base_revision revision of source known to client, -1 if none
+    /// @param result returned revision, changes or full source
+    void UpdateSourceSnapshot(const ViewId& viewId,
+                              const std::string* source,
+                              int base_revision,
+                              base::DictionaryValue* result);
+
     /// Invalidate elementId in specific view. Remove it from map
     /// @param viewId requested view
     /// @param elementId element to invalidate
@@ -228,6 +266,7 @@ private:
     typedef std::map<std::string, ElementHandlePtr> ElementsMap;
     typedef std::map<std::string, ElementsMap> ViewsElementsMap;
     typedef std::map<std::string, ViewHandlePtr> ViewsMap;
+    typedef std::map<std::string, scoped_refptr<ViewCmdExecutor> > ExecutorsMap;
 
     bool InitActualCapabilities();
     bool CheckRequiredCapabilities(const base::DictionaryValue* capabilities_dict);
@@ -253,6 +292,13 @@ private:
     ViewsElementsMap elements_;
     // contains mapping viewId on viewHandle
     ViewsMap views_;
+    // for each viewId contains executor created for its current handle
+    ExecutorsMap executors_;
+    // guards executors_ and changes of views_, streaming commands look
+    // executors up from own threads
+    base::Lock executors_lock_;
+    // for each viewId contains last source used by incremental page source
+    std::map<std::string, SourceSnapshot*> source_snapshots_;
 
     base::Thread thread_;
 
@@ -280,6 +326,9 @@ private:
     // Current state of all modifier keys.
     int sticky_modifiers_;
 
+    // Keys, buttons and pointer positions held by input sources.
+    scoped_ptr<InputState> input_state_;
+
     DISALLOW_COPY_AND_ASSIGN(Session);
 };
 
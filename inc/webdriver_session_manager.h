@@ -6,9 +6,12 @@
 #define WEBDRIVER_WEBDRIVER_SESSION_MANAGER_H_
 
 #include <map>
+#include <set>
 #include <string>
 
+#include "base/callback.h"
 #include "base/memory/singleton.h"
+#include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
 
 namespace webdriver {
@@ -29,11 +32,18 @@ public:
     /// @param session pointer to Session object
     void Add(Session* session);
 
-    /// Remove session object referenced by sessionId
+    /// Remove session object referenced by sessionId. Waits for tasks
+    /// running with this session by RunWithSession().
     /// @param id sessionId to remove
     /// @return true - if succeed, false - if sessionId not found
     bool Remove(const std::string& id);
 
+    /// Marks session as terminating, RunWithSession() doesn't run new tasks
+    /// with it. Waits for tasks already running with this session, so must
+    /// not be called from such task.
+    /// @param id sessionId
+    void BeginTerminate(const std::string& id);
+
     /// Check if session exists
     /// @param id sessionId to check
     /// @return true - exists, false - not found
@@ -48,13 +58,32 @@ public:
     /// @return vector of pairs (sessionId, pointer to Session)
     std::map<std::string, Session*> GetSessions();
 
+    /// Runs |task| with session referenced by sessionId on caller thread.
+    /// Session can't be terminated or removed while task runs, so it is safe
+    /// to use it from thread other than one terminating session. Tasks with
+    /// different sessions don't wait for each other.
+    /// @param id sessionId
+    /// @param task callback receiving session
+    /// @return false if session not found, task is not run in this case
+    bool RunWithSession(const std::string& id,
+                        const base::Callback<void(Session*)>& task);
+
 private:
     SessionManager();
     ~SessionManager();
     friend struct DefaultSingletonTraits<SessionManager>;
 
+    // waits until no task runs with session, map_lock_ is held
+    void WaitForSessionUses(const std::string& id);
+
     std::map<std::string, Session*> map_;
     mutable base::Lock map_lock_;
+    // for each sessionId number of tasks running by RunWithSession()
+    std::map<std::string, int> uses_;
+    // sessions RunWithSession() doesn't run new tasks with
+    std::set<std::string> terminating_;
+    // signalled with map_lock_ when task finishes
+    base::ConditionVariable uses_released_;
 
     DISALLOW_COPY_AND_ASSIGN(SessionManager);
 };
@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+/*! \page page_startup Startup
+
+Driver startup can be split into phases which are measured by
+webdriver::StartupTimings and written to log once logging is configured.
+
+Support for view types (view creators, enumerators and executor creators)
+may be registered in webdriver::DeferredViewSupport instead of being set up
+before server start. Deferred initializers run once, in registration order,
+on view thread when first session is created.
+
+Example:
+\code
+webdriver::StartupTimings::GetInstance()->Begin();
+webdriver::DeferredViewSupport::GetInstance()->Add("widget", base::Bind(&InitWidgetViews));
+webdriver::StartupTimings::GetInstance()->Mark("view registration");
+wd_server->Start();
+webdriver::StartupTimings::GetInstance()->Mark("server start");
+webdriver::StartupTimings::GetInstance()->Report("driver startup");
+\endcode
+*/
+
+#ifndef WEBDRIVER_WEBDRIVER_STARTUP_H_
+#define WEBDRIVER_WEBDRIVER_STARTUP_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/memory/singleton.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/time.h"
+
+namespace webdriver {
+
+/// Collects durations of startup phases. Phases may be recorded before
+/// logging is configured, they are written to global log by Report().
+class StartupTimings {
+public:
+    /// Returns the singleton instance.
+    static StartupTimings* GetInstance();
+
+    /// Starts measuring, next Mark() measures phase from this point.
+    void Begin();
+
+    /// Records phase which lasted since previous Begin() or Mark().
+    /// @param phase name of phase
+    void Mark(const std::string& phase);
+
+    /// Records phase with explicitly measured duration.
+    /// @param phase name of phase
+    /// @param duration time spent in phase
+    void Add(const std::string& phase, const base::TimeDelta& duration);
+
+    /// Writes recorded phases and their total to global log and forgets them.
+    /// @param title name of measured sequence, e.g. "driver startup"
+    void Report(const std::string& title);
+
+private:
+    StartupTimings();
+    ~StartupTimings();
+    friend struct DefaultSingletonTraits<StartupTimings>;
+
+    typedef std::pair<std::string, base::TimeDelta> Phase;
+
+    std::vector<Phase> phases_;
+    base::TimeTicks last_mark_;
+    base::Lock lock_;
+
+    DISALLOW_COPY_AND_ASSIGN(StartupTimings);
+};
+
+/// Keeps initializers of view types support which are deferred until
+/// first session is created. Each initializer runs only once.
+class DeferredViewSupport {
+public:
+    /// Returns the singleton instance.
+    static DeferredViewSupport* GetInstance();
+
+    /// Adds initializer. Initializers run in order they were added.
+    /// @param name name of view type, used for reporting
+    /// @param initializer closure which registers view type support
+    void Add(const std::string& name, const base::Closure& initializer);
+
+    /// @return true if there are initializers which have not run yet or
+    /// still run
+    bool HasPending() const;
+
+    /// Runs pending initializers and reports their timings. Should be called
+    /// in view context (see webdriver::ViewRunner). If initializers are run
+    /// by other caller, waits until they are finished.
+    void RunPending();
+
+private:
+    DeferredViewSupport();
+    ~DeferredViewSupport();
+    friend struct DefaultSingletonTraits<DeferredViewSupport>;
+
+    typedef std::pair<std::string, base::Closure> Initializer;
+
+    std::vector<Initializer> pending_;
+    // true while RunPending() runs initializers taken from pending_
+    bool running_;
+    mutable base::Lock lock_;
+    // signalled with lock_ when initializers are finished
+    base::ConditionVariable finished_;
+
+    DISALLOW_COPY_AND_ASSIGN(DeferredViewSupport);
+};
+
+}  // namespace webdriver
+
+#endif  // WEBDRIVER_WEBDRIVER_STARTUP_H_
@@ -83,6 +83,20 @@ public:
     /// if parameter specified, user input device enabled
     static const char kUserInputDevice[];
 
+    /// \page page_webdriver_switches WD Server switches
+    /// - <b>views</b><br>
+    /// Comma separated list of view types to support: widget, web, qml.
+    /// Support for listed types is initialized when first session is
+    /// created (by default - all types available in build)
+    static const char kViews[];
+
+    /// \page page_webdriver_switches WD Server switches
+    /// - <b>visualizer-xslt</b><br>
+    /// If enabled, widget visualizer source is transformed to HTML by driver
+    /// (in process with libxslt if built with WD_CONFIG_XSLT, otherwise with
+    /// Saxon) instead of by client (false by default)
+    static const char kVisualizerXslt[];
+
     /// \page page_webdriver_switches WD Server switches
     /// - <b>white-list</b><br>
     /// The path to whitelist file (e.g. whitelist.xml) in
@@ -102,6 +116,54 @@ public:
 
     static const char kWebServerCfg[];
 
+    /// \page page_webdriver_switches WD Server switches
+    /// - <b>max-body-size</b><br>
+    /// Maximum size in bytes of HTTP request body that server accepts.
+    /// Requests with larger body are rejected without being read
+    /// (default - 67108864, i.e. 64MB)
+    static const char kMaxBodySize[];
+
+    /// \page page_webdriver_switches WD Server switches
+    /// - <b>request-timeout</b><br>
+    /// Timeout in milliseconds for receiving/sending data on HTTP connection.
+    /// If client stalls longer than this while sending request body,
+    /// request is dropped (by default - no timeout)
+    static const char kRequestTimeout[];
+
+    /// \page page_webdriver_switches WD Server switches
+    /// - <b>compression-level</b><br>
+    /// zlib compression level (1..9) for responses to clients which
+    /// announce gzip or deflate in Accept-Encoding header. Value 0 disables
+    /// response compression. Requires server built with WD_CONFIG_ZLIB
+    /// (default - 0)
+    static const char kCompressionLevel[];
+
+    /// \page page_webdriver_switches WD Server switches
+    /// - <b>compression-threshold</b><br>
+    /// Minimal size in bytes of response body to be compressed
+    /// (default - 8192)
+    static const char kCompressionThreshold[];
+
+    /// \page page_webdriver_switches WD Server switches
+    /// - <b>http-cache-dir</b><br>
+    /// The path to directory for on-disk HTTP cache shared by all web views
+    /// created in the process. Cache is kept between sessions and driver
+    /// restarts (by default - no cache)
+    static const char kHttpCacheDir[];
+
+    /// \page page_webdriver_switches WD Server switches
+    /// - <b>http-cache-size</b><br>
+    /// Maximum size in bytes of on-disk HTTP cache
+    /// (default - 52428800, i.e. 50MB)
+    static const char kHttpCacheSize[];
+
+    /// \page page_webdriver_switches WD Server switches
+    /// - <b>http-cache-offline</b><br>
+    /// If enabled, cached responses are served without revalidation even
+    /// when expired, only missing resources are loaded from network.
+    /// Useful for deterministic test runs (false by default)
+    static const char kHttpCacheOffline[];
+
 };
 
 }  // namespace webdriver
@@ -22,11 +22,14 @@ namespace webdriver {
 /// Generates a random, 32-character hexidecimal ID.
 std::string GenerateRandomID();
 
-/// Decodes the given base64-encoded string, after removing any newlines,
-/// which are required in some base64 standards.
+/// Decodes the given base64-encoded string, skipping any whitespace, e.g.
+/// newlines which are required in some base64 standards.
 /// Returns true on success.
 bool Base64Decode(const std::string& base64, std::string* bytes);
 
+/// Encodes |bytes| to padded base64, replacing content of |base64|.
+void Base64Encode(const std::string& bytes, std::string* base64);
+
 /// Returns the equivalent JSON string for the given value.
 std::string JsonStringify(const base::Value* value);
 
@@ -29,9 +29,11 @@ Exexcutor can be created only by webdriver::ViewCmdExecutorCreator which knows
 if it can create executor for passed view.
 All executor creators are registered in webdriver::ViewCmdExecutorFactory.
 This singleton is an entry point to get executor for view.
+Executors are reference counted. Executor created for view is cached in session
+and reused by following commands until view is removed or its handle replaced.
 \code
 Error* error = NULL;
-ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session, viewId));
+ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session, viewId));
 
 if (NULL == executor.get()) {
     // handle error
@@ -61,25 +63,29 @@ webdriver::ViewCmdExecutorFactory::GetInstance()->AddViewCmdExecutorCreator(new
 #include <map>
 
 #include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
 #include "base/string16.h"
 #include "webdriver_view_id.h"
 #include "webdriver_element_id.h"
 #include "webdriver_basic_types.h"
+#include "webdriver_input_actions.h"
 
 namespace base {
 class Value;    
+class ListValue;
 }
 
 namespace webdriver {
 
 class Session;
 class Error;
+class AsyncScriptResult;
 class Rect;
 class Point;
 class Size;
 
 /// base class for custom view's executors
-class ViewCmdExecutor{
+class ViewCmdExecutor : public base::RefCountedThreadSafe<ViewCmdExecutor> {
 public:
     explicit ViewCmdExecutor(Session* session, ViewId viewId);
     virtual ~ViewCmdExecutor();
@@ -95,6 +101,11 @@ public:
     virtual void Reload(Error** error) = 0;
     virtual void GetScreenShot(std::string* png, Error** error) = 0;
     virtual void GetElementScreenShot(const ElementId& element, std::string* png, Error** error) = 0;
+    /// Grabs view image encoded as |format|. Default implementation supports PNG only.
+    virtual void GetScreenShotImage(ScreenshotFormat format, std::string* data, Error** error);
+    /// Returns number of repaints of view seen so far, used to skip unchanged frames.
+    /// Views that can't track repaints report kCommandNotSupported.
+    virtual void GetRepaintCount(int* count, Error** error);
     virtual void GetSource(std::string* source, Error** error) = 0;
     virtual void SendKeys(const string16& keys, Error** error) = 0;
     virtual void SendKeys(const ElementId& element, const string16& keys, Error** error) = 0;
@@ -144,7 +155,10 @@ public:
     virtual void NavigateToURL(const std::string& url, bool sync, Error** error) = 0;
     virtual void GetURL(std::string* url, Error** error) = 0;
     virtual void ExecuteScript(const std::string& script, const base::ListValue* const args, base::Value** value, Error** error) = 0;
-    virtual void ExecuteAsyncScript(const std::string& script, const base::ListValue* const args, base::Value** value, Error** error) = 0;
+    /// Starts async script and returns without waiting for it, |result| is
+    /// completed by script callback or when session's async script timeout expires.
+    /// |error| is set only if script could not be started.
+    virtual void ExecuteAsyncScript(const std::string& script, const base::ListValue* const args, AsyncScriptResult* result, Error** error) = 0;
     virtual void GetAppCacheStatus(int* status, Error** error) = 0;
     virtual void GetAlertMessage(std::string* text, Error** error) = 0;
     virtual void SetAlertPromptText(const std::string& alert_prompt_text, Error** error) = 0;
@@ -195,6 +209,14 @@ public:
 	
 	virtual void TouchPinchZoom(const ElementId &element, const double &scale, Error **error) = 0;
     virtual void TouchPinchRotate(const ElementId &element, const int &angle, Error **error) = 0;
+    /// Performs W3C input source action sequences. Default implementation
+    /// builds timeline of input events and passes it to PlayInputTimeline().
+    virtual void PerformActions(const base::ListValue* actions, Error** error);
+    /// Releases keys, buttons and touches held by session input sources.
+    virtual void ReleaseActions(Error** error);
+    /// Synthesizes events of |timeline| at their timestamps.
+    /// Views that can't do it report kCommandNotSupported.
+    virtual void PlayInputTimeline(const InputTimeline& timeline, Error** error);
 
 protected:
     Session* session_;
@@ -204,6 +226,8 @@ private:
     DISALLOW_COPY_AND_ASSIGN(ViewCmdExecutor);
 };
 
+typedef scoped_refptr<ViewCmdExecutor> ExecutorPtr;
+
 /// base class for custom cmd executor creators
 class ViewCmdExecutorCreator {
 public:
@@ -244,6 +268,18 @@ public:
     /// @return new executor, NULL - if cant create.
     ViewCmdExecutor* CreateExecutor(Session* session, ViewId viewId) const;
 
+    /// returns executor cached in session for specified view, creates and
+    /// caches it on first request. Creators are asked only once per view.
+    /// @param session pointer to session
+    /// @param viewId view to operate on
+    /// @return executor, NULL - if cant create
+    ExecutorPtr GetExecutor(Session* session, const ViewId& viewId) const;
+
+    /// returns cached executor for current view in session
+    /// @param session pointer to session
+    /// @return executor, NULL - if cant create
+    ExecutorPtr GetExecutor(Session* session) const;
+
     template <class C>
     C* CreateExecutor(Session* session, ViewId viewId) const {
         return dynamic_cast<C>(CreateExecutor(session, viewId));
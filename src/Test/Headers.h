@@ -39,7 +39,10 @@
 #include <iostream>
 
 #include "base/at_exit.h"
+#include "base/bind.h"
+#include "base/string_split.h"
 #include "webdriver_server.h"
+#include "webdriver_startup.h"
 #include "webdriver_view_transitions.h"
 #include "versioninfo.h"
 #include "webdriver_route_table.h"
@@ -95,59 +98,83 @@
 #include "Samples.h"
 #endif
 
-int wd_setup(int argc, char *argv[])
+/* Declarative description of driver startup, read from command line or
+   config file (see --views, --vnc-login and --uinput switches). */
+struct WDStartupConfig
 {
-#if (QT_VERSION < QT_VERSION_CHECK(5, 0, 0))
-    QTextCodec::setCodecForCStrings(QTextCodec::codecForName("utf8"));
-#endif
-    webdriver::ViewRunner::RegisterCustomRunner<webdriver::QViewRunner>();
+    bool widgetViews;
+    bool webViews;
+    bool qmlViews;
+    bool vnc;
+    bool uinput;
+};
 
-    webdriver::SessionLifeCycleActions::RegisterCustomLifeCycleActions<webdriver::QSessionLifeCycleActions>();
+void wd_startup_config(const CommandLine &options, WDStartupConfig *config)
+{
+    config->widgetViews = true;
+    config->webViews = true;
+    config->qmlViews = true;
+    config->vnc = options.HasSwitch(webdriver::Switches::kVNCLogin);
+    config->uinput = options.HasSwitch(webdriver::Switches::kUserInputDevice);
 
-    webdriver::ViewTransitionManager::SetURLTransitionAction(new webdriver::URLTransitionAction_CloseOldView());
+    if (!options.HasSwitch(webdriver::Switches::kViews))
+        return;
+
+    config->widgetViews = false;
+    config->webViews = false;
+    config->qmlViews = false;
+
+    std::vector<std::string> views;
+    base::SplitString(options.GetSwitchValueASCII(webdriver::Switches::kViews), ',', &views);
+    for (size_t i = 0; i < views.size(); ++i) {
+        if (views[i] == "widget")
+            config->widgetViews = true;
+        else if (views[i] == "web")
+            config->webViews = true;
+        else if (views[i] == "qml")
+            config->qmlViews = true;
+        else if (!views[i].empty())
+            std::cout << "Unknown view type in --views: " << views[i] << std::endl;
+    }
+}
+
+/* View types support registered on first session, see webdriver::DeferredViewSupport */
+void wd_init_widget_views(webdriver::ViewCreator* widgetCreator)
+{
+    /* Add widget creator last so that it deos not conflict with webview creator (QWebView is a subclass of QWidget)*/
+    webdriver::ViewFactory::GetInstance()->AddViewCreator(widgetCreator);
+    webdriver::ViewEnumerator::AddViewEnumeratorImpl(new webdriver::WidgetViewEnumeratorImpl());
+    webdriver::ViewCmdExecutorFactory::GetInstance()->AddViewCmdExecutorCreator(new webdriver::QWidgetViewCmdExecutorCreator());
+}
 
-    /* Configure widget views */
-    webdriver::ViewCreator* widgetCreator = new webdriver::QWidgetViewCreator();
-    webdriver::ViewCreator* webCreator = NULL;
-    webdriver::ViewCreator* qmlCreator =  NULL;
-    /* 
-       Register view classes (here some test classes) that can be created by WebDriver. 
-       Creation can be triggered by client side request like wd.get("qtwidget://WindowTestWidget"); 
-       See https://github.com/cisco-open-source/qtwebdriver/wiki/Hybridity-And-View-Management
-    */
-    widgetCreator->RegisterViewClass<QWidget>("QWidget");
-    
 #if (WD_ENABLE_WEB_VIEW == 1)
-    /* Configure web views */
-    webCreator = new webdriver::QWebViewCreator();
-    webCreator->RegisterViewClass<QWebViewExt>("QWebViewExt");
+void wd_init_web_views(webdriver::ViewCreator* webCreator)
+{
     webdriver::ViewFactory::GetInstance()->AddViewCreator(webCreator);
-  
+
     /* Configure WebView support */
     webdriver::ViewEnumerator::AddViewEnumeratorImpl(new webdriver::WebViewEnumeratorImpl());
     webdriver::ViewCmdExecutorFactory::GetInstance()->AddViewCmdExecutorCreator(new webdriver::QWebViewCmdExecutorCreator());
 
     /* Configure GraphicsWebView support */
     webdriver::ViewEnumerator::AddViewEnumeratorImpl(new webdriver::GraphicsWebViewEnumeratorImpl());
-    webdriver::ViewCmdExecutorFactory::GetInstance()->AddViewCmdExecutorCreator(new webdriver::GraphicsWebViewCmdExecutorCreator());  
+    webdriver::ViewCmdExecutorFactory::GetInstance()->AddViewCmdExecutorCreator(new webdriver::GraphicsWebViewCmdExecutorCreator());
+}
 #endif // WD_ENABLE_WEB_VIEW
 
 #ifndef QT_NO_QML
+void wd_init_qml_views(webdriver::ViewCreator* qmlCreator)
+{
+    webdriver::ViewFactory::GetInstance()->AddViewCreator(qmlCreator);
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
     // Quick2 extension
-    qmlCreator = new webdriver::Quick2ViewCreator();
-    qmlCreator->RegisterViewClass<QQuickView>("QQuickView");
-    webdriver::ViewFactory::GetInstance()->AddViewCreator(qmlCreator);
     webdriver::ViewEnumerator::AddViewEnumeratorImpl(new webdriver::Quick2ViewEnumeratorImpl());
     webdriver::ViewCmdExecutorFactory::GetInstance()->AddViewCmdExecutorCreator(new webdriver::Quick2ViewCmdExecutorCreator());
 #else
     // Quick1 extension
-    qmlCreator = new webdriver::QQmlViewCreator();
-    qmlCreator->RegisterViewClass<QDeclarativeView>("QDeclarativeView");
-    webdriver::ViewFactory::GetInstance()->AddViewCreator(qmlCreator);
     webdriver::ViewEnumerator::AddViewEnumeratorImpl(new webdriver::QmlViewEnumeratorImpl());
     webdriver::ViewCmdExecutorFactory::GetInstance()->AddViewCmdExecutorCreator(new webdriver::QQmlViewCmdExecutorCreator());
-    
+
     #if (WD_ENABLE_WEB_VIEW == 1)
         qmlRegisterType<QDeclarativeWebSettings>();
         qmlRegisterType<QDeclarativeWebView>("CiscoQtWebKit", 1, 0, "CiscoWebView");
@@ -155,14 +182,24 @@ int wd_setup(int argc, char *argv[])
         qmlRegisterRevision<QDeclarativeWebView, 0>("CiscoQtWebKit", 1, 0);
         qmlRegisterRevision<QDeclarativeWebView, 1>("CiscoQtWebKit", 1, 1);
     #endif
-
 #endif
+}
 #endif //QT_NO_QML
-    /* Add widget creator last so that it deos not conflict with webview creator (QWebView is a subclass of QWidget)*/
-    webdriver::ViewFactory::GetInstance()->AddViewCreator(widgetCreator);
-    webdriver::ViewEnumerator::AddViewEnumeratorImpl(new webdriver::WidgetViewEnumeratorImpl());
-    webdriver::ViewCmdExecutorFactory::GetInstance()->AddViewCmdExecutorCreator(new webdriver::QWidgetViewCmdExecutorCreator());
-    
+
+int wd_setup(int argc, char *argv[])
+{
+    webdriver::StartupTimings* timings = webdriver::StartupTimings::GetInstance();
+    timings->Begin();
+
+#if (QT_VERSION < QT_VERSION_CHECK(5, 0, 0))
+    QTextCodec::setCodecForCStrings(QTextCodec::codecForName("utf8"));
+#endif
+    webdriver::ViewRunner::RegisterCustomRunner<webdriver::QViewRunner>();
+
+    webdriver::SessionLifeCycleActions::RegisterCustomLifeCycleActions<webdriver::QSessionLifeCycleActions>();
+
+    webdriver::ViewTransitionManager::SetURLTransitionAction(new webdriver::URLTransitionAction_CloseOldView());
+
     CommandLine cmd_line(CommandLine::NO_PROGRAM);
 #if defined(OS_WIN)
     for (int var = 0; var < argc; ++var) {
@@ -172,11 +209,6 @@ int wd_setup(int argc, char *argv[])
     cmd_line.InitFromArgv(argc, argv);
 #endif
 
-#ifndef QT_NO_SAMPLES
-    /* optional samples setup */
-    wd_samples_setup(widgetCreator, webCreator, qmlCreator, cmd_line);
-#endif // QT_NO_SAMPLES
-
 #if defined(OS_WIN)
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
     system("qtenv2.bat vsvars");
@@ -191,23 +223,89 @@ int wd_setup(int argc, char *argv[])
         std::cout << "Error while configuring WD server, exiting..." << std::endl;
         return 1;
     }
+    timings->Mark("configure");
+
+    /* Server options include ones from config file */
+    WDStartupConfig config;
+    wd_startup_config(wd_server->GetCommandLine(), &config);
+
+    webdriver::ViewCreator* widgetCreator = NULL;
+    webdriver::ViewCreator* webCreator = NULL;
+    webdriver::ViewCreator* qmlCreator =  NULL;
+    /* 
+       Register view classes (here some test classes) that can be created by WebDriver. 
+       Creation can be triggered by client side request like wd.get("qtwidget://WindowTestWidget"); 
+       See https://github.com/cisco-open-source/qtwebdriver/wiki/Hybridity-And-View-Management
+    */
+    if (config.widgetViews) {
+        widgetCreator = new webdriver::QWidgetViewCreator();
+        widgetCreator->RegisterViewClass<QWidget>("QWidget");
+    }
+
+#if (WD_ENABLE_WEB_VIEW == 1)
+    if (config.webViews) {
+        webCreator = new webdriver::QWebViewCreator();
+        webCreator->RegisterViewClass<QWebViewExt>("QWebViewExt");
+    }
+#endif // WD_ENABLE_WEB_VIEW
+
+#ifndef QT_NO_QML
+    if (config.qmlViews) {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+        qmlCreator = new webdriver::Quick2ViewCreator();
+        qmlCreator->RegisterViewClass<QQuickView>("QQuickView");
+#else
+        qmlCreator = new webdriver::QQmlViewCreator();
+        qmlCreator->RegisterViewClass<QDeclarativeView>("QDeclarativeView");
+#endif
+    }
+#endif //QT_NO_QML
+
+#ifndef QT_NO_SAMPLES
+    /* optional samples setup */
+    wd_samples_setup(widgetCreator, webCreator, qmlCreator, cmd_line);
+#endif // QT_NO_SAMPLES
+
+    /* Factories, enumerators and executors are set up when first session is created */
+    webdriver::DeferredViewSupport* viewSupport = webdriver::DeferredViewSupport::GetInstance();
+#if (WD_ENABLE_WEB_VIEW == 1)
+    if (webCreator)
+        viewSupport->Add("web views", base::Bind(&wd_init_web_views, webCreator));
+#endif // WD_ENABLE_WEB_VIEW
+#ifndef QT_NO_QML
+    if (qmlCreator)
+        viewSupport->Add("qml views", base::Bind(&wd_init_qml_views, qmlCreator));
+#endif //QT_NO_QML
+    if (widgetCreator)
+        viewSupport->Add("widget views", base::Bind(&wd_init_widget_views, widgetCreator));
+    timings->Mark("view registration");
 
     /* Example how to add a custom command */
-    webdriver::RouteTable *routeTableWithShutdownCommand = new webdriver::RouteTable(wd_server->GetRouteTable());
+    webdriver::RouteTable *routeTable = wd_server->GetMutableRouteTable();
     const char shutdownCommandRoute[] = "/-cisco-shutdown";
-    routeTableWithShutdownCommand->Add<webdriver::ShutdownCommand>(shutdownCommandRoute);
-    routeTableWithShutdownCommand->Add<webdriver::ShutdownCommand>(webdriver::CommandRoutes::kShutdown);
-    wd_server->SetRouteTable(routeTableWithShutdownCommand);
+    routeTable->Add<webdriver::ShutdownCommand>(shutdownCommandRoute);
+    routeTable->Add<webdriver::ShutdownCommand>(webdriver::CommandRoutes::kShutdown);
+
+    /* Start webdriver */
+    int startError = wd_server->Start();
+    if (startError){
+        std::cout << "Error while starting server, errorCode " << startError << std::endl;
+        return startError;
+    }
+    timings->Mark("server start");
+
+    /* Optional input subsystems are initialized after listener is started.
+       Commands need UI thread, so they are processed only after this setup is done. */
 
     /* check for VNC input support */
-    if (cmd_line.HasSwitch(webdriver::Switches::kVNCLogin))
+    if (config.vnc)
     {
         QString address = "127.0.0.1";
         QString login = "anonymous";
         QString *password = new QString();
         QString port = "5900";
 
-        QString loginInfo = cmd_line.GetSwitchValueASCII(webdriver::Switches::kVNCLogin).c_str();
+        QString loginInfo = wd_server->GetCommandLine().GetSwitchValueASCII(webdriver::Switches::kVNCLogin).c_str();
         VNCClient::SplitVncLoginParameters(loginInfo, &login, password, &address, &port);
 
         VNCClient *client = VNCClient::getInstance();
@@ -220,11 +318,12 @@ int wd_setup(int argc, char *argv[])
         }
 
         WDEventDispatcher::getInstance()->add(new VNCEventDispatcher(client));
+        timings->Mark("vnc");
     }
 
     /* check for Linux UInput input support */
 #ifdef OS_LINUX
-    if (cmd_line.HasSwitch(webdriver::Switches::kUserInputDevice))
+    if (config.uinput)
     {
         UInputManager *manager = UInputManager::getInstance();
         if (!manager->isReady())
@@ -233,15 +332,11 @@ int wd_setup(int argc, char *argv[])
         }
 
         WDEventDispatcher::getInstance()->add(new UInputEventDispatcher(manager));
+        timings->Mark("uinput");
     }
 #endif // OS_LINUX
 
-    /* Start webdriver */
-    int startError = wd_server->Start();
-    if (startError){
-        std::cout << "Error while starting server, errorCode " << startError << std::endl;
-        return startError;
-    }
+    timings->Report("driver startup");
 
     return startError;
 }
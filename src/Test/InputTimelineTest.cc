@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+**
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+
+/* InputTimelineTest.cc
+  Checks how InputTimelineBuilder orders and coalesces events of W3C action
+  sequences. Actions do not use element origins, so no view is needed.
+  Returns non-zero exit code on failure.
+  */
+
+#include <algorithm>
+#include <string>
+
+#include "base/json/json_reader.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/utf_string_conversions.h"
+#include "base/values.h"
+#include "webdriver_error.h"
+#include "webdriver_input_actions.h"
+#include "StandaloneTest.h"
+
+using namespace webdriver;
+
+namespace {
+
+// double quotes are written as single ones in |json|
+bool buildTimeline(InputState* state, const std::string& json, InputTimeline* timeline)
+{
+    std::string actions_json = json;
+    std::replace(actions_json.begin(), actions_json.end(), '\'', '"');
+
+    scoped_ptr<base::Value> actions(base::JSONReader::Read(actions_json));
+    base::ListValue* list = NULL;
+    if (!actions.get() || !actions->GetAsList(&list))
+        return false;
+
+    InputTimelineBuilder builder(NULL, *state, Point(0, 0));
+    Error* error = NULL;
+    if (!builder.Build(list, timeline, &error)) {
+        delete error;
+        return false;
+    }
+    *state = builder.state();
+    return true;
+}
+
+bool isAt(const InputTouchPoint& point, int x, int y)
+{
+    return x == point.position.x() && y == point.position.y();
+}
+
+bool isTouch(const InputAction& action, size_t points)
+{
+    return InputAction::kTouch == action.type && points == action.touch_points.size();
+}
+
+void testTap()
+{
+    InputState state;
+    InputTimeline timeline;
+    TEST_CHECK(buildTimeline(&state,
+        "[{'id': 'finger', 'type': 'pointer', 'parameters': {'pointerType': 'touch'},"
+        "  'actions': [{'type': 'pointerMove', 'x': 10, 'y': 20},"
+        "              {'type': 'pointerDown'}, {'type': 'pointerUp'}]}]",
+        &timeline));
+
+    // press and release at same time are not merged into single release
+    TEST_CHECK(2 == timeline.size());
+    if (2 != timeline.size())
+        return;
+    TEST_CHECK(isTouch(timeline[0], 1) && isTouch(timeline[1], 1));
+    TEST_CHECK(InputTouchPoint::kPressed == timeline[0].touch_points[0].state);
+    TEST_CHECK(InputTouchPoint::kReleased == timeline[1].touch_points[0].state);
+    TEST_CHECK(timeline[0].touch_points[0].id == timeline[1].touch_points[0].id);
+    TEST_CHECK(isAt(timeline[0].touch_points[0], 10, 20));
+}
+
+void testTwoFingerPress()
+{
+    InputState state;
+    InputTimeline timeline;
+    TEST_CHECK(buildTimeline(&state,
+        "[{'id': 'finger1', 'type': 'pointer', 'parameters': {'pointerType': 'touch'},"
+        "  'actions': [{'type': 'pointerMove', 'x': 10, 'y': 10}, {'type': 'pointerDown'}]},"
+        " {'id': 'finger2', 'type': 'pointer', 'parameters': {'pointerType': 'touch'},"
+        "  'actions': [{'type': 'pointerMove', 'x': 50, 'y': 50}, {'type': 'pointerDown'}]}]",
+        &timeline));
+
+    // contacts pressed in same tick go into single event
+    TEST_CHECK(1 == timeline.size() && isTouch(timeline[0], 2));
+    if (1 != timeline.size())
+        return;
+    TEST_CHECK(InputTouchPoint::kPressed == timeline[0].touch_points[0].state);
+    TEST_CHECK(InputTouchPoint::kPressed == timeline[0].touch_points[1].state);
+    TEST_CHECK(timeline[0].touch_points[0].id != timeline[0].touch_points[1].id);
+
+    // second finger lifted, first one stays
+    timeline.clear();
+    TEST_CHECK(buildTimeline(&state,
+        "[{'id': 'finger2', 'type': 'pointer', 'parameters': {'pointerType': 'touch'},"
+        "  'actions': [{'type': 'pointerUp'}]}]",
+        &timeline));
+    TEST_CHECK(1 == timeline.size() && isTouch(timeline[0], 2));
+    if (1 != timeline.size())
+        return;
+    TEST_CHECK(InputTouchPoint::kStationary == timeline[0].touch_points[0].state);
+    TEST_CHECK(InputTouchPoint::kReleased == timeline[0].touch_points[1].state);
+
+    // release of held contact
+    timeline.clear();
+    InputTimelineBuilder builder(NULL, state, Point(0, 0));
+    builder.BuildRelease(&timeline);
+    TEST_CHECK(1 == timeline.size() && isTouch(timeline[0], 1));
+    if (1 != timeline.size())
+        return;
+    TEST_CHECK(InputTouchPoint::kReleased == timeline[0].touch_points[0].state);
+    TEST_CHECK(isAt(timeline[0].touch_points[0], 10, 10));
+}
+
+void testKeyAndPointerOrder()
+{
+    InputState state;
+    InputTimeline timeline;
+    TEST_CHECK(buildTimeline(&state,
+        "[{'id': 'keyboard', 'type': 'key',"
+        "  'actions': [{'type': 'keyDown', 'value': 'a'}, {'type': 'keyUp', 'value': 'a'},"
+        "              {'type': 'keyDown', 'value': 'b'}, {'type': 'keyUp', 'value': 'b'}]},"
+        " {'id': 'mouse', 'type': 'pointer',"
+        "  'actions': [{'type': 'pointerDown'}, {'type': 'pointerUp'}]},"
+        " {'id': 'finger', 'type': 'pointer', 'parameters': {'pointerType': 'touch'},"
+        "  'actions': [{'type': 'pause'}, {'type': 'pause'},"
+        "              {'type': 'pointerDown'}, {'type': 'pointerUp'}]}]",
+        &timeline));
+
+    // events of same time keep tick and source order
+    const InputAction::Type expected[] = {
+        InputAction::kKeyDown, InputAction::kPointerDown,
+        InputAction::kKeyUp, InputAction::kPointerUp,
+        InputAction::kKeyDown, InputAction::kTouch,
+        InputAction::kKeyUp, InputAction::kTouch
+    };
+    const size_t count = sizeof(expected) / sizeof(expected[0]);
+    TEST_CHECK(count == timeline.size());
+    if (count != timeline.size())
+        return;
+    for (size_t i = 0; i < count; ++i)
+        TEST_CHECK(expected[i] == timeline[i].type);
+
+    TEST_CHECK(ASCIIToUTF16("a") == timeline[0].key && ASCIIToUTF16("b") == timeline[6].key);
+    TEST_CHECK((1 << kLeftButton) == timeline[1].buttons && 0 == timeline[3].buttons);
+    TEST_CHECK(InputTouchPoint::kPressed == timeline[5].touch_points[0].state);
+    TEST_CHECK(InputTouchPoint::kReleased == timeline[7].touch_points[0].state);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    testTap();
+    testTwoFingerPress();
+    testKeyAndPointerOrder();
+
+    return StandaloneTest::Result();
+}
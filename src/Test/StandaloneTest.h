@@ -0,0 +1,58 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+**
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+
+/* StandaloneTest.h
+  Harness of standalone test executables, which check single component
+  without running WebDriver server. Failed checks are printed and counted,
+  exit code of test is given by StandaloneTest::Result().
+  */
+
+#ifndef STANDALONETEST_H
+#define STANDALONETEST_H
+
+#include <iostream>
+
+namespace StandaloneTest {
+
+inline int& Failures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+// prints summary, returns exit code for main()
+inline int Result()
+{
+    std::cout << (Failures() ? "FAILED" : "PASSED") << std::endl;
+    return Failures() ? 1 : 0;
+}
+
+}  // namespace StandaloneTest
+
+// not CHECK, which is taken by base/logging.h
+#define TEST_CHECK(expr) \
+    do { \
+        if (!(expr)) { \
+            std::cout << "FAILED: " << #expr << " at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            ++StandaloneTest::Failures(); \
+        } \
+    } while (0)
+
+#endif // STANDALONETEST_H
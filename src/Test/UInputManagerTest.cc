@@ -0,0 +1,132 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+**
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+/* UInputManagerTest.cc
+  Checks that UInputManager writes batch of events with single write() call.
+  Mock device is SOCK_SEQPACKET socket pair, so every write() is received as
+  one packet. Returns non-zero exit code on failure.
+  */
+
+#include <vector>
+
+#include <signal.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "build/build_config.h"
+#include "extension_qt/uinput_manager.h"
+#include "StandaloneTest.h"
+
+namespace {
+
+void addEvent(std::vector<struct input_event> *events, int type, int code, int value)
+{
+    struct input_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+    events->push_back(ev);
+}
+
+void addReport(std::vector<struct input_event> *events, int moves)
+{
+    for (int i = 0; i < moves; ++i)
+        addEvent(events, EV_ABS, (i % 2) ? ABS_Y : ABS_X, i);
+    addEvent(events, EV_SYN, SYN_REPORT, 0);
+}
+
+/*
+  Writes events through UInputManager::writeBatch to mock device.
+  @param [out] writes - number of events in each write()
+  @return true if all events are received back unchanged
+  */
+bool writeToMockDevice(const std::vector<struct input_event> &events, std::vector<size_t> *writes)
+{
+    int fds[2];
+    if (0 != socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds))
+        return false;
+
+    const size_t written = UInputManager::writeBatch(fds[0], events);
+    close(fds[0]);
+
+    std::vector<struct input_event> received;
+    std::vector<struct input_event> packet(events.size() + 1);
+    ssize_t res;
+    while (0 < (res = recv(fds[1], &packet[0], packet.size() * sizeof(struct input_event), 0)))
+    {
+        const size_t count = res / sizeof(struct input_event);
+        writes->push_back(count);
+        received.insert(received.end(), packet.begin(), packet.begin() + count);
+    }
+    close(fds[1]);
+
+    return written == events.size() && received.size() == events.size() &&
+           (events.empty() || 0 == memcmp(&received[0], &events[0], events.size() * sizeof(struct input_event)));
+}
+
+void testBatchIsSingleWrite()
+{
+    std::vector<struct input_event> events;
+    std::vector<size_t> writes;
+    // about as many events as sendKeys of 25 characters
+    for (int i = 0; i < 50; ++i)
+        addReport(&events, 1);
+
+    TEST_CHECK(writeToMockDevice(events, &writes));
+    TEST_CHECK(1 == writes.size() && events.size() == writes[0]);
+}
+
+void testEmptyBatch()
+{
+    std::vector<struct input_event> events;
+    std::vector<size_t> writes;
+
+    TEST_CHECK(writeToMockDevice(events, &writes));
+    TEST_CHECK(writes.empty());
+}
+
+void testWriteError()
+{
+    std::vector<struct input_event> events;
+    addReport(&events, 2);
+    addReport(&events, 2);
+
+    int fds[2];
+    TEST_CHECK(0 == socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds));
+    close(fds[1]);
+    // peer is gone, write fails
+    TEST_CHECK(0 == UInputManager::writeBatch(fds[0], events));
+    close(fds[0]);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    // failed writes to closed mock device must not kill test
+    signal(SIGPIPE, SIG_IGN);
+
+    testBatchIsSingleWrite();
+    testEmptyBatch();
+    testWriteError();
+
+    return StandaloneTest::Result();
+}
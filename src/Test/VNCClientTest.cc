@@ -0,0 +1,481 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+**
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+/* VNCClientTest.cc
+  Checks framebuffer grabbing of VNCClient against local VNC server stand-in,
+  which answers incremental update requests only when it has damage, as real
+  servers do, and decoding of CopyRect and ZRLE rectangles by RfbFramebuffer.
+  Returns non-zero exit code on failure.
+  */
+
+#include <string.h>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QTime>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+
+#include "extension_qt/vncclient.h"
+#include "vnc/rfb_framebuffer.h"
+#include "StandaloneTest.h"
+
+#if (1 == WD_ENABLE_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace {
+
+const int kIoTimeoutMs = 5000;
+const quint16 kWidth = 64;
+const quint16 kHeight = 32;
+const quint32 kFirstColor = 0x00112233;
+const quint32 kDamageColor = 0x00445566;
+
+void putU16(QByteArray* msg, quint16 value)
+{
+    msg->append((char)(value >> 8));
+    msg->append((char)(value & 0xff));
+}
+
+void putU32(QByteArray* msg, quint32 value)
+{
+    putU16(msg, (quint16)(value >> 16));
+    putU16(msg, (quint16)(value & 0xffff));
+}
+
+QByteArray updateHeader(quint16 rects)
+{
+    QByteArray msg(2, 0);
+    putU16(&msg, rects);
+    return msg;
+}
+
+QByteArray rectHeader(quint16 x, quint16 y, quint16 w, quint16 h, qint32 encoding)
+{
+    QByteArray msg;
+    putU16(&msg, x);
+    putU16(&msg, y);
+    putU16(&msg, w);
+    putU16(&msg, h);
+    putU32(&msg, (quint32)encoding);
+    return msg;
+}
+
+// FramebufferUpdate with single Raw rectangle of |pixel| colour
+QByteArray rawUpdate(quint16 x, quint16 y, quint16 w, quint16 h, quint32 pixel)
+{
+    QByteArray msg = updateHeader(1) + rectHeader(x, y, w, h, RfbFramebuffer::RawEncoding);
+    for (int i = 0; i < w * h; ++i)
+    {
+        // little endian, as set by client with SetPixelFormat
+        msg.append((char)(pixel & 0xff));
+        msg.append((char)((pixel >> 8) & 0xff));
+        msg.append((char)((pixel >> 16) & 0xff));
+        msg.append((char)0);
+    }
+    return msg;
+}
+
+// CopyRect rectangle moving |w|x|h| area from |srcX|, |srcY| to |x|, |y|
+QByteArray copyRectUpdate(quint16 x, quint16 y, quint16 w, quint16 h, quint16 srcX, quint16 srcY)
+{
+    QByteArray msg = updateHeader(1) + rectHeader(x, y, w, h, RfbFramebuffer::CopyRectEncoding);
+    putU16(&msg, srcX);
+    putU16(&msg, srcY);
+    return msg;
+}
+
+// ZRLE compressed pixel, 3 low bytes of little endian pixel
+void putCPixel(QByteArray* msg, quint32 pixel)
+{
+    msg->append((char)(pixel & 0xff));
+    msg->append((char)((pixel >> 8) & 0xff));
+    msg->append((char)((pixel >> 16) & 0xff));
+}
+
+quint32 pixelAt(const QImage& image, int x, int y)
+{
+    return image.pixel(x, y) & 0x00ffffff;
+}
+
+quint32 pixelAt(const RfbFramebuffer& framebuffer, int x, int y)
+{
+    return framebuffer.pixels()[y * framebuffer.width() + x];
+}
+
+// feeds whole message to framebuffer
+bool process(RfbFramebuffer* framebuffer, const QByteArray& msg, int* updates)
+{
+    return msg.size() == framebuffer->processServerMessages((const uint8*)msg.constData(), msg.size(), updates);
+}
+
+#if (1 == WD_ENABLE_ZLIB)
+/*
+  Compresses ZRLE rectangles with single zlib stream, as server does for
+  whole connection.
+  */
+class ZRLEStream
+{
+public:
+    ZRLEStream()
+    {
+        memset(&_stream, 0, sizeof(_stream));
+        deflateInit(&_stream, Z_DEFAULT_COMPRESSION);
+    }
+
+    ~ZRLEStream()
+    {
+        deflateEnd(&_stream);
+    }
+
+    // FramebufferUpdate with single ZRLE rectangle made of |tiles|
+    QByteArray update(quint16 x, quint16 y, quint16 w, quint16 h, const QByteArray& tiles)
+    {
+        QByteArray zlibData(2 * tiles.size() + 64, 0);
+        _stream.next_in = (Bytef*)tiles.constData();
+        _stream.avail_in = tiles.size();
+        _stream.next_out = (Bytef*)zlibData.data();
+        _stream.avail_out = zlibData.size();
+        deflate(&_stream, Z_SYNC_FLUSH);
+        zlibData.resize(zlibData.size() - _stream.avail_out);
+
+        QByteArray msg = updateHeader(1) + rectHeader(x, y, w, h, RfbFramebuffer::ZRLEEncoding);
+        putU32(&msg, zlibData.size());
+        return msg + zlibData;
+    }
+
+private:
+    z_stream _stream;
+};
+#endif
+
+/*
+  VNC server stand-in, runs scripted RFB 3.8 session with blocking socket
+  in own thread, while client is driven by event loop of main thread.
+  */
+class VNCServerStandIn : public QThread
+{
+public:
+    VNCServerStandIn() : _port(0), _ok(true) {}
+
+    quint16 port() const { return _port; }
+    bool ok() const { return _ok; }
+
+    // main thread waits until server listens
+    QSemaphore listening;
+    // main thread allows next scripted damage
+    QSemaphore damaged;
+    // main thread is done with connection
+    QSemaphore finished;
+
+protected:
+    virtual void run()
+    {
+        QTcpServer server;
+        server.listen(QHostAddress::LocalHost);
+        _port = server.serverPort();
+        listening.release();
+
+        if (!server.waitForNewConnection(kIoTimeoutMs))
+        {
+            _ok = false;
+            return;
+        }
+        QTcpSocket* socket = server.nextPendingConnection();
+        _ok = runScript(socket);
+        finished.acquire();
+        delete socket;
+    }
+
+private:
+    bool runScript(QTcpSocket* socket)
+    {
+        QByteArray data;
+        bool incremental;
+
+        // version, security type None, security result, ServerInit
+        write(socket, QByteArray("RFB 003.008\n"));
+        if (!read(socket, 12, &data))
+            return false;
+        write(socket, QByteArray("\x01\x01", 2));
+        if (!read(socket, 1, &data))
+            return false;
+        write(socket, QByteArray(4, 0));
+        if (!read(socket, 1, &data))
+            return false;
+        QByteArray init;
+        putU16(&init, kWidth);
+        putU16(&init, kHeight);
+        init.append(QByteArray("\x20\x18\x00\x01\x00\xff\x00\xff\x00\xff\x10\x08\x00\x00\x00\x00", 16));
+        putU32(&init, 8);
+        init.append("stand-in");
+        write(socket, init);
+
+        // first grab gets whole framebuffer
+        if (!readUpdateRequest(socket, &incremental) || incremental)
+            return false;
+        write(socket, rawUpdate(0, 0, kWidth, kHeight, kFirstColor));
+
+        // request client keeps outstanding, nothing changed yet
+        if (!readUpdateRequest(socket, &incremental))
+            return false;
+
+        // damage appears, it is sent only on request made by next grab
+        damaged.acquire();
+        if (!readUpdateRequest(socket, &incremental) || !incremental)
+            return false;
+        write(socket, rawUpdate(0, 0, 8, 8, kDamageColor));
+        if (!readUpdateRequest(socket, &incremental))
+            return false;
+
+        // grab without damage gets no answer
+        if (!readUpdateRequest(socket, &incremental))
+            return false;
+
+        // bogus desktop size, client has to stop updates instead of
+        // allocating 16GB
+        damaged.acquire();
+        write(socket, updateHeader(1) + rectHeader(0, 0, 0xffff, 0xffff,
+                                                   RfbFramebuffer::DesktopSizeEncoding));
+        return true;
+    }
+
+    static bool read(QTcpSocket* socket, int size, QByteArray* data)
+    {
+        while (socket->bytesAvailable() < size)
+        {
+            if (!socket->waitForReadyRead(kIoTimeoutMs))
+                return false;
+        }
+        *data = socket->read(size);
+        return true;
+    }
+
+    static void write(QTcpSocket* socket, const QByteArray& data)
+    {
+        socket->write(data);
+        socket->waitForBytesWritten(kIoTimeoutMs);
+    }
+
+    // skips SetPixelFormat and SetEncodings
+    static bool readUpdateRequest(QTcpSocket* socket, bool* incremental)
+    {
+        QByteArray data;
+        while (read(socket, 1, &data))
+        {
+            switch (data.at(0))
+            {
+                case 0:
+                    if (!read(socket, 19, &data))
+                        return false;
+                    break;
+                case 2:
+                {
+                    if (!read(socket, 3, &data))
+                        return false;
+                    const int count = ((uchar)data.at(1) << 8) | (uchar)data.at(2);
+                    if (!read(socket, 4 * count, &data))
+                        return false;
+                    break;
+                }
+                case 3:
+                    if (!read(socket, 9, &data))
+                        return false;
+                    *incremental = (0 != data.at(0));
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    quint16 _port;
+    bool _ok;
+};
+
+void testFramebufferGrab()
+{
+    VNCServerStandIn server;
+    server.start();
+    server.listening.acquire();
+
+    VNCClient* client = VNCClient::getInstance();
+    TEST_CHECK(client->Init("127.0.0.1", server.port()));
+
+    QTime time;
+    time.start();
+    while (!client->isReady() && time.elapsed() < kIoTimeoutMs)
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 100);
+    TEST_CHECK(client->isReady());
+
+    QImage image;
+    TEST_CHECK(client->grabFramebuffer(QRect(), &image, kIoTimeoutMs));
+    TEST_CHECK(image.width() == kWidth && image.height() == kHeight);
+    TEST_CHECK(pixelAt(image, 0, 0) == kFirstColor);
+
+    // damage made after outstanding request was answered
+    server.damaged.release();
+    TEST_CHECK(client->grabFramebuffer(QRect(), &image, kIoTimeoutMs));
+    TEST_CHECK(pixelAt(image, 0, 0) == kDamageColor);
+    TEST_CHECK(pixelAt(image, 10, 10) == kFirstColor);
+
+    // no damage, grab must not wait for whole timeout
+    time.restart();
+    TEST_CHECK(client->grabFramebuffer(QRect(8, 8, 8, 8), &image, kIoTimeoutMs));
+    TEST_CHECK(time.elapsed() < kIoTimeoutMs / 2);
+    TEST_CHECK(image.size() == QSize(8, 8) && pixelAt(image, 0, 0) == kFirstColor);
+
+    // grabs keep working until bogus update is received
+    server.damaged.release();
+    bool grabbed = true;
+    time.restart();
+    while (grabbed && time.elapsed() < kIoTimeoutMs)
+        grabbed = client->grabFramebuffer(QRect(), &image, kIoTimeoutMs);
+    TEST_CHECK(!grabbed);
+
+    server.finished.release();
+    server.wait();
+    TEST_CHECK(server.ok());
+}
+
+void testFramebufferLimits()
+{
+    RfbFramebuffer framebuffer;
+    int updates = 0;
+
+    TEST_CHECK(!framebuffer.reset(0xffff, 0xffff));
+    TEST_CHECK(0 == framebuffer.width() && NULL == framebuffer.pixels());
+
+    // oversized desktop size is refused before allocation
+    TEST_CHECK(framebuffer.reset(16, 16));
+    QByteArray msg = updateHeader(1) + rectHeader(0, 0, 0xffff, 0xffff,
+                                                  RfbFramebuffer::DesktopSizeEncoding);
+    TEST_CHECK(-1 == framebuffer.processServerMessages((const uint8*)msg.constData(), msg.size(), &updates));
+
+    // raw rectangle outside framebuffer is refused by header, payload
+    // is never awaited
+    TEST_CHECK(framebuffer.reset(16, 16));
+    msg = updateHeader(1) + rectHeader(0, 0, 17, 0xffff, RfbFramebuffer::RawEncoding);
+    TEST_CHECK(-1 == framebuffer.processServerMessages((const uint8*)msg.constData(), msg.size(), &updates));
+
+    TEST_CHECK(framebuffer.reset(16, 16));
+    msg = updateHeader(1) + rectHeader(0, 0, 32, 8, RfbFramebuffer::DesktopSizeEncoding);
+    TEST_CHECK(msg.size() == framebuffer.processServerMessages((const uint8*)msg.constData(), msg.size(), &updates));
+    TEST_CHECK(32 == framebuffer.width() && 8 == framebuffer.height() && 1 == updates);
+
+    // overlapping CopyRect, rows have to be copied in right direction
+    TEST_CHECK(framebuffer.reset(16, 16));
+    for (quint16 row = 0; row < 4; ++row)
+        TEST_CHECK(process(&framebuffer, rawUpdate(0, row, 4, 1, 0x10 + row), &updates));
+    TEST_CHECK(process(&framebuffer, copyRectUpdate(0, 1, 4, 3, 0, 0), &updates));
+    TEST_CHECK(0x10 == pixelAt(framebuffer, 3, 0) && 0x10 == pixelAt(framebuffer, 3, 1));
+    TEST_CHECK(0x11 == pixelAt(framebuffer, 3, 2) && 0x12 == pixelAt(framebuffer, 3, 3));
+    TEST_CHECK(process(&framebuffer, copyRectUpdate(0, 0, 4, 3, 0, 1), &updates));
+    TEST_CHECK(0x10 == pixelAt(framebuffer, 0, 0) && 0x11 == pixelAt(framebuffer, 0, 1));
+    TEST_CHECK(0x12 == pixelAt(framebuffer, 0, 2) && 0x12 == pixelAt(framebuffer, 0, 3));
+
+#if (1 == WD_ENABLE_ZLIB)
+    // ZRLE tiles of all sub-encodings, decoded from one zlib stream
+    ZRLEStream zrle;
+    QByteArray tiles;
+    TEST_CHECK(framebuffer.reset(80, 16));
+
+    // solid tile
+    tiles = QByteArray(1, 1);
+    putCPixel(&tiles, 0x0000a0);
+    TEST_CHECK(process(&framebuffer, zrle.update(0, 0, 16, 16, tiles), &updates));
+    TEST_CHECK(0x0000a0 == pixelAt(framebuffer, 0, 0) && 0x0000a0 == pixelAt(framebuffer, 15, 15));
+    TEST_CHECK(0 == pixelAt(framebuffer, 16, 0));
+
+    // packed palette of 2 colours, 1 bit per pixel, rows padded to byte
+    tiles = QByteArray(1, 2);
+    putCPixel(&tiles, 0x0000b0);
+    putCPixel(&tiles, 0x0000b1);
+    tiles.append((char)0xa0);
+    tiles.append((char)0x50);
+    TEST_CHECK(process(&framebuffer, zrle.update(0, 0, 4, 2, tiles), &updates));
+    TEST_CHECK(0x0000b1 == pixelAt(framebuffer, 0, 0) && 0x0000b0 == pixelAt(framebuffer, 1, 0));
+    TEST_CHECK(0x0000b1 == pixelAt(framebuffer, 2, 0) && 0x0000b0 == pixelAt(framebuffer, 3, 0));
+    TEST_CHECK(0x0000b0 == pixelAt(framebuffer, 0, 1) && 0x0000b1 == pixelAt(framebuffer, 3, 1));
+
+    // packed palette of 3 colours, 2 bits per pixel
+    tiles = QByteArray(1, 3);
+    putCPixel(&tiles, 0x0000c0);
+    putCPixel(&tiles, 0x0000c1);
+    putCPixel(&tiles, 0x0000c2);
+    tiles.append((char)0x24);   // 0, 2, 1, 0
+    TEST_CHECK(process(&framebuffer, zrle.update(4, 0, 4, 1, tiles), &updates));
+    TEST_CHECK(0x0000c0 == pixelAt(framebuffer, 4, 0) && 0x0000c2 == pixelAt(framebuffer, 5, 0));
+    TEST_CHECK(0x0000c1 == pixelAt(framebuffer, 6, 0) && 0x0000c0 == pixelAt(framebuffer, 7, 0));
+
+    // plain RLE over two tiles, first one has run longer than 255
+    tiles = QByteArray(1, (char)128);
+    putCPixel(&tiles, 0x0000d0);
+    tiles.append((char)255);
+    tiles.append((char)44);     // run of 300
+    putCPixel(&tiles, 0x0000d1);
+    tiles.append((char)19);     // run of 20
+    tiles.append((char)128);
+    putCPixel(&tiles, 0x0000d2);
+    tiles.append((char)29);     // second 6x5 tile
+    TEST_CHECK(process(&framebuffer, zrle.update(0, 10, 70, 5, tiles), &updates));
+    TEST_CHECK(0x0000d0 == pixelAt(framebuffer, 0, 10) && 0x0000d0 == pixelAt(framebuffer, 43, 14));
+    TEST_CHECK(0x0000d1 == pixelAt(framebuffer, 44, 14) && 0x0000d1 == pixelAt(framebuffer, 63, 14));
+    TEST_CHECK(0x0000d2 == pixelAt(framebuffer, 64, 10) && 0x0000d2 == pixelAt(framebuffer, 69, 14));
+
+    // palette RLE, runs and single pixels
+    tiles = QByteArray(1, (char)130);
+    putCPixel(&tiles, 0x0000e0);
+    putCPixel(&tiles, 0x0000e1);
+    tiles.append((char)0x80);
+    tiles.append((char)4);      // colour 0, run of 5
+    tiles.append((char)1);      // colour 1, single pixel
+    tiles.append((char)0x81);
+    tiles.append((char)9);      // colour 1, run of 10
+    TEST_CHECK(process(&framebuffer, zrle.update(16, 0, 8, 2, tiles), &updates));
+    TEST_CHECK(0x0000e0 == pixelAt(framebuffer, 16, 0) && 0x0000e0 == pixelAt(framebuffer, 20, 0));
+    TEST_CHECK(0x0000e1 == pixelAt(framebuffer, 21, 0) && 0x0000e1 == pixelAt(framebuffer, 23, 1));
+
+    // tile received in two reads, rectangle is not consumed until complete
+    tiles = QByteArray(1, 1);
+    putCPixel(&tiles, 0x0000f0);
+    msg = zrle.update(32, 0, 8, 8, tiles);
+    updates = 0;
+    const int consumed = framebuffer.processServerMessages((const uint8*)msg.constData(), msg.size() - 2, &updates);
+    TEST_CHECK(0 <= consumed && consumed < msg.size() - 2);
+    TEST_CHECK(0 == updates && 0 == pixelAt(framebuffer, 32, 0));
+    TEST_CHECK(process(&framebuffer, msg.mid(consumed), &updates));
+    TEST_CHECK(1 == updates && 0x0000f0 == pixelAt(framebuffer, 39, 7));
+#endif
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    testFramebufferLimits();
+    testFramebufferGrab();
+
+    return StandaloneTest::Result();
+}
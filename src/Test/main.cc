@@ -118,6 +118,10 @@ void PrintHelp() {
                 << "                                  format: login:password@ip:port"                 << std::endl
                 << "uinput         false              If option set, user input device"               << std::endl
                 << "                                  will be registered in the system"               << std::endl
+                << "views          widget,web,qml     Comma separated list of view types to support,"<< std::endl
+                << "                                  initialized when first session is created"      << std::endl
+                << "visualizer-xslt false             If option set, widget visualizer source is"     << std::endl
+                << "                                  transformed to HTML by driver"                  << std::endl
                 << "test_data      ./                 Specifies where to look for test specific data" << std::endl
                 << "whitelist                         The path to whitelist file (e.g. whitelist.xml)"<< std::endl
                 << "                                  in XML format with specified list of IP with"   << std::endl
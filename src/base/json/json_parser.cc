@@ -5,6 +5,7 @@
 #include "base/json/json_parser.h"
 
 #include "base/float_util.h"
+#include "base/json/json_string_scan.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/string_number_conversions.h"
@@ -147,6 +148,10 @@ class JSONStringValue : public base::Value {
     *out_value = UTF8ToUTF16(string_piece_);
     return true;
   }
+  virtual bool GetAsStringPiece(StringPiece* out_value) const OVERRIDE {
+    *out_value = string_piece_;
+    return true;
+  }
   virtual Value* DeepCopy() const OVERRIDE {
     return Value::CreateStringValue(string_piece_.as_string());
   }
@@ -314,6 +319,13 @@ void JSONParser::StringBuilder::AppendString(const std::string& str) {
   string_->append(str);
 }
 
+void JSONParser::StringBuilder::AppendRun(const char* str, int length) {
+  if (string_)
+    string_->append(str, length);
+  else
+    length_ += length;
+}
+
 void JSONParser::StringBuilder::Convert() {
   if (string_)
     return;
@@ -613,6 +625,17 @@ bool JSONParser::ConsumeStringRaw(StringBuilder* out) {
 
   while (CanConsume(1)) {
     pos_ = start_pos_ + index_;  // CBU8_NEXT is postcrement.
+
+    // Take run of ASCII characters up to next quote or escape in one step.
+    const int run = static_cast<int>(
+        internal::FindJsonStringSpecialByte(pos_, end_pos_ - pos_));
+    if (run) {
+      string.AppendRun(pos_, run);
+      NextNChars(run);
+      if (!CanConsume(1))
+        break;
+    }
+
     CBU8_NEXT(start_pos_, index_, length, next_char);
     if (next_char < 0 || !IsValidCharacter(next_char)) {
       ReportError(JSONReader::JSON_UNSUPPORTED_ENCODING, 1);
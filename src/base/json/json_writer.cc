@@ -4,6 +4,7 @@
 
 #include "base/json/json_writer.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "base/json/string_escape.h"
@@ -11,7 +12,6 @@
 #include "base/stringprintf.h"
 #include "base/string_number_conversions.h"
 #include "base/values.h"
-#include "base/utf_string_conversions.h"
 
 namespace base {
 
@@ -21,6 +21,42 @@ static const char kPrettyPrintLineEnding[] = "\r\n";
 static const char kPrettyPrintLineEnding[] = "\n";
 #endif
 
+namespace {
+
+// Returns approximate compact JSON size of |node|; strings are counted as if
+// nothing needs escaping. Used to size output buffer once instead of growing
+// it step by step while writing large responses.
+size_t EstimateJSONSize(const Value* node) {
+  switch (node->GetType()) {
+    case Value::TYPE_STRING: {
+      StringPiece string;
+      node->GetAsStringPiece(&string);
+      return string.length() + 2;
+    }
+    case Value::TYPE_LIST: {
+      const ListValue* list = static_cast<const ListValue*>(node);
+      size_t size = 2 + list->GetSize();
+      for (ListValue::const_iterator it = list->begin(); it != list->end();
+           ++it) {
+        size += EstimateJSONSize(*it);
+      }
+      return size;
+    }
+    case Value::TYPE_DICTIONARY: {
+      const DictionaryValue* dict = static_cast<const DictionaryValue*>(node);
+      size_t size = 2;
+      for (DictionaryValue::Iterator it(*dict); it.HasNext(); it.Advance())
+        size += it.key().length() + 4 + EstimateJSONSize(&it.value());
+      return size;
+    }
+    default:
+      // Numbers, booleans and null are short; this is their typical size.
+      return 4;
+  }
+}
+
+}  // namespace
+
 /* static */
 const char* JSONWriter::kEmptyArray = "[]";
 
@@ -33,8 +69,7 @@ void JSONWriter::Write(const Value* const node, std::string* json) {
 void JSONWriter::WriteWithOptions(const Value* const node, int options,
                                   std::string* json) {
   json->clear();
-  // Is there a better way to estimate the size of the output?
-  json->reserve(1024);
+  json->reserve(std::max<size_t>(1024, EstimateJSONSize(node)));
 
   bool escape = !(options & OPTIONS_DO_NOT_ESCAPE);
   bool omit_binary_values = !!(options & OPTIONS_OMIT_BINARY_VALUES);
@@ -50,6 +85,34 @@ void JSONWriter::WriteWithOptions(const Value* const node, int options,
     json->append(kPrettyPrintLineEnding);
 }
 
+/* static */
+bool JSONWriter::WriteToSink(const Value* const node, int options,
+                             size_t chunk_size, Sink* sink) {
+  DCHECK(sink);
+  DCHECK_GT(chunk_size, 0u);
+
+  std::string buffer;
+  buffer.reserve(chunk_size + chunk_size / 2);
+
+  bool escape = !(options & OPTIONS_DO_NOT_ESCAPE);
+  bool omit_binary_values = !!(options & OPTIONS_OMIT_BINARY_VALUES);
+  bool omit_double_type_preservation =
+      !!(options & OPTIONS_OMIT_DOUBLE_TYPE_PRESERVATION);
+  bool pretty_print = !!(options & OPTIONS_PRETTY_PRINT);
+
+  JSONWriter writer(escape, omit_binary_values, omit_double_type_preservation,
+                    pretty_print, &buffer);
+  writer.sink_ = sink;
+  writer.chunk_size_ = chunk_size;
+  writer.BuildJSONString(node, 0);
+
+  if (pretty_print)
+    buffer.append(kPrettyPrintLineEnding);
+  writer.Flush();
+
+  return !writer.sink_failed_;
+}
+
 JSONWriter::JSONWriter(bool escape, bool omit_binary_values,
                        bool omit_double_type_preservation, bool pretty_print,
                        std::string* json)
@@ -57,7 +120,10 @@ JSONWriter::JSONWriter(bool escape, bool omit_binary_values,
       omit_binary_values_(omit_binary_values),
       omit_double_type_preservation_(omit_double_type_preservation),
       pretty_print_(pretty_print),
-      json_string_(json) {
+      json_string_(json),
+      sink_(NULL),
+      chunk_size_(0),
+      sink_failed_(false) {
   DCHECK(json);
 }
 
@@ -120,14 +186,10 @@ void JSONWriter::BuildJSONString(const Value* const node, int depth) {
 
     case Value::TYPE_STRING:
       {
-        std::string value;
-        bool result = node->GetAsString(&value);
+        StringPiece value;
+        bool result = node->GetAsStringPiece(&value);
         DCHECK(result);
-        if (escape_) {
-          JsonDoubleQuote(UTF8ToUTF16(value), true, json_string_);
-        } else {
-          JsonDoubleQuote(value, true, json_string_);
-        }
+        AppendQuotedValue(value);
         break;
       }
 
@@ -154,6 +216,7 @@ void JSONWriter::BuildJSONString(const Value* const node, int depth) {
           }
 
           BuildJSONString(value, depth);
+          MaybeFlush();
         }
 
         if (pretty_print_)
@@ -196,6 +259,7 @@ void JSONWriter::BuildJSONString(const Value* const node, int depth) {
             json_string_->append(":");
           }
           BuildJSONString(value, depth + 1);
+          MaybeFlush();
         }
 
         if (pretty_print_) {
@@ -222,9 +286,56 @@ void JSONWriter::BuildJSONString(const Value* const node, int depth) {
 }
 
 void JSONWriter::AppendQuotedString(const std::string& str) {
-  // TODO(viettrungluu): |str| is UTF-8, not ASCII, so to properly escape it we
-  // have to convert it to UTF-16. This round-trip is suboptimal.
-  JsonDoubleQuote(UTF8ToUTF16(str), true, json_string_);
+  JsonDoubleQuoteUTF8(str, true, json_string_);
+}
+
+void JSONWriter::AppendQuotedValue(const StringPiece& str) {
+  if (!sink_ || str.length() <= chunk_size_) {
+    if (escape_) {
+      JsonDoubleQuoteUTF8(str, true, json_string_);
+    } else {
+      JsonDoubleQuote(str.as_string(), true, json_string_);
+    }
+    return;
+  }
+
+  json_string_->append("\"");
+  size_t pos = 0;
+  while (pos < str.length()) {
+    size_t end = std::min(str.length(), pos + chunk_size_);
+    // Do not cut multi-byte UTF-8 sequence, so each piece converts cleanly.
+    size_t cut = end;
+    while (cut > pos && cut < str.length() &&
+           (static_cast<unsigned char>(str[cut]) & 0xC0) == 0x80) {
+      --cut;
+    }
+    if (cut > pos)
+      end = cut;
+
+    if (escape_) {
+      JsonDoubleQuoteUTF8(StringPiece(str.data() + pos, end - pos), false,
+                          json_string_);
+    } else {
+      JsonDoubleQuote(str.substr(pos, end - pos).as_string(), false,
+                      json_string_);
+    }
+    pos = end;
+    MaybeFlush();
+  }
+  json_string_->append("\"");
+}
+
+void JSONWriter::MaybeFlush() {
+  if (sink_ && json_string_->length() >= chunk_size_)
+    Flush();
+}
+
+void JSONWriter::Flush() {
+  if (!sink_ || json_string_->empty())
+    return;
+  if (!sink_failed_)
+    sink_failed_ = !sink_->Write(json_string_->data(), json_string_->length());
+  json_string_->clear();
 }
 
 void JSONWriter::IndentLine(int depth) {
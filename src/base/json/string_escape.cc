@@ -6,8 +6,10 @@
 
 #include <string>
 
+#include "base/json/json_string_scan.h"
 #include "base/stringprintf.h"
 #include "base/string_util.h"
+#include "base/utf_string_conversion_utils.h"
 
 namespace base {
 
@@ -76,12 +78,77 @@ void JsonDoubleQuoteT(const STR& str,
     dst->push_back('"');
 }
 
+// Appends \uXXXX escape of UTF-16 code unit |unit| to |dst|.
+void AppendUnicodeEscape(uint32 unit, std::string* dst) {
+  static const char kHexDigits[] = "0123456789ABCDEF";
+  const char escape[] = {
+    '\\', 'u',
+    kHexDigits[(unit >> 12) & 0xF], kHexDigits[(unit >> 8) & 0xF],
+    kHexDigits[(unit >> 4) & 0xF], kHexDigits[unit & 0xF]
+  };
+  dst->append(escape, sizeof(escape));
+}
+
+// Byte oriented equivalent of JsonDoubleQuoteT. Runs of characters which need
+// no escaping are located with internal::FindJsonEscapeByte() and appended at
+// once. With |utf8| set, non-ASCII input is decoded and escaped as UTF-16 code
+// units, giving the same output as JsonDoubleQuote(UTF8ToUTF16(str)).
+void JsonDoubleQuoteBytes(const char* data,
+                          size_t length,
+                          bool utf8,
+                          bool put_in_quotes,
+                          std::string* dst) {
+  if (put_in_quotes)
+    dst->push_back('"');
+
+  size_t i = 0;
+  while (i < length) {
+    const size_t run = internal::FindJsonEscapeByte(data + i, length - i);
+    dst->append(data + i, run);
+    i += run;
+    if (i == length)
+      break;
+
+    const unsigned char c = static_cast<unsigned char>(data[i]);
+    if (utf8 && c >= 0x80) {
+      // Invalid sequences are replaced the same way UTF8ToUTF16() does.
+      int32 index = static_cast<int32>(i);
+      uint32 code_point;
+      if (!ReadUnicodeCharacter(data, static_cast<int32>(length), &index,
+                                &code_point)) {
+        code_point = 0xFFFD;
+      }
+      if (code_point > 0xFFFF) {
+        // Surrogate pair.
+        AppendUnicodeEscape((code_point >> 10) + 0xD7C0, dst);
+        AppendUnicodeEscape((code_point & 0x3FF) | 0xDC00, dst);
+      } else {
+        AppendUnicodeEscape(code_point, dst);
+      }
+      i = index + 1;
+    } else {
+      if (!JsonSingleEscapeChar(c, dst))
+        AppendUnicodeEscape(c, dst);
+      ++i;
+    }
+  }
+
+  if (put_in_quotes)
+    dst->push_back('"');
+}
+
 }  // namespace
 
 void JsonDoubleQuote(const std::string& str,
                      bool put_in_quotes,
                      std::string* dst) {
-  JsonDoubleQuoteT(str, put_in_quotes, dst);
+  JsonDoubleQuoteBytes(str.data(), str.length(), false, put_in_quotes, dst);
+}
+
+void JsonDoubleQuoteUTF8(const StringPiece& str,
+                         bool put_in_quotes,
+                         std::string* dst) {
+  JsonDoubleQuoteBytes(str.data(), str.length(), true, put_in_quotes, dst);
 }
 
 std::string GetDoubleQuotedJson(const std::string& str) {
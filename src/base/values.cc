@@ -137,6 +137,10 @@ bool Value::GetAsString(string16* out_value) const {
   return false;
 }
 
+bool Value::GetAsStringPiece(StringPiece* out_value) const {
+  return false;
+}
+
 bool Value::GetAsList(ListValue** out_value) {
   return false;
 }
@@ -289,6 +293,12 @@ bool StringValue::GetAsString(string16* out_value) const {
   return true;
 }
 
+bool StringValue::GetAsStringPiece(StringPiece* out_value) const {
+  if (out_value)
+    *out_value = value_;
+  return true;
+}
+
 StringValue* StringValue::DeepCopy() const {
   return CreateStringValue(value_);
 }
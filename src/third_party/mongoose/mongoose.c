@@ -411,6 +411,7 @@ enum {
   ENABLE_KEEP_ALIVE, ACCESS_CONTROL_LIST, MAX_REQUEST_SIZE,
   EXTRA_MIME_TYPES, LISTENING_PORTS,
   DOCUMENT_ROOT, SSL_CERTIFICATE, NUM_THREADS, RUN_AS_USER,
+  REQUEST_TIMEOUT,
   NUM_OPTIONS
 };
 
@@ -437,6 +438,7 @@ static const char *config_options[] = {
   "s", "ssl_certificate", NULL,
   "t", "num_threads", "10",
   "u", "run_as_user", NULL,
+  "T", "request_timeout_ms", NULL,
   NULL
 };
 #define ENTRIES_PER_CONFIG_OPTION 3
@@ -475,6 +477,8 @@ struct mg_connection {
   int buf_size;               // Buffer size
   int request_len;            // Size of the request + headers in a buffer
   int data_len;               // Total size of data in a buffer
+  int chunked;                // Request body has chunked transfer coding
+  int must_close;             // Unread body left on socket, do not reuse
 };
 
 const char **mg_get_valid_option_names(void) {
@@ -1408,6 +1412,12 @@ int mg_read(struct mg_connection *conn, void *buf, size_t len) {
   return nread;
 }
 
+void mg_end_chunked_body(struct mg_connection *conn) {
+  if (conn->chunked) {
+    conn->must_close = 0;
+  }
+}
+
 int mg_write(struct mg_connection *conn, const void *buf, size_t len) {
   return (int) push(NULL, conn->client.sock, conn->ssl,
       (const char *) buf, (int64_t) len);
@@ -3784,7 +3794,9 @@ static void reset_per_request_attributes(struct mg_connection *conn) {
 
   conn->num_bytes_sent = conn->consumed_content = 0;
   conn->content_len = -1;
-  conn->request_len = conn->data_len = 0;
+  conn->chunked = conn->must_close = 0;
+  // data_len is kept: buffer may already hold next pipelined request
+  conn->request_len = 0;
 }
 
 static void close_socket_gracefully(SOCKET sock) {
@@ -3914,13 +3926,14 @@ static int is_valid_uri(const char *uri) {
 
 static void process_new_connection(struct mg_connection *conn) {
   struct mg_request_info *ri = &conn->request_info;
-  int keep_alive_enabled;
-  const char *cl;
+  int keep_alive_enabled, keep_alive;
+  const char *cl, *te;
 
   keep_alive_enabled = !strcmp(conn->ctx->config[ENABLE_KEEP_ALIVE], "yes");
 
   do {
     reset_per_request_attributes(conn);
+    keep_alive = 0;
 
     // If next request is not pipelined, read it in
     if ((conn->request_len = get_request_len(conn->buf, conn->data_len)) == 0) {
@@ -3950,7 +3963,17 @@ static void process_new_connection(struct mg_connection *conn) {
     } else {
       // Request is valid, handle it
       cl = get_header(ri, "Content-Length");
-      conn->content_len = cl == NULL ? -1 : strtoll(cl, NULL, 10);
+      te = get_header(ri, "Transfer-Encoding");
+      if (cl == NULL && te != NULL && !mg_strcasecmp(te, "chunked")) {
+        // Body length is unknown up front; let user callback decode chunks
+        // via mg_read() and stop reading after the terminating chunk.
+        // Connection is reused only if callback reports body end with
+        // mg_end_chunked_body().
+        conn->content_len = INT64_MAX;
+        conn->chunked = conn->must_close = 1;
+      } else {
+        conn->content_len = cl == NULL ? -1 : strtoll(cl, NULL, 10);
+      }
       conn->birth_time = time(NULL);
       if (conn->client.is_proxy) {
         handle_proxy_request(conn);
@@ -3958,11 +3981,22 @@ static void process_new_connection(struct mg_connection *conn) {
         handle_request(conn);
       }
       log_access(conn);
+      if (conn->chunked) {
+        // Raw chunked stream read by callback is the body to discard
+        conn->content_len = conn->consumed_content;
+      } else if (conn->consumed_content < conn->content_len &&
+                 conn->content_len > conn->data_len - conn->request_len) {
+        // Body was not read (e.g. rejected as too large) and is not
+        // buffered completely: rest of it would be parsed as next request
+        conn->must_close = 1;
+      }
+      // Decide before discarding, request headers point into the buffer
+      keep_alive = keep_alive_enabled && should_keep_alive(conn) &&
+          !conn->must_close;
       discard_current_request_from_buffer(conn);
     }
     // conn->peer is not NULL only for SSL-ed proxy connections
-  } while (conn->ctx->stop_flag == 0 &&
-           (conn->peer || (keep_alive_enabled && should_keep_alive(conn))));
+  } while (conn->ctx->stop_flag == 0 && (conn->peer || keep_alive));
 }
 
 // Worker threads take accepted socket from the queue
@@ -3995,6 +4029,29 @@ static int consume_socket(struct mg_context *ctx, struct socket *sp) {
   return !ctx->stop_flag;
 }
 
+// Apply "request_timeout_ms" to the accepted socket, so a stalled peer makes
+// recv()/send() fail instead of blocking the worker forever.
+static void set_socket_timeout(SOCKET sock, const char *timeout_ms) {
+  int ms;
+#if defined(_WIN32)
+  DWORD tv;
+#else
+  struct timeval tv;
+#endif
+
+  if (timeout_ms == NULL || (ms = atoi(timeout_ms)) <= 0) {
+    return;
+  }
+#if defined(_WIN32)
+  tv = (DWORD) ms;
+#else
+  tv.tv_sec = ms / 1000;
+  tv.tv_usec = (ms % 1000) * 1000;
+#endif
+  (void) setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (void *) &tv, sizeof(tv));
+  (void) setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (void *) &tv, sizeof(tv));
+}
+
 static void worker_thread(struct mg_context *ctx) {
   struct mg_connection *conn;
   int buf_size = atoi(ctx->config[MAX_REQUEST_SIZE]);
@@ -4009,6 +4066,7 @@ static void worker_thread(struct mg_context *ctx) {
   while (consume_socket(ctx, &conn->client)) {
     conn->birth_time = time(NULL);
     conn->ctx = ctx;
+    conn->data_len = 0;
 
     // Fill in IP, port info early so even if SSL setup below fails,
     // error handler would have the corresponding info.
@@ -4019,6 +4077,8 @@ static void worker_thread(struct mg_context *ctx) {
     conn->request_info.remote_ip = ntohl(conn->request_info.remote_ip);
     conn->request_info.is_ssl = conn->client.is_ssl;
 
+    set_socket_timeout(conn->client.sock, ctx->config[REQUEST_TIMEOUT]);
+
     if (!conn->client.is_ssl ||
         (conn->client.is_ssl && sslize(conn, SSL_accept))) {
       process_new_connection(conn);
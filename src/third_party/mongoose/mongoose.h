@@ -171,6 +171,13 @@ void mg_send_file(struct mg_connection *conn, const char *path);
 int mg_read(struct mg_connection *, void *buf, size_t len);
 
 
+// Tell that body with chunked transfer coding was read by mg_read() up to
+// its terminating chunk and trailer, so connection may serve next request.
+// Otherwise connection is closed after reply, as the rest of the body
+// could not be told apart from the next request.
+void mg_end_chunked_body(struct mg_connection *);
+
+
 // Get the value of particular HTTP header.
 //
 // This is a helper function. It traverses request_info->http_headers array,
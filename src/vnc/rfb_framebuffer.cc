@@ -0,0 +1,477 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#include "vnc/rfb_framebuffer.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#if (1 == WD_ENABLE_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace {
+
+// ServerToClient message types
+const uint8 kFramebufferUpdateMsg = 0;
+const uint8 kSetColourMapEntriesMsg = 1;
+const uint8 kBellMsg = 2;
+const uint8 kServerCutTextMsg = 3;
+
+const int kRectHeaderSize = 12;
+const int kBytesPerPixel = 4;
+// ZRLE compressed pixel: 3 least significant bytes of 32 bit pixel
+const int kBytesPerCPixel = 3;
+const int kZRLETileSize = 64;
+// protects from overflow on corrupted length fields
+const int64 kMaxMessageSize = 256 * 1024 * 1024;
+
+inline uint16 readU16(const uint8* p)
+{
+    return (uint16)((p[0] << 8) | p[1]);
+}
+
+inline uint32 readU32(const uint8* p)
+{
+    return ((uint32)p[0] << 24) | ((uint32)p[1] << 16) | ((uint32)p[2] << 8) | p[3];
+}
+
+// pixel is little endian, red/green/blue in bytes 2/1/0
+inline uint32 readPixel(const uint8* p)
+{
+    return (uint32)p[0] | ((uint32)p[1] << 8) | ((uint32)p[2] << 16);
+}
+
+// Reads ZRLE run length: sum of bytes up to first one which is not 255, plus one.
+bool readRunLength(const uint8** pos, const uint8* end, int max, int* length)
+{
+    const uint8* p = *pos;
+    int run = 1;
+    uint8 b;
+    do {
+        if (p >= end)
+            return false;
+        b = *p++;
+        run += b;
+        if (run > max)
+            return false;
+    } while (255 == b);
+
+    *pos = p;
+    *length = run;
+    return true;
+}
+
+}  // namespace
+
+const int64 RfbFramebuffer::kMaxPixels = kMaxMessageSize / kBytesPerPixel;
+
+struct RfbFramebuffer::Inflater {
+#if (1 == WD_ENABLE_ZLIB)
+    Inflater() : initialized(false) {
+        memset(&stream, 0, sizeof(stream));
+    }
+
+    ~Inflater() {
+        if (initialized)
+            inflateEnd(&stream);
+    }
+
+    z_stream stream;
+    bool initialized;
+#endif
+};
+
+RfbFramebuffer::RfbFramebuffer()
+    : _width(0),
+      _height(0),
+      _rectsLeft(0),
+      _inflater(new Inflater())
+{
+}
+
+RfbFramebuffer::~RfbFramebuffer()
+{
+}
+
+bool RfbFramebuffer::isZRLESupported()
+{
+#if (1 == WD_ENABLE_ZLIB)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool RfbFramebuffer::reset(int width, int height)
+{
+    _rectsLeft = 0;
+    _inflater.reset(new Inflater());
+
+    if (width < 0 || height < 0 || (int64)width * height > kMaxPixels)
+    {
+        _width = 0;
+        _height = 0;
+        _pixels.clear();
+        return false;
+    }
+
+    _width = width;
+    _height = height;
+    _pixels.assign((size_t)width * height, 0);
+    return true;
+}
+
+const uint32* RfbFramebuffer::pixels() const
+{
+    return _pixels.empty() ? NULL : &_pixels[0];
+}
+
+int RfbFramebuffer::processServerMessages(const uint8* data, int size, int* updates)
+{
+    int pos = 0;
+
+    while (pos < size)
+    {
+        const uint8* p = data + pos;
+        const int left = size - pos;
+
+        if (0 == _rectsLeft)
+        {
+            int64 length;
+            switch (p[0])
+            {
+                case kFramebufferUpdateMsg:
+                    if (left < 4)
+                        return pos;
+                    _rectsLeft = readU16(p + 2);
+                    if (0 == _rectsLeft)
+                        ++*updates;
+                    length = 4;
+                    break;
+                case kSetColourMapEntriesMsg:
+                    // not used with true colour pixel format, skip
+                    if (left < 6)
+                        return pos;
+                    length = 6 + 6 * (int64)readU16(p + 4);
+                    break;
+                case kBellMsg:
+                    length = 1;
+                    break;
+                case kServerCutTextMsg:
+                    if (left < 8)
+                        return pos;
+                    length = 8 + (int64)readU32(p + 4);
+                    break;
+                default:
+                    return -1;
+            }
+            if (length > kMaxMessageSize)
+                return -1;
+            if (left < length)
+                return pos;
+            pos += (int)length;
+            continue;
+        }
+
+        // rectangle of FramebufferUpdate
+        if (left < kRectHeaderSize)
+            return pos;
+
+        const int x = readU16(p);
+        const int y = readU16(p + 2);
+        const int w = readU16(p + 4);
+        const int h = readU16(p + 6);
+        const int encoding = (int)(int32)readU32(p + 8);
+
+        // check size before payload is awaited, so bogus header doesn't
+        // make us buffer or allocate for pixels which can't be stored
+        if (DesktopSizeEncoding == encoding)
+        {
+            if ((int64)w * h > kMaxPixels)
+                return -1;
+        }
+        else if (x + w > _width || y + h > _height)
+        {
+            return -1;
+        }
+
+        int64 payload;
+        switch (encoding)
+        {
+            case RawEncoding:
+                payload = (int64)w * h * kBytesPerPixel;
+                break;
+            case CopyRectEncoding:
+                payload = 4;
+                break;
+            case ZRLEEncoding:
+                if (!isZRLESupported())
+                    return -1;
+                if (left < kRectHeaderSize + 4)
+                    return pos;
+                payload = 4 + (int64)readU32(p + kRectHeaderSize);
+                break;
+            case DesktopSizeEncoding:
+                payload = 0;
+                break;
+            default:
+                return -1;
+        }
+        if (payload > kMaxMessageSize)
+            return -1;
+        if (left - kRectHeaderSize < payload)
+            return pos;
+
+        if (DesktopSizeEncoding == encoding)
+        {
+            // content is resent by server, zlib stream continues
+            _width = w;
+            _height = h;
+            _pixels.assign((size_t)w * h, 0);
+        }
+        else if (!decodeRect(encoding, x, y, w, h, p + kRectHeaderSize, (int)payload))
+        {
+            return -1;
+        }
+
+        pos += kRectHeaderSize + (int)payload;
+        if (0 == --_rectsLeft)
+            ++*updates;
+    }
+
+    return pos;
+}
+
+bool RfbFramebuffer::decodeRect(int encoding, int x, int y, int w, int h, const uint8* data, int size)
+{
+    if (0 == w || 0 == h)
+        return true;
+
+    switch (encoding)
+    {
+        case RawEncoding: return decodeRaw(x, y, w, h, data);
+        case CopyRectEncoding: return decodeCopyRect(x, y, w, h, data);
+        case ZRLEEncoding: return decodeZRLE(x, y, w, h, data, size);
+        default: return false;
+    }
+}
+
+bool RfbFramebuffer::decodeRaw(int x, int y, int w, int h, const uint8* data)
+{
+    for (int row = 0; row < h; ++row)
+    {
+        uint32* dst = &_pixels[(size_t)(y + row) * _width + x];
+        for (int col = 0; col < w; ++col, data += kBytesPerPixel)
+            dst[col] = readPixel(data);
+    }
+    return true;
+}
+
+bool RfbFramebuffer::decodeCopyRect(int x, int y, int w, int h, const uint8* data)
+{
+    const int srcX = readU16(data);
+    const int srcY = readU16(data + 2);
+    if (srcX + w > _width || srcY + h > _height)
+        return false;
+
+    // source and destination may overlap, go in direction which doesn't
+    // overwrite rows before they are copied
+    const bool down = srcY < y;
+    for (int i = 0; i < h; ++i)
+    {
+        const int row = down ? h - 1 - i : i;
+        memmove(&_pixels[(size_t)(y + row) * _width + x],
+                &_pixels[(size_t)(srcY + row) * _width + srcX],
+                w * sizeof(uint32));
+    }
+    return true;
+}
+
+bool RfbFramebuffer::decodeZRLE(int x, int y, int w, int h, const uint8* data, int size)
+{
+#if (1 == WD_ENABLE_ZLIB)
+    z_stream* stream = &_inflater->stream;
+    if (!_inflater->initialized)
+    {
+        if (Z_OK != inflateInit(stream))
+            return false;
+        _inflater->initialized = true;
+    }
+
+    const size_t kChunk = 64 * 1024;
+    _inflated.clear();
+    stream->next_in = const_cast<Bytef*>(data + 4);
+    stream->avail_in = size - 4;
+    do
+    {
+        const size_t used = _inflated.size();
+        _inflated.resize(used + kChunk);
+        stream->next_out = &_inflated[used];
+        stream->avail_out = kChunk;
+        const int ret = inflate(stream, Z_SYNC_FLUSH);
+        _inflated.resize(used + kChunk - stream->avail_out);
+        if (Z_BUF_ERROR == ret)
+            break;
+        if (Z_OK != ret)
+            return false;
+    } while (stream->avail_in > 0 || 0 == stream->avail_out);
+
+    if (_inflated.empty())
+        return false;
+
+    const uint8* pos = &_inflated[0];
+    const uint8* end = pos + _inflated.size();
+    for (int ty = y; ty < y + h; ty += kZRLETileSize)
+    {
+        const int th = std::min(kZRLETileSize, y + h - ty);
+        for (int tx = x; tx < x + w; tx += kZRLETileSize)
+        {
+            const int tw = std::min(kZRLETileSize, x + w - tx);
+            if (!decodeZRLETile(tx, ty, tw, th, &pos, end))
+                return false;
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool RfbFramebuffer::decodeZRLETile(int x, int y, int w, int h, const uint8** pos, const uint8* end)
+{
+    const uint8* p = *pos;
+    const int count = w * h;
+
+    if (p >= end)
+        return false;
+    const int subencoding = *p++;
+
+    if (0 == subencoding)
+    {
+        // raw pixels
+        if (end - p < count * kBytesPerCPixel)
+            return false;
+        for (int row = 0; row < h; ++row)
+        {
+            uint32* dst = &_pixels[(size_t)(y + row) * _width + x];
+            for (int col = 0; col < w; ++col, p += kBytesPerCPixel)
+                dst[col] = readPixel(p);
+        }
+    }
+    else if (1 == subencoding)
+    {
+        // solid tile
+        if (end - p < kBytesPerCPixel)
+            return false;
+        fillRect(x, y, w, h, readPixel(p));
+        p += kBytesPerCPixel;
+    }
+    else if (subencoding <= 16)
+    {
+        // packed palette indexes, rows are padded to byte
+        const int paletteSize = subencoding;
+        if (end - p < paletteSize * kBytesPerCPixel)
+            return false;
+        uint32 palette[16];
+        for (int i = 0; i < paletteSize; ++i, p += kBytesPerCPixel)
+            palette[i] = readPixel(p);
+
+        const int bits = (2 == paletteSize) ? 1 : ((paletteSize <= 4) ? 2 : 4);
+        const int rowBytes = (w * bits + 7) / 8;
+        if (end - p < rowBytes * h)
+            return false;
+        for (int row = 0; row < h; ++row, p += rowBytes)
+        {
+            uint32* dst = &_pixels[(size_t)(y + row) * _width + x];
+            for (int col = 0; col < w; ++col)
+            {
+                const int bit = col * bits;
+                const int index = (p[bit / 8] >> (8 - bits - bit % 8)) & ((1 << bits) - 1);
+                if (index >= paletteSize)
+                    return false;
+                dst[col] = palette[index];
+            }
+        }
+    }
+    else if (128 == subencoding)
+    {
+        // plain RLE
+        int i = 0;
+        while (i < count)
+        {
+            if (end - p < kBytesPerCPixel)
+                return false;
+            const uint32 pixel = readPixel(p);
+            p += kBytesPerCPixel;
+            int run;
+            if (!readRunLength(&p, end, count - i, &run))
+                return false;
+            for (int j = i + run; i < j; ++i)
+                _pixels[(size_t)(y + i / w) * _width + x + i % w] = pixel;
+        }
+    }
+    else if (subencoding >= 130)
+    {
+        // palette RLE
+        const int paletteSize = subencoding - 128;
+        if (end - p < paletteSize * kBytesPerCPixel)
+            return false;
+        uint32 palette[127];
+        for (int i = 0; i < paletteSize; ++i, p += kBytesPerCPixel)
+            palette[i] = readPixel(p);
+
+        int i = 0;
+        while (i < count)
+        {
+            if (p >= end)
+                return false;
+            int index = *p++;
+            int run = 1;
+            if (index & 0x80)
+            {
+                index &= 0x7f;
+                if (!readRunLength(&p, end, count - i, &run))
+                    return false;
+            }
+            if (index >= paletteSize)
+                return false;
+            for (int j = i + run; i < j; ++i)
+                _pixels[(size_t)(y + i / w) * _width + x + i % w] = palette[index];
+        }
+    }
+    else
+    {
+        // 17..127 and 129 are not used
+        return false;
+    }
+
+    *pos = p;
+    return true;
+}
+
+void RfbFramebuffer::fillRect(int x, int y, int w, int h, uint32 pixel)
+{
+    for (int row = 0; row < h; ++row)
+    {
+        uint32* dst = &_pixels[(size_t)(y + row) * _width + x];
+        std::fill(dst, dst + w, pixel);
+    }
+}
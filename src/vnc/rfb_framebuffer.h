@@ -0,0 +1,109 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef VNC_RFB_FRAMEBUFFER_H
+#define VNC_RFB_FRAMEBUFFER_H
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+
+/**
+  RfbFramebuffer - copy of remote VNC framebuffer maintained from
+  server-to-client RFB messages. It expects pixel format set by client
+  with SetPixelFormat: 32 bits per pixel, depth 24, little endian,
+  true colour, red/green/blue shifts 16/8/0. So each pixel is 0x00RRGGBB,
+  same as QImage::Format_RGB32.
+  Only rectangles sent by server (damaged areas) are decoded.
+*/
+class RfbFramebuffer
+{
+public:
+    /**
+      Supported rectangle encodings
+     */
+    enum Encoding {
+        RawEncoding = 0,
+        CopyRectEncoding = 1,
+        ZRLEEncoding = 16,
+        DesktopSizeEncoding = -223
+    };
+
+    /**
+      Largest framebuffer accepted from server, 64M pixels (256MB)
+    */
+    static const int64 kMaxPixels;
+
+    RfbFramebuffer();
+    ~RfbFramebuffer();
+
+    /**
+      @return true if ZRLE encoding can be decoded (built with zlib)
+    */
+    static bool isZRLESupported();
+
+    /**
+      Resizes framebuffer and resets decoder state
+      @param width - framebuffer width
+      @param height - framebuffer height
+      @return false if size exceeds kMaxPixels, framebuffer is left empty
+    */
+    bool reset(int width, int height);
+
+    /**
+      Consumes complete server messages from data, incomplete tail is left.
+      @param data - received bytes, starting at message boundary
+      @param size - number of bytes in data
+      @param [out] updates - incremented for every finished FramebufferUpdate
+      @return number of consumed bytes, -1 on protocol error
+    */
+    int processServerMessages(const uint8* data, int size, int* updates);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+    /**
+      @return row-major 0x00RRGGBB pixels, width()*height() items
+    */
+    const uint32* pixels() const;
+
+private:
+    bool decodeRect(int encoding, int x, int y, int w, int h, const uint8* data, int size);
+    bool decodeRaw(int x, int y, int w, int h, const uint8* data);
+    bool decodeCopyRect(int x, int y, int w, int h, const uint8* data);
+    bool decodeZRLE(int x, int y, int w, int h, const uint8* data, int size);
+    bool decodeZRLETile(int x, int y, int w, int h, const uint8** pos, const uint8* end);
+    void fillRect(int x, int y, int w, int h, uint32 pixel);
+
+    struct Inflater;
+
+    int _width;
+    int _height;
+    std::vector<uint32> _pixels;
+    // rectangles left in FramebufferUpdate being processed
+    int _rectsLeft;
+    // ZRLE uses single zlib stream for whole connection
+    scoped_ptr<Inflater> _inflater;
+    std::vector<uint8> _inflated;
+
+    DISALLOW_COPY_AND_ASSIGN(RfbFramebuffer);
+};
+
+#endif // VNC_RFB_FRAMEBUFFER_H
@@ -19,19 +19,87 @@
 
 #include "extension_qt/vncclient.h"
 #include "third_party/des/d3des.h"
+#include "vnc/rfb_framebuffer.h"
 
 #include <QtNetwork/QHostAddress>
+#include <QtCore/QEventLoop>
 #include <QtCore/QMap>
 #include <QtCore/QRegExp>
 #include <QtCore/QStringList>
+#include <QtCore/QTimer>
 
 #define MAJOR_INDEX 6
 #define MINOR_INDEX 10
 
+// Sizes of RFB client to server messages
+#define KEY_EVENT_MSG_SIZE 8
+#define POINTER_EVENT_MSG_SIZE 6
+#define SET_PIXEL_FORMAT_MSG_SIZE 20
+#define UPDATE_REQUEST_MSG_SIZE 10
+
+// Server answers incremental update request only when something changed,
+// so grab waits for such answer only this long
+#define FRESH_UPDATE_WAIT_MS 100
+
 using namespace webdriver;
 
 VNCClient* VNCClient::_instance = NULL;
 
+static void fillKeyEventMsg(char *msg, bool down, quint32 keysym)
+{
+    msg[0] = (char)VNCClient::KeyEvent;
+    msg[1] = down ? 0x01 : 0x00;
+    msg[2] = 0x00;  // padding
+    msg[3] = 0x00;
+    msg[4] = (char)((keysym >> 24) & 0xff);
+    msg[5] = (char)((keysym >> 16) & 0xff);
+    msg[6] = (char)((keysym >> 8) & 0xff);
+    msg[7] = (char)(keysym & 0xff);
+}
+
+static void fillPointerEventMsg(char *msg, quint8 buttonMask, quint16 x, quint16 y)
+{
+    msg[0] = (char)VNCClient::PointerEvent;
+    msg[1] = (char)buttonMask;
+    msg[2] = (char)(x >> 8);
+    msg[3] = (char)(x & 0xff);
+    msg[4] = (char)(y >> 8);
+    msg[5] = (char)(y & 0xff);
+}
+
+static void putU16(char *msg, quint16 value)
+{
+    msg[0] = (char)(value >> 8);
+    msg[1] = (char)(value & 0xff);
+}
+
+static void putS32(char *msg, qint32 value)
+{
+    quint32 v = (quint32)value;
+    msg[0] = (char)((v >> 24) & 0xff);
+    msg[1] = (char)((v >> 16) & 0xff);
+    msg[2] = (char)((v >> 8) & 0xff);
+    msg[3] = (char)(v & 0xff);
+}
+
+static quint8 buttonToMask(Qt::MouseButton button)
+{
+    switch(button)
+    {
+        case Qt::LeftButton: return 0x01;
+        case Qt::MidButton: return 0x02;
+        case Qt::RightButton: return 0x04;
+        default: return 0x00;
+    }
+}
+
+static quint8 buttonsToMask(Qt::MouseButtons buttons)
+{
+    return (buttons & Qt::LeftButton ? 0x01 : 0x00) |
+           (buttons & Qt::MidButton ? 0x02 : 0x00) |
+           (buttons & Qt::RightButton ? 0x04 : 0x00);
+}
+
 static QMap<quint32, quint16> initializeMap()
 {
     QMap<quint32, quint16> resultMap;
@@ -88,6 +156,11 @@ VNCClient::VNCClient()
       _establishedVersion(38),
       _establishedSecurity(Invalid),
       _serverParameters(NULL),
+      _batchDepth(0),
+      _framebuffer(new RfbFramebuffer()),
+      _framebufferRequested(false),
+      _framebufferFailed(false),
+      _framebufferUpdates(0),
       _password(NULL)
 {
     _logger = StdOutLog::Get();
@@ -96,6 +169,7 @@ VNCClient::VNCClient()
 VNCClient::~VNCClient()
 {
     delete _serverParameters;
+    delete _framebuffer;
     delete _password;
 }
 
@@ -129,6 +203,8 @@ bool VNCClient::Init(QString remoteHost, quint16 port)
 
     _socket->connectToHost(addr, port);
     _socket->waitForConnected();
+    // input events are small messages which should go out immediately
+    _socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
 
     return _socket->isOpen();
 }
@@ -154,6 +230,8 @@ bool VNCClient::Init(QString remoteHost, quint16 port, QString* password)
 
     _socket->connectToHost(addr, port);
     _socket->waitForConnected();
+    // input events are small messages which should go out immediately
+    _socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
 
     return _socket->isOpen();
 }
@@ -162,10 +240,7 @@ QByteArray VNCClient::readSocket()
 {
     QByteArray data = _socket->readAll();
 
-    _logger->Log(kInfoLogLevel, base::Time::Now(), std::string("#### Read from socket: ") + std::string(data.data()));
-    for (int i=0; i<data.size(); i++)
-        _logger->Log(kInfoLogLevel, base::Time::Now(), QString(data.at(i)).toStdString());
-    _logger->Log(kInfoLogLevel, base::Time::Now(), "\n");
+    traceBytes("Read from socket: ", data);
 
     if (!_versionEstablished)
     {
@@ -197,6 +272,11 @@ QByteArray VNCClient::readSocket()
     if (NULL == _serverParameters)
     {
         initServerParameters(data);
+        return data;
+    }
+    if (_framebufferRequested && !_framebufferFailed)
+    {
+        processFramebufferData(data);
     }
 
     return data;
@@ -503,9 +583,10 @@ bool VNCClient::initServerParameters(QByteArray &data)
     if (NULL == _serverParameters)
         _serverParameters = new ServerParameters();
 
-    qint16 width = data.at(0)*0x100 + data.at(1);
+    const uchar *init = (const uchar*)data.constData();
+    quint16 width = init[0]*0x100 + init[1];
     _serverParameters->setWidth(width);
-    qint16 height = data.at(2)*0x100 + data.at(3);
+    quint16 height = init[2]*0x100 + init[3];
     _serverParameters->setHeight(height);
 
     ServerParameters::PIXEL_FORMAT *pixels = new ServerParameters::PIXEL_FORMAT();
@@ -534,166 +615,234 @@ void VNCClient::handleZeroError(QByteArray& data)
 
 void VNCClient::sendKeyEvent(QKeyEvent *key)
 {
-    QByteArray keyMsg;
+    char msg[KEY_EVENT_MSG_SIZE];
+    fillKeyEventMsg(msg, QKeyEvent::KeyPress == key->type(), convertQtKeyToX11Key(key));
 
-    keyMsg.insert(0, (char)KeyEvent); // set message type
+    queueMessage(msg, sizeof(msg));
+}
 
-    if (QKeyEvent::KeyPress == key->type())
-    {
-        keyMsg.insert(1, (char)0x01);
-    }
-    if (QKeyEvent::KeyRelease == key->type())
+void VNCClient::sendMouseEvent(QMouseEvent *mouse)
+{
+    QEvent::Type type = mouse->type();
+
+    if (QEvent::MouseButtonDblClick == type)
     {
-        keyMsg.insert(1, (char)0x00);
+        sendDoubleClick(mouse);
+        return;
     }
 
-    keyMsg.insert(2, (char)0x00);
-    keyMsg.insert(3, (char)0x00);
+    // server keeps no button state, every message carries all held buttons,
+    // so moves with held button drag
+    quint8 mouseBtn = buttonsToMask(mouse->buttons());
+    if (QEvent::MouseButtonPress == type)
+        mouseBtn |= buttonToMask(mouse->button());
+    else if (QEvent::MouseButtonRelease == type)
+        mouseBtn &= ~buttonToMask(mouse->button());
 
-    quint32 keyValue = convertQtKeyToX11Key(key);
-    char value[4];
-    value[0] = (char)((keyValue&0xff000000)>>24);
-    value[1] = (char)((keyValue&0x00ff0000)>>16);
-    value[2] = (char)((keyValue&0x0000ff00)>>8);
-    value[3] = (char)(keyValue&0x000000ff);
-    keyMsg.insert(4, value[0]);
-    keyMsg.insert(5, value[1]);
-    keyMsg.insert(6, value[2]);
-    keyMsg.insert(7, value[3]);
+    // server expects screen coordinates
+    char msg[POINTER_EVENT_MSG_SIZE];
+    fillPointerEventMsg(msg, mouseBtn, mouse->globalX(), mouse->globalY());
 
-    _logger->Log(kInfoLogLevel, base::Time::Now(), "Send key message: ");
-    for (int i=0; i<keyMsg.size(); i++)
-    {
-        _logger->Log(kInfoLogLevel, base::Time::Now(), QString(keyMsg.at(i)).toStdString());
-    }
-    _logger->Log(kInfoLogLevel, base::Time::Now(), "\n");
+    queueMessage(msg, sizeof(msg));
+}
 
-    writeToSocket(keyMsg);
+void VNCClient::sendDoubleClick(QMouseEvent *event)
+{
+    quint8 mouseBtn = buttonToMask(event->button());
+    quint16 x = event->globalX();
+    quint16 y = event->globalY();
+
+    // press, release, press, release
+    char msg[4 * POINTER_EVENT_MSG_SIZE];
+    for (int i = 0; i < 4; ++i)
+        fillPointerEventMsg(msg + i * POINTER_EVENT_MSG_SIZE, (i % 2) ? 0x00 : mouseBtn, x, y);
+
+    queueMessage(msg, sizeof(msg));
 }
 
-void VNCClient::sendMouseEvent(QMouseEvent *mouse)
+void VNCClient::beginBatch()
 {
-    QByteArray mouseMsg;
-    quint8 mouseBtn = 0x00;
-    QEvent::Type type = mouse->type();
+    ++_batchDepth;
+}
 
-    if (QEvent::MouseButtonPress == type)
-    {
-        switch(mouse->button())
-        {
-            case Qt::NoButton: break;
-            case Qt::LeftButton: mouseBtn = mouseBtn | 0x01; break;
-            case Qt::RightButton: mouseBtn = mouseBtn | 0x04; break;
-            case Qt::MidButton: mouseBtn = mouseBtn | 0x02; break;
-            default: break;
-        }
-    }
-    else if (QEvent::MouseButtonRelease == type)
-    {
-        switch(mouse->button())
-        {
-            case Qt::NoButton: break;
-            case Qt::LeftButton: mouseBtn = mouseBtn & 0xfe; break;
-            case Qt::RightButton: mouseBtn = mouseBtn & 0xfb; break;
-            case Qt::MidButton: mouseBtn = mouseBtn & 0xfd; break;
-            default: break;
-        }
-    }
-    else if (QEvent::MouseButtonDblClick == type)
-    {
-        sendDoubleClick(mouse);
+void VNCClient::endBatch()
+{
+    if (0 == _batchDepth)
         return;
-    }
 
-    mouseMsg.insert(0, (char)PointerEvent); // set message type
-    mouseMsg.insert(1, (char)mouseBtn);
+    if (0 == --_batchDepth)
+        flushMessages();
+}
 
-    quint16 x = mouse->x();
-    quint16 y = mouse->y();
+void VNCClient::queueMessage(const char *msg, int size)
+{
+    _outgoing.append(msg, size);
 
-    char item = (char)(x>>8);
-    mouseMsg.insert(2, item);
-    item = (char)(x & 0x00ff);
-    mouseMsg.insert(3, item);
-    item = (char)(y>>8);
-    mouseMsg.insert(4, item);
-    item = (char)(y & 0x00ff);
-    mouseMsg.insert(5, item);
+    if (0 == _batchDepth)
+        flushMessages();
+}
 
-    writeToSocket(mouseMsg);
+void VNCClient::flushMessages()
+{
+    if (_outgoing.isEmpty())
+        return;
+
+    traceBytes("Send messages: ", _outgoing);
+    writeToSocket(_outgoing);
+    _outgoing.clear();
 }
 
-void VNCClient::sendDoubleClick(QMouseEvent *event)
+void VNCClient::traceBytes(const std::string& prefix, const QByteArray& data)
 {
-    QByteArray mouseMsg;
-    quint8 mouseBtn = 0x00;
+    // raw protocol dump is useful only for debugging, don't format it otherwise
+    if (NULL == _logger || _logger->min_log_level() > kFineLogLevel)
+        return;
 
-    switch(event->button())
-    {
-        case Qt::NoButton: break;
-        case Qt::LeftButton: mouseBtn = mouseBtn | 0x01; break;
-        case Qt::RightButton: mouseBtn = mouseBtn | 0x04; break;
-        case Qt::MidButton: mouseBtn = mouseBtn | 0x02; break;
-        default: break;
-    }
+    _logger->Log(kFineLogLevel, base::Time::Now(), prefix + std::string(data.toHex().constData()));
+}
 
-    mouseMsg.insert(0, (char)PointerEvent); // set message type
-    mouseMsg.insert(1, (char)mouseBtn);
+bool VNCClient::isReady()
+{
+    return _isReady;
+}
 
-    quint16 x = event->globalX();
-    quint16 y = event->globalY();
+bool VNCClient::grabFramebuffer(const QRect &rect, QImage *image, int timeoutMs)
+{
+    if (!_isReady || _framebufferFailed || NULL == _serverParameters)
+        return false;
 
-    char item = (char)(x>>8);
-    mouseMsg.insert(2, item);
-    item = (char)(x & 0x00ff);
-    mouseMsg.insert(3, item);
-    item = (char)(y>>8);
-    mouseMsg.insert(4, item);
-    item = (char)(y & 0x00ff);
-    mouseMsg.insert(5, item);
+    if (!_framebufferRequested)
+        startFramebufferUpdates();
+    if (_framebufferFailed)
+        return false;
 
-    writeToSocket(mouseMsg);
+    // apply updates which are already received
+    if (_socket->bytesAvailable() > 0)
+        readSocket();
 
-    switch(event->button())
+    if (0 == _framebufferUpdates)
     {
-        case Qt::NoButton: break;
-        case Qt::LeftButton: mouseBtn = mouseBtn & 0xfe; break;
-        case Qt::RightButton: mouseBtn = mouseBtn & 0xfb; break;
-        case Qt::MidButton: mouseBtn = mouseBtn & 0xfd; break;
-        default: break;
+        waitForFramebufferUpdate(timeoutMs);
     }
-
-    mouseMsg.insert(1, mouseBtn);
-    writeToSocket(mouseMsg);
-
-    switch(event->button())
+    else
     {
-        case Qt::NoButton: break;
-        case Qt::LeftButton: mouseBtn = mouseBtn | 0x01; break;
-        case Qt::RightButton: mouseBtn = mouseBtn | 0x04; break;
-        case Qt::MidButton: mouseBtn = mouseBtn | 0x02; break;
-        default: break;
+        // outstanding request may be answered already, ask for damage
+        // made since then and give server a moment to send it
+        requestFramebufferUpdate(true);
+        waitForFramebufferUpdate(qMin(timeoutMs, FRESH_UPDATE_WAIT_MS));
     }
 
-    mouseMsg.insert(1, mouseBtn);
-    writeToSocket(mouseMsg);
+    if (0 == _framebufferUpdates || _framebufferFailed)
+        return false;
+
+    QImage frame((const uchar*)_framebuffer->pixels(),
+                 _framebuffer->width(), _framebuffer->height(),
+                 _framebuffer->width() * 4, QImage::Format_RGB32);
+    QRect area = rect.isNull() ? frame.rect() : rect.intersected(frame.rect());
+    if (area.isEmpty())
+        return false;
+
+    // detach from framebuffer memory, it is modified by next update
+    *image = frame.copy(area);
+
+    return true;
+}
+
+void VNCClient::waitForFramebufferUpdate(int timeoutMs)
+{
+    QEventLoop loop;
+    QTimer timer;
+    timer.setSingleShot(true);
+    QObject::connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+    QObject::connect(this, SIGNAL(framebufferUpdated()), &loop, SLOT(quit()));
+    timer.start(timeoutMs);
+    loop.exec();
+}
+
+void VNCClient::startFramebufferUpdates()
+{
+    _inBuffer.clear();
+    _framebufferUpdates = 0;
+    _framebufferRequested = true;
 
-    switch(event->button())
+    if (!_framebuffer->reset(_serverParameters->getWidth(), _serverParameters->getHeight()))
     {
-        case Qt::NoButton: break;
-        case Qt::LeftButton: mouseBtn = mouseBtn & 0xfe; break;
-        case Qt::RightButton: mouseBtn = mouseBtn & 0xfb; break;
-        case Qt::MidButton: mouseBtn = mouseBtn & 0xfd; break;
-        default: break;
+        _logger->Log(kWarningLogLevel, base::Time::Now(), "Server framebuffer is too large, framebuffer updates are not used");
+        _framebufferFailed = true;
+        return;
     }
 
-    mouseMsg.insert(1, mouseBtn);
-    writeToSocket(mouseMsg);
+    // 32bpp, depth 24, little endian, true colour, 0x00RRGGBB
+    char format[SET_PIXEL_FORMAT_MSG_SIZE] = {0};
+    format[0] = (char)SetPixelFormat;
+    format[4] = 32;
+    format[5] = 24;
+    format[6] = 0;
+    format[7] = 1;
+    putU16(format + 8, 255);
+    putU16(format + 10, 255);
+    putU16(format + 12, 255);
+    format[14] = 16;
+    format[15] = 8;
+    format[16] = 0;
+
+    QList<qint32> encodings;
+    if (RfbFramebuffer::isZRLESupported())
+        encodings.append(RfbFramebuffer::ZRLEEncoding);
+    encodings.append(RfbFramebuffer::CopyRectEncoding);
+    encodings.append(RfbFramebuffer::RawEncoding);
+    encodings.append(RfbFramebuffer::DesktopSizeEncoding);
+
+    QByteArray setEncodings(4 + 4 * encodings.size(), 0);
+    setEncodings[0] = (char)SetEncodings;
+    putU16(setEncodings.data() + 2, encodings.size());
+    for (int i = 0; i < encodings.size(); ++i)
+        putS32(setEncodings.data() + 4 + 4 * i, encodings[i]);
+
+    beginBatch();
+    queueMessage(format, sizeof(format));
+    queueMessage(setEncodings.constData(), setEncodings.size());
+    requestFramebufferUpdate(false);
+    endBatch();
 }
 
-bool VNCClient::isReady()
+void VNCClient::requestFramebufferUpdate(bool incremental)
 {
-    return _isReady;
+    char msg[UPDATE_REQUEST_MSG_SIZE];
+    msg[0] = (char)FramebufferUpdateRequest;
+    msg[1] = incremental ? 0x01 : 0x00;
+    putU16(msg + 2, 0);
+    putU16(msg + 4, 0);
+    putU16(msg + 6, _framebuffer->width());
+    putU16(msg + 8, _framebuffer->height());
+
+    queueMessage(msg, sizeof(msg));
+}
+
+void VNCClient::processFramebufferData(const QByteArray &data)
+{
+    _inBuffer.append(data);
+
+    int updates = 0;
+    int consumed = _framebuffer->processServerMessages((const uint8*)_inBuffer.constData(),
+                                                       _inBuffer.size(), &updates);
+    if (consumed < 0)
+    {
+        // stream position is lost, no way to resync without reconnect
+        _logger->Log(kWarningLogLevel, base::Time::Now(), "Can't decode server message, framebuffer updates are stopped");
+        _framebufferFailed = true;
+        _inBuffer.clear();
+        return;
+    }
+    _inBuffer.remove(0, consumed);
+
+    if (updates > 0)
+    {
+        _framebufferUpdates += updates;
+        // keep server sending damaged areas
+        requestFramebufferUpdate(true);
+        emit framebufferUpdated();
+    }
 }
 
 quint16 VNCClient::convertQtKeyToX11Key(QKeyEvent *key)
@@ -28,8 +28,8 @@ ServerParameters::ServerParameters()
 {
 }
 
-ServerParameters::ServerParameters(qint16 width,
-      qint16 height, PIXEL_FORMAT *pixelFormat, QString *desktopName)
+ServerParameters::ServerParameters(quint16 width,
+      quint16 height, PIXEL_FORMAT *pixelFormat, QString *desktopName)
     : _width(width),
       _height(height),
       _pixelsFormat(pixelFormat),
@@ -43,12 +43,12 @@ ServerParameters::~ServerParameters()
     delete _name;
 }
 
-void ServerParameters::setHeight(qint16 height)
+void ServerParameters::setHeight(quint16 height)
 {
     _height = height;
 }
 
-void ServerParameters::setWidth(qint16 width)
+void ServerParameters::setWidth(quint16 width)
 {
     _width = width;
 }
@@ -63,12 +63,12 @@ void ServerParameters::setName(QString *name)
     _name = name;
 }
 
-qint16 ServerParameters::getHeight() const
+quint16 ServerParameters::getHeight() const
 {
     return _height;
 }
 
-qint16 ServerParameters::getWidth() const
+quint16 ServerParameters::getWidth() const
 {
     return _width;
 }
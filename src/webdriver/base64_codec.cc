@@ -0,0 +1,381 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#include "base64_codec.h"
+
+#include "base/logging.h"
+
+// Vectorized kernels follow the pshufb based base64 schemes by W. Mula and
+// D. Lemire. They are compiled with function level target attributes and
+// selected at runtime, so the rest of the binary keeps baseline ISA.
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define WD_BASE64_X86_SIMD 1
+#include <immintrin.h>
+#define WD_BASE64_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace webdriver {
+
+namespace {
+
+const char kEncodeTable[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Non-alphabet markers of kDecodeTable.
+const uint8 kX = 0xFF;  // invalid
+const uint8 kS = 0xFE;  // whitespace, skipped
+const uint8 kP = 0xFD;  // padding
+
+const uint8 kDecodeTable[256] = {
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kS, kS, kS, kS, kS, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kS, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, 62, kX, kX, kX, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, kX, kX, kX, kP, kX, kX,
+    kX,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, kX, kX, kX, kX, kX,
+    kX, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+};
+
+// Encodes as many leading 3-byte groups of |src| as kernel handles in bulk,
+// returns number of consumed bytes (multiple of 3). Writes 4/3 of that to
+// |dst|, never more.
+typedef size_t (*EncodeBlocksFunc)(const uint8* src, size_t length, char* dst);
+
+// Decodes leading 16-character blocks of |src| which consist of alphabet
+// characters only, stops at first block containing anything else. Returns
+// number of consumed characters (multiple of 4). May store up to
+// kDecodeOverrun bytes past decoded data.
+typedef size_t (*DecodeBlocksFunc)(const uint8* src, size_t length, uint8* dst);
+
+const size_t kDecodeOverrun = 8;
+
+struct Base64Kernels {
+    const char* name;
+    EncodeBlocksFunc encode;
+    DecodeBlocksFunc decode;
+};
+
+#if defined(WD_BASE64_X86_SIMD)
+
+// Maps 6-bit indices in every byte of |indices| to alphabet characters.
+WD_BASE64_TARGET("ssse3")
+inline __m128i LookupSsse3(__m128i indices) {
+    const __m128i shift_lut = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+    __m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+    result = _mm_shuffle_epi8(shift_lut, result);
+    return _mm_add_epi8(result, indices);
+}
+
+WD_BASE64_TARGET("ssse3")
+size_t EncodeBlocksSsse3(const uint8* src, size_t length, char* dst) {
+    const __m128i shuffle = _mm_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    size_t done = 0;
+    // Every step consumes 12 bytes but loads 16.
+    while (length - done >= 16) {
+        __m128i in = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(src + done));
+        in = _mm_shuffle_epi8(in, shuffle);
+        const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+        const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+        const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                         LookupSsse3(_mm_or_si128(t1, t3)));
+        dst += 16;
+        done += 12;
+    }
+    return done;
+}
+
+WD_BASE64_TARGET("ssse3")
+size_t DecodeBlocksSsse3(const uint8* src, size_t length, uint8* dst) {
+    const __m128i lut_lo = _mm_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_hi = _mm_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i pack = _mm_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    size_t done = 0;
+    while (length - done >= 16) {
+        const __m128i in = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(src + done));
+        const __m128i hi_nibbles =
+            _mm_and_si128(_mm_srli_epi32(in, 4), nibble);
+        const __m128i lo_nibbles = _mm_and_si128(in, nibble);
+        const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+        const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+        if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi),
+                                             _mm_setzero_si128())))
+            break;
+        const __m128i eq_2f = _mm_cmpeq_epi8(in, _mm_set1_epi8(0x2f));
+        const __m128i roll = _mm_shuffle_epi8(
+            lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+        const __m128i values = _mm_add_epi8(in, roll);
+        const __m128i merged =
+            _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        const __m128i packed =
+            _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                         _mm_shuffle_epi8(packed, pack));
+        dst += 12;
+        done += 16;
+    }
+    return done;
+}
+
+WD_BASE64_TARGET("avx2")
+size_t EncodeBlocksAvx2(const uint8* src, size_t length, char* dst) {
+    const __m256i shuffle = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i shift_lut = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+        '/' - 63, 'A', 0, 0);
+    size_t done = 0;
+    // Every step consumes 24 bytes, upper lane loads 16 bytes at offset 12.
+    while (length - done >= 28) {
+        const __m128i lo = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(src + done));
+        const __m128i hi = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(src + done + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        in = _mm256_shuffle_epi8(in, shuffle);
+        const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 =
+            _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 =
+            _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t1, t3);
+        __m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        result = _mm256_or_si256(
+            result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        result = _mm256_shuffle_epi8(shift_lut, result);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+                            _mm256_add_epi8(result, indices));
+        dst += 32;
+        done += 24;
+    }
+    return done + EncodeBlocksSsse3(src + done, length - done, dst);
+}
+
+WD_BASE64_TARGET("avx2")
+size_t DecodeBlocksAvx2(const uint8* src, size_t length, uint8* dst) {
+    const __m256i lut_lo = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lut_hi = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i pack = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    size_t done = 0;
+    while (length - done >= 32) {
+        const __m256i in = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(src + done));
+        const __m256i hi_nibbles =
+            _mm256_and_si256(_mm256_srli_epi32(in, 4), nibble);
+        const __m256i lo_nibbles = _mm256_and_si256(in, nibble);
+        const __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        if (_mm256_movemask_epi8(_mm256_cmpgt_epi8(
+                _mm256_and_si256(lo, hi), _mm256_setzero_si256())))
+            break;
+        const __m256i eq_2f = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(0x2f));
+        const __m256i roll = _mm256_shuffle_epi8(
+            lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+        const __m256i values = _mm256_add_epi8(in, roll);
+        const __m256i merged =
+            _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const __m256i packed =
+            _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        const __m256i bytes = _mm256_permutevar8x32_epi32(
+            _mm256_shuffle_epi8(packed, pack), lanes);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), bytes);
+        dst += 24;
+        done += 32;
+    }
+    // Block with whitespace may still have a clean 16-character half.
+    return done + DecodeBlocksSsse3(src + done, length - done, dst);
+}
+
+#endif  // WD_BASE64_X86_SIMD
+
+Base64Kernels SelectKernels() {
+    Base64Kernels kernels = { "scalar", NULL, NULL };
+#if defined(WD_BASE64_X86_SIMD)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.name = "avx2";
+        kernels.encode = &EncodeBlocksAvx2;
+        kernels.decode = &DecodeBlocksAvx2;
+    } else if (__builtin_cpu_supports("ssse3")) {
+        kernels.name = "ssse3";
+        kernels.encode = &EncodeBlocksSsse3;
+        kernels.decode = &DecodeBlocksSsse3;
+    }
+#endif
+    return kernels;
+}
+
+const Base64Kernels& GetKernels() {
+    static const Base64Kernels kernels = SelectKernels();
+    return kernels;
+}
+
+}  // namespace
+
+void Base64EncodeAppend(const char* data, size_t length, std::string* output) {
+    DCHECK(output);
+    if (!length)
+        return;
+
+    const size_t old_size = output->size();
+    output->resize(old_size + (length + 2) / 3 * 4);
+
+    const uint8* src = reinterpret_cast<const uint8*>(data);
+    char* dst = &(*output)[old_size];
+
+    const Base64Kernels& kernels = GetKernels();
+    if (kernels.encode) {
+        const size_t done = kernels.encode(src, length, dst);
+        src += done;
+        dst += done / 3 * 4;
+        length -= done;
+    }
+
+    for (; length >= 3; length -= 3, src += 3, dst += 4) {
+        const uint32 group = (src[0] << 16) | (src[1] << 8) | src[2];
+        dst[0] = kEncodeTable[group >> 18];
+        dst[1] = kEncodeTable[(group >> 12) & 0x3f];
+        dst[2] = kEncodeTable[(group >> 6) & 0x3f];
+        dst[3] = kEncodeTable[group & 0x3f];
+    }
+
+    if (length) {
+        const uint32 group = (src[0] << 16) | (length > 1 ? src[1] << 8 : 0);
+        dst[0] = kEncodeTable[group >> 18];
+        dst[1] = kEncodeTable[(group >> 12) & 0x3f];
+        dst[2] = length > 1 ? kEncodeTable[(group >> 6) & 0x3f] : '=';
+        dst[3] = '=';
+    }
+}
+
+bool Base64DecodeAppend(const char* data, size_t length, std::string* output) {
+    DCHECK(output);
+    const size_t old_size = output->size();
+    output->resize(old_size + length / 4 * 3 + 3 + kDecodeOverrun);
+
+    const uint8* src = reinterpret_cast<const uint8*>(data);
+    const uint8* const end = src + length;
+    uint8* const begin = reinterpret_cast<uint8*>(&(*output)[old_size]);
+    uint8* dst = begin;
+
+    const DecodeBlocksFunc decode_blocks = GetKernels().decode;
+    uint32 quantum = 0;
+    int count = 0;
+    int padding = 0;
+    bool valid = true;
+
+    while (valid && src < end) {
+        // Bulk path only resumes on quantum boundary, which for line wrapped
+        // input is right after every line break.
+        if (decode_blocks && !count && !padding) {
+            const size_t done = decode_blocks(src, end - src, dst);
+            src += done;
+            dst += done / 4 * 3;
+            if (src == end)
+                break;
+        }
+
+        const uint8 value = kDecodeTable[*src++];
+        if (value < 64) {
+            if (padding) {
+                valid = false;
+                continue;
+            }
+            quantum = (quantum << 6) | value;
+            if (++count == 4) {
+                dst[0] = static_cast<uint8>(quantum >> 16);
+                dst[1] = static_cast<uint8>(quantum >> 8);
+                dst[2] = static_cast<uint8>(quantum);
+                dst += 3;
+                quantum = 0;
+                count = 0;
+            }
+        } else if (value == kP) {
+            valid = count >= 2 && count + ++padding <= 4;
+        } else if (value != kS) {
+            valid = false;
+        }
+    }
+
+    valid = valid && count != 1 && (!padding || count + padding == 4);
+    if (valid && count == 2) {
+        *dst++ = static_cast<uint8>(quantum >> 4);
+    } else if (valid && count == 3) {
+        *dst++ = static_cast<uint8>(quantum >> 10);
+        *dst++ = static_cast<uint8>(quantum >> 2);
+    }
+
+    output->resize(valid ? old_size + (dst - begin) : old_size);
+    return valid;
+}
+
+const char* Base64CodecImplementation() {
+    return GetKernels().name;
+}
+
+}  // namespace webdriver
@@ -0,0 +1,45 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef WEBDRIVER_BASE64_CODEC_H_
+#define WEBDRIVER_BASE64_CODEC_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+
+namespace webdriver {
+
+// Appends standard (RFC 4648, padded) base64 encoding of |length| bytes of
+// |data| to |output|. Output is grown once and written in place; on x86 the
+// bulk of input is encoded with SSSE3 or AVX2 when CPU supports it.
+void Base64EncodeAppend(const char* data, size_t length, std::string* output);
+
+// Decodes |length| base64 characters of |data| in one pass and appends bytes
+// to |output|. ASCII whitespace anywhere in input is skipped, trailing padding
+// may be omitted. Returns false and leaves |output| unchanged on malformed
+// input.
+bool Base64DecodeAppend(const char* data, size_t length, std::string* output);
+
+// Returns name of the code path selected for this CPU, e.g. "avx2".
+const char* Base64CodecImplementation();
+
+}  // namespace webdriver
+
+#endif  // WEBDRIVER_BASE64_CODEC_H_
@@ -0,0 +1,74 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#include "commands/actions_command.h"
+
+#include "base/bind.h"
+#include "base/values.h"
+#include "commands/response.h"
+#include "webdriver_error.h"
+#include "webdriver_session.h"
+#include "webdriver_view_executor.h"
+
+namespace webdriver {
+
+ActionsCommand::ActionsCommand(const std::vector<std::string>& path_segments,
+                               const DictionaryValue* const parameters)
+    : ViewCommand(path_segments, parameters) {}
+
+ActionsCommand::~ActionsCommand() {}
+
+bool ActionsCommand::DoesPost() const {
+    return true;
+}
+
+bool ActionsCommand::DoesDelete() const {
+    return true;
+}
+
+void ActionsCommand::ExecutePost(Response* const response) {
+    const ListValue* actions = NULL;
+    if (!GetListParameter("actions", &actions)) {
+        response->SetError(new Error(kBadRequest, "Missing or invalid 'actions' parameter"));
+        return;
+    }
+
+    Error* error = NULL;
+    session_->RunSessionTask(base::Bind(
+            &ViewCmdExecutor::PerformActions,
+            base::Unretained(executor_.get()),
+            actions,
+            &error));
+
+    if (error)
+        response->SetError(error);
+}
+
+void ActionsCommand::ExecuteDelete(Response* const response) {
+    Error* error = NULL;
+    session_->RunSessionTask(base::Bind(
+            &ViewCmdExecutor::ReleaseActions,
+            base::Unretained(executor_.get()),
+            &error));
+
+    if (error)
+        response->SetError(error);
+}
+
+}  // namespace webdriver
@@ -13,8 +13,6 @@
 
 namespace webdriver {
 
-typedef scoped_ptr<ViewCmdExecutor> ExecutorPtr;
-
 BrowserConnectionCommand::BrowserConnectionCommand(const std::vector<std::string>& path_segments,
                                                    const base::DictionaryValue* const parameters)
     : WebDriverCommand(path_segments, parameters) {
@@ -35,7 +33,7 @@ void BrowserConnectionCommand::ExecuteGet(Response* const response) {
     bool online;
     Error* error = NULL;
 
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_));
     if (NULL == executor.get()) {
         response->SetError(new Error(kBadRequest, "cant get view executor."));
         return;
@@ -79,7 +77,7 @@ void BrowserConnectionCommand::ExecutePost(Response* const response) {
 
     for (size_t i = 0; i < views.size(); ++i) {
         Error* error = NULL;
-        ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_, views.at(i)));
+        ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_, views.at(i)));
         if (NULL == executor.get()) {
             GlobalLogger::Log(kWarningLogLevel, "Cant update online mode for view(no executor), skip.");
             continue;
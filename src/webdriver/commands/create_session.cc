@@ -22,8 +22,6 @@
 
 namespace webdriver {
 
-typedef scoped_ptr<ViewCmdExecutor> ExecutorPtr;  
-
 CreateSession::CreateSession(const std::vector<std::string>& path_segments,
                              const DictionaryValue* const parameters)
     : Command(path_segments, parameters) {}
@@ -204,7 +202,7 @@ bool CreateSession::CreateViewByClassName(Session* session, const std::string& n
 
 Error* CreateSession::SwitchToView(Session* session, const ViewId& viewId) {
     Error* error = NULL;
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session, viewId));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session, viewId));
 
     if (NULL == executor.get()) {
         return new Error(kBadRequest, "cant get view executor.");
@@ -222,7 +220,7 @@ Error* CreateSession::SwitchToView(Session* session, const ViewId& viewId) {
 
 Error* CreateSession::GetViewTitle(Session* session, const ViewId& viewId, std::string* title) {
     Error* error = NULL;
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session, viewId));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session, viewId));
 
     if (NULL == executor.get()) {
         return new Error(kBadRequest, "cant get view executor.");
@@ -239,7 +237,7 @@ Error* CreateSession::GetViewTitle(Session* session, const ViewId& viewId, std::
 
 Error* CreateSession::SetWindowBounds(const DictionaryValue* desired_caps_dict,Session* session, ViewId startView) {
     Error* error = NULL;
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session, startView));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session, startView));
     if (NULL == executor.get()) {
         error = new Error(kBadRequest, "cant get view executor.");
         session->logger().Log(kWarningLogLevel, "Can't get view executor.");
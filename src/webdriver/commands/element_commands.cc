@@ -4,7 +4,6 @@
 
 #include "commands/element_commands.h"
 
-#include "base/base64.h"
 #include "base/file_util.h"
 #include "base/format_macros.h"
 #include "base/memory/scoped_ptr.h"
@@ -596,11 +595,7 @@ void ElementScreenshotCommand::ExecuteGet(Response* const response) {
 
     // Convert the raw binary data to base 64 encoding for webdriver.
     std::string base64_screenshot;
-    if (!base::Base64Encode(raw_bytes, &base64_screenshot)) {
-        response->SetError(new Error(
-            kUnknownError, "Encoding the PNG to base64 format failed"));
-        return;
-    }
+    Base64Encode(raw_bytes, &base64_screenshot);
 
     response->SetValue(new StringValue(base64_screenshot));
 }
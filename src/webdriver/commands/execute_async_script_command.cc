@@ -7,12 +7,21 @@
 #include "base/values.h"
 #include "base/bind.h"
 #include "commands/response.h"
+#include "webdriver_async_script.h"
 #include "webdriver_error.h"
 #include "webdriver_session.h"
 #include "webdriver_view_executor.h"
 
 namespace webdriver {
 
+namespace {
+
+// View completes async script itself when timeout expires, command gives up
+// only if view thread doesn't respond for that long on top of it.
+const int kAsyncScriptResponseGraceMs = 5000;
+
+}  // namespace
+
 ExecuteAsyncScriptCommand::ExecuteAsyncScriptCommand(
     const std::vector<std::string>& path_segments,
     const DictionaryValue* const parameters)
@@ -41,15 +50,26 @@ void ExecuteAsyncScriptCommand::ExecutePost(Response* const response) {
 
     Value* result = NULL;
     Error* error = NULL;
+    scoped_refptr<AsyncScriptResult> async_result(new AsyncScriptResult());
 
+    // Task only starts script, view thread is not blocked while it runs.
     session_->RunSessionTask(base::Bind(
             &ViewCmdExecutor::ExecuteAsyncScript,
             base::Unretained(executor_.get()),
             script,
             args,
-            &result,
+            async_result,
             &error));
 
+    if (!error) {
+        base::TimeDelta timeout = base::TimeDelta::FromMilliseconds(
+            session_->async_script_timeout() + kAsyncScriptResponseGraceMs);
+        if (async_result->TimedWait(timeout))
+            error = async_result->TakeResult(&result);
+        else
+            error = new Error(kScriptTimeout, "View did not respond with async script result");
+    }
+
     if (error) {
         error->AddDetails("Script execution failed. Script: " + script);
         response->SetError(error);
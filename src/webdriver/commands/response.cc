@@ -53,6 +53,7 @@ void Response::SetValue(Value* value) {
 }
 
 void Response::SetError(Error* error) {
+    ClearRawBody();
     DictionaryValue* error_dict = new DictionaryValue();
     error_dict->SetString(kMessageKey, error->details());
 
@@ -69,6 +70,12 @@ const Value* Response::GetDictionary() const {
     return &data_;
 }
 
+DictionaryValue* Response::TakeDictionary() {
+    DictionaryValue* dictionary = new DictionaryValue();
+    dictionary->Swap(&data_);
+    return dictionary;
+}
+
 std::string Response::ToJSON() const {
     std::string json;
     // The |Value| classes do not support int64 and in rare cases we need to
@@ -80,4 +87,58 @@ std::string Response::ToJSON() const {
     return json;
 }
 
+bool Response::WriteJSON(size_t chunk_size, base::JSONWriter::Sink* sink) const {
+    // See ToJSON() for OPTIONS_OMIT_DOUBLE_TYPE_PRESERVATION.
+    return base::JSONWriter::WriteToSink(
+        &data_, base::JSONWriter::OPTIONS_OMIT_DOUBLE_TYPE_PRESERVATION,
+        chunk_size, sink);
+}
+
+void Response::SetRawBody(const std::string& mime_type, std::string* body) {
+    ClearRawBody();
+    raw_mime_type_ = mime_type;
+    raw_body_.swap(*body);
+}
+
+void Response::SetBodyStream(const std::string& mime_type, ResponseBodyStream* stream) {
+    ClearRawBody();
+    raw_mime_type_ = mime_type;
+    body_stream_.reset(stream);
+}
+
+void Response::SetRawBodyETag(const std::string& etag) {
+    raw_body_etag_ = etag;
+}
+
+const std::string& Response::GetRawBodyETag() const {
+    return raw_body_etag_;
+}
+
+bool Response::HasRawBody() const {
+    return !raw_mime_type_.empty();
+}
+
+const std::string& Response::GetRawMimeType() const {
+    return raw_mime_type_;
+}
+
+bool Response::IsRawBodyStreamed() const {
+    return NULL != body_stream_.get();
+}
+
+bool Response::WriteRawBody(base::JSONWriter::Sink* sink) const {
+    if (NULL != body_stream_.get())
+        return body_stream_->WriteBody(sink);
+    if (raw_body_.empty())
+        return true;
+    return sink->Write(raw_body_.data(), raw_body_.length());
+}
+
+void Response::ClearRawBody() {
+    raw_mime_type_.clear();
+    raw_body_.clear();
+    raw_body_etag_.clear();
+    body_stream_.reset(NULL);
+}
+
 }  // namespace webdriver
@@ -7,16 +7,210 @@
 #include <string>
 #include <vector>
 
-#include "base/base64.h"
 #include "base/values.h"
 #include "base/bind.h"
+#include "base/stringprintf.h"
+#include "base/threading/platform_thread.h"
+#include "base/time.h"
 #include "commands/response.h"
 #include "webdriver_error.h"
+#include "webdriver_logging.h"
 #include "webdriver_session.h"
+#include "webdriver_session_manager.h"
+#include "webdriver_util.h"
 #include "webdriver_view_executor.h"
 
 namespace webdriver {
 
+namespace {
+
+const char kPngFormat[] = "png";
+const char kRgbaFormat[] = "rgba";
+const char kStreamBoundary[] = "wdscreenframe";
+
+const int kDefaultStreamFps = 5;
+const int kMaxStreamFps = 60;
+// Stream duration if neither frames nor duration limit is given.
+const int kDefaultStreamDurationMs = 60 * 1000;
+// Unchanged frame is resent after this number of idle ticks, otherwise
+// disconnected client is not noticed while view is static.
+const int kKeepAliveTicks = 20;
+
+bool ParseScreenshotFormat(const std::string& name, ScreenshotFormat* format) {
+    if (name == kPngFormat) {
+        *format = kPngScreenshot;
+        return true;
+    }
+    if (name == kRgbaFormat) {
+        *format = kRgbaScreenshot;
+        return true;
+    }
+    return false;
+}
+
+const char* GetScreenshotMimeType(ScreenshotFormat format) {
+    return (kPngScreenshot == format) ? "image/png" : "application/octet-stream";
+}
+
+// Strong entity tag of screenshot, FNV-1a hash of content.
+std::string GetScreenshotETag(const std::string& data) {
+    uint64 hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < data.length(); ++i) {
+        hash ^= static_cast<uint8>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return base::StringPrintf("\"%08x%08x\"",
+                              static_cast<uint32>(hash >> 32),
+                              static_cast<uint32>(hash));
+}
+
+// Produces multipart/x-mixed-replace body with screenshots of single view.
+// Works on HTTP thread, grabs are posted to session thread. Session is looked
+// up on every tick and can't be terminated while tick is running.
+class ScreenshotStream : public ResponseBodyStream {
+public:
+    ScreenshotStream(const std::string& session_id,
+                     const ViewId& view_id,
+                     ScreenshotFormat format,
+                     int fps,
+                     int max_frames,
+                     int max_duration_ms)
+        : session_id_(session_id),
+          view_id_(view_id),
+          format_(format),
+          fps_(fps),
+          max_frames_(max_frames),
+          max_duration_ms_(max_duration_ms),
+          track_repaints_(true),
+          has_frame_(false),
+          last_repaint_(0),
+          idle_ticks_(0),
+          frames_(0) {}
+    virtual ~ScreenshotStream() {}
+
+    virtual bool WriteBody(base::JSONWriter::Sink* sink) OVERRIDE {
+        const base::TimeDelta interval = base::TimeDelta::FromMilliseconds(1000 / fps_);
+        const base::TimeTicks start = base::TimeTicks::Now();
+
+        while (0 == max_frames_ || frames_ < max_frames_) {
+            if (max_duration_ms_ > 0 &&
+                (base::TimeTicks::Now() - start).InMilliseconds() >= max_duration_ms_)
+                break;
+
+            TickResult result = kTickStop;
+            if (!SessionManager::GetInstance()->RunWithSession(session_id_, base::Bind(
+                    &ScreenshotStream::Tick,
+                    base::Unretained(this),
+                    sink,
+                    &result)))
+                break;
+            if (kTickWriteFailed == result)
+                return false;
+            if (kTickStop == result)
+                break;
+
+            base::PlatformThread::Sleep(interval);
+        }
+
+        std::string end = base::StringPrintf("--%s--\r\n", kStreamBoundary);
+        return sink->Write(end.data(), end.length());
+    }
+
+private:
+    enum TickResult {
+        kTickContinue,
+        kTickStop,
+        kTickWriteFailed
+    };
+
+    // Sends frame if view was repainted since previous one.
+    void Tick(base::JSONWriter::Sink* sink, TickResult* result, Session* session) {
+        *result = kTickStop;
+        ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session, view_id_));
+        if (NULL == executor.get())
+            return;
+
+        bool changed = true;
+        if (track_repaints_) {
+            int repaint = 0;
+            if (GetRepaintCount(session, executor.get(), &repaint))
+                changed = !has_frame_ || (repaint != last_repaint_);
+            else
+                track_repaints_ = false;  // grab view on every tick
+        }
+
+        if (!changed && idle_ticks_ < kKeepAliveTicks) {
+            ++idle_ticks_;
+            *result = kTickContinue;
+            return;
+        }
+
+        Error* error = NULL;
+        std::string frame;
+        session->RunSessionTask(base::Bind(
+                &ViewCmdExecutor::GetScreenShotImage,
+                base::Unretained(executor.get()),
+                format_,
+                &frame,
+                &error));
+        if (error) {
+            session->logger().Log(kWarningLogLevel,
+                    "Screenshot stream stopped: " + error->details());
+            delete error;
+            return;
+        }
+        if (!WritePart(frame, sink)) {
+            *result = kTickWriteFailed;
+            return;
+        }
+        // grabbing may repaint view by itself, so count is taken after it
+        if (track_repaints_ && !GetRepaintCount(session, executor.get(), &last_repaint_))
+            track_repaints_ = false;
+        has_frame_ = true;
+        idle_ticks_ = 0;
+        ++frames_;
+        *result = kTickContinue;
+    }
+
+    bool GetRepaintCount(Session* session, ViewCmdExecutor* executor, int* count) {
+        Error* error = NULL;
+        session->RunSessionTask(base::Bind(
+                &ViewCmdExecutor::GetRepaintCount,
+                base::Unretained(executor),
+                count,
+                &error));
+        scoped_ptr<Error> scoped_error(error);
+        return NULL == error;
+    }
+
+    bool WritePart(const std::string& frame, base::JSONWriter::Sink* sink) {
+        std::string header = base::StringPrintf(
+                "--%s\r\nContent-Type: %s\r\nContent-Length: %lu\r\n\r\n",
+                kStreamBoundary,
+                GetScreenshotMimeType(format_),
+                static_cast<unsigned long>(frame.length()));
+        return sink->Write(header.data(), header.length()) &&
+               sink->Write(frame.data(), frame.length()) &&
+               sink->Write("\r\n", 2);
+    }
+
+    std::string session_id_;
+    ViewId view_id_;
+    ScreenshotFormat format_;
+    int fps_;
+    int max_frames_;
+    int max_duration_ms_;
+    bool track_repaints_;
+    bool has_frame_;
+    int last_repaint_;
+    int idle_ticks_;
+    int frames_;
+
+    DISALLOW_COPY_AND_ASSIGN(ScreenshotStream);
+};
+
+}  // namespace
+
 ScreenshotCommand::ScreenshotCommand(const std::vector<std::string>& ps,
                                      const DictionaryValue* const parameters)
     : ViewCommand(ps, parameters) {}
@@ -45,13 +239,97 @@ void ScreenshotCommand::ExecuteGet(Response* const response) {
 
     // Convert the raw binary data to base 64 encoding for webdriver.
     std::string base64_screenshot;
-    if (!base::Base64Encode(raw_bytes, &base64_screenshot)) {
+    Base64Encode(raw_bytes, &base64_screenshot);
+
+    response->SetValue(new StringValue(base64_screenshot));
+}
+
+RawScreenshotCommand::RawScreenshotCommand(const std::vector<std::string>& ps,
+                                           const DictionaryValue* const parameters)
+    : ViewCommand(ps, parameters) {}
+
+RawScreenshotCommand::~RawScreenshotCommand() {}
+
+bool RawScreenshotCommand::DoesGet() const {
+    return true;
+}
+
+void RawScreenshotCommand::ExecuteGet(Response* const response) {
+    ScreenshotFormat format;
+    if (!ParseScreenshotFormat(GetPathVariable(4), &format)) {
         response->SetError(new Error(
-            kUnknownError, "Encoding the PNG to base64 format failed"));
+            kBadRequest, "Unknown screenshot format: " + GetPathVariable(4)));
         return;
     }
 
-    response->SetValue(new StringValue(base64_screenshot));
+    std::string data;
+    Error* error = NULL;
+
+    session_->RunSessionTask(base::Bind(
+            &ViewCmdExecutor::GetScreenShotImage,
+            base::Unretained(executor_.get()),
+            format,
+            &data,
+            &error));
+
+    if (error) {
+        response->SetError(error);
+        return;
+    }
+
+    std::string etag = GetScreenshotETag(data);
+    response->SetRawBody(GetScreenshotMimeType(format), &data);
+    response->SetRawBodyETag(etag);
+}
+
+ScreenshotStreamCommand::ScreenshotStreamCommand(const std::vector<std::string>& ps,
+                                                 const DictionaryValue* const parameters)
+    : ViewCommand(ps, parameters) {}
+
+ScreenshotStreamCommand::~ScreenshotStreamCommand() {}
+
+bool ScreenshotStreamCommand::DoesGet() const {
+    return true;
+}
+
+bool ScreenshotStreamCommand::DoesPost() const {
+    return true;
+}
+
+void ScreenshotStreamCommand::ExecuteGet(Response* const response) {
+    ExecutePost(response);
+}
+
+void ScreenshotStreamCommand::ExecutePost(Response* const response) {
+    ScreenshotFormat format = kPngScreenshot;
+    std::string format_name;
+    if (GetStringParameter("format", &format_name) &&
+        !ParseScreenshotFormat(format_name, &format)) {
+        response->SetError(new Error(
+            kBadRequest, "Unknown screenshot format: " + format_name));
+        return;
+    }
+
+    int fps = kDefaultStreamFps;
+    int frames = 0;
+    int duration = 0;
+    GetIntegerParameter("fps", &fps);
+    GetIntegerParameter("frames", &frames);
+    GetIntegerParameter("duration", &duration);
+    if (fps <= 0 || fps > kMaxStreamFps || frames < 0 || duration < 0) {
+        response->SetError(new Error(
+            kBadRequest, base::StringPrintf(
+                "Invalid stream parameters, fps must be in 1..%d, frames and duration non-negative",
+                kMaxStreamFps)));
+        return;
+    }
+    if (0 == frames && 0 == duration)
+        duration = kDefaultStreamDurationMs;
+
+    response->SetBodyStream(
+            base::StringPrintf("multipart/x-mixed-replace; boundary=%s", kStreamBoundary),
+            new ScreenshotStream(session_id_, session_->current_view(),
+                                 format, fps, frames, duration));
 }
 
 }  // namespace webdriver
@@ -53,10 +53,8 @@ void SessionWithID::ExecuteDelete(Response* const response) {
 }
 
 void SessionWithID::CloseView(const ViewId& viewId) {
-    typedef scoped_ptr<ViewCmdExecutor> ExecutorPtr;        
-
     Error* error = NULL;
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_, viewId));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_, viewId));
 
     if (NULL == executor.get()) {
         session_->logger().Log(kSevereLogLevel, "Cant get executor.");
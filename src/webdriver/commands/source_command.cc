@@ -43,4 +43,58 @@ void SourceCommand::ExecuteGet(Response* const response) {
     response->SetValue(new StringValue(page_source));
 }
 
+IncrementalSourceCommand::IncrementalSourceCommand(const std::vector<std::string>& path_segments,
+                                                   const DictionaryValue* const parameters)
+    : ViewCommand(path_segments, parameters) {}
+
+IncrementalSourceCommand::~IncrementalSourceCommand() {}
+
+bool IncrementalSourceCommand::DoesGet() const {
+    return true;
+}
+
+bool IncrementalSourceCommand::DoesPost() const {
+    return true;
+}
+
+void IncrementalSourceCommand::ExecuteGet(Response* const response) {
+    SendChanges(-1, response);
+}
+
+void IncrementalSourceCommand::ExecutePost(Response* const response) {
+    int revision = -1;
+    if (HasParameter("revision") && !GetIntegerParameter("revision", &revision)) {
+        response->SetError(new Error(kBadRequest, "'revision' must be an integer"));
+        return;
+    }
+    SendChanges(revision, response);
+}
+
+void IncrementalSourceCommand::SendChanges(int base_revision, Response* const response) {
+    std::string page_source;
+    Error* error = NULL;
+
+    session_->RunSessionTask(base::Bind(
+            &ViewCmdExecutor::GetSource,
+            base::Unretained(executor_.get()),
+            &page_source,
+            &error));
+
+    if (error) {
+        response->SetError(error);
+        return;
+    }
+
+    DictionaryValue* result = new DictionaryValue();
+    session_->RunSessionTask(base::Bind(
+            &Session::UpdateSourceSnapshot,
+            base::Unretained(session_),
+            session_->current_view(),
+            &page_source,
+            base_revision,
+            result));
+
+    response->SetValue(result);
+}
+
 }  // namespace webdriver
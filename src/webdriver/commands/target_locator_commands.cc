@@ -19,8 +19,6 @@ using base::Value;
 
 namespace webdriver {
 
-typedef scoped_ptr<ViewCmdExecutor> ExecutorPtr;        
-
 WindowHandleCommand::WindowHandleCommand(
     const std::vector<std::string>& path_segments,
     const DictionaryValue* parameters)
@@ -125,7 +123,7 @@ void WindowCommand::ExecutePost(Response* const response) {
 
 Error* WindowCommand::GetViewTitle(const ViewId& viewId, std::string* title) {
     Error* error = NULL;
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_, viewId));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_, viewId));
 
     if (NULL == executor.get()) {
         return new Error(kBadRequest, "cant get view executor.");
@@ -142,7 +140,7 @@ Error* WindowCommand::GetViewTitle(const ViewId& viewId, std::string* title) {
 
 Error* WindowCommand::SwitchToView(const ViewId& viewId) {
     Error* error = NULL;
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_, viewId));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_, viewId));
 
     if (NULL == executor.get()) {
         return new Error(kBadRequest, "cant get view executor.");
@@ -157,7 +155,7 @@ Error* WindowCommand::SwitchToView(const ViewId& viewId) {
 }
 
 bool WindowCommand::DoesViewExist(const ViewId& viewId) {
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_, viewId));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_, viewId));
 
     if (NULL == executor.get()) {
         return false;
@@ -168,7 +166,7 @@ bool WindowCommand::DoesViewExist(const ViewId& viewId) {
 
 void WindowCommand::ExecuteDelete(Response* const response) {
     Error* error = NULL;
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_, session_->current_view()));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_, session_->current_view()));
 
     if (NULL == executor.get()) {
         response->SetError(new Error(kBadRequest, "cant get view executor."));
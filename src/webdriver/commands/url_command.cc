@@ -14,8 +14,6 @@
 
 namespace webdriver {
 
-typedef scoped_ptr<ViewCmdExecutor> ExecutorPtr;    
-
 URLCommand::URLCommand(const std::vector<std::string>& path_segments,
                        const DictionaryValue* const parameters)
     : WebDriverCommand(path_segments, parameters) {}
@@ -34,7 +32,7 @@ void URLCommand::ExecuteGet(Response* const response) {
     std::string url;
     Error* error = NULL;
 
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_));
     if (NULL == executor.get()) {
         response->SetError(new Error(kBadRequest, "cant get view executor."));
         return;
@@ -57,7 +55,7 @@ void URLCommand::ExecutePost(Response* const response) {
     std::string url;
     Error* error = NULL;
 
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_));
     if (NULL == executor.get()) {
         response->SetError(new Error(kBadRequest, "cant get view executor."));
         return;
@@ -68,12 +66,15 @@ void URLCommand::ExecutePost(Response* const response) {
         return;
     }
 
-    // TODO: get capabilities and choose sync/async method
+    // Executor waits according to session's page load strategy, "none"
+    // returns right after navigation is started.
+    const bool sync =
+        session_->capabilities().page_load_strategy != kNonePageLoad;
     session_->RunSessionTask(base::Bind(
             &ViewCmdExecutor::NavigateToURL,
             base::Unretained(executor.get()),
             url,
-            true,
+            sync,
             &error));
 
     if (error) {
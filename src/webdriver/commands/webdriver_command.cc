@@ -47,11 +47,13 @@ bool WebDriverCommand::Init(Response* const response) {
         return false;
     }
 
-    std::string message = base::StringPrintf(
-        "Command received (%s)", JoinString(path_segments_, '/').c_str());
-    if (parameters_)
-        message += " with params " + JsonStringifyForDisplay(parameters_.GetRawPointer());
-    session_->logger().Log(kFineLogLevel, message);
+    if (session_->logger().IsLoggable(kFineLogLevel)) {
+        std::string message = base::StringPrintf(
+            "Command received (%s)", JoinString(path_segments_, '/').c_str());
+        if (parameters_)
+            message += " with params " + JsonStringifyForDisplay(parameters_.GetRawPointer());
+        session_->logger().Log(kFineLogLevel, message);
+    }
 
     // terminate session if no views found
     std::vector<ViewId> views;
@@ -98,11 +100,14 @@ void WebDriverCommand::Finish(Response* const response) {
     LogLevel level = kWarningLogLevel;
     if (response->GetStatus() == kSuccess)
         level = kFineLogLevel;
-    session_->logger().Log(
-        level, base::StringPrintf(
-            "Command finished (%s) with response %s",
-            JoinString(path_segments_, '/').c_str(),
-            JsonStringifyForDisplay(response->GetDictionary()).c_str()));
+    // Do not stringify possibly huge response unless it is going to be logged.
+    if (session_->logger().IsLoggable(level)) {
+        session_->logger().Log(
+            level, base::StringPrintf(
+                "Command finished (%s) with response %s",
+                JoinString(path_segments_, '/').c_str(),
+                JsonStringifyForDisplay(response->GetDictionary()).c_str()));
+    }
 }
 
 bool WebDriverCommand::ShouldRunPreAndPostCommandHandlers() {
@@ -124,7 +129,7 @@ bool ViewCommand::Init(Response* const response) {
         return false;
 
     // get executor for current view
-    executor_.reset(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_));
+    executor_ = ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_);
     if (NULL == executor_.get()) {
         response->SetError(new Error(kNoSuchWindow, "cant get view executor."));
         return false;
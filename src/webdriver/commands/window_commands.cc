@@ -19,8 +19,6 @@ namespace webdriver {
 
 namespace {
 
-typedef scoped_ptr<ViewCmdExecutor> ExecutorPtr;    
-
 bool GetWindowId(const std::string& window_id_string,
                  const ViewId& current_id,
                  ViewId* window_id,
@@ -58,7 +56,7 @@ void WindowSizeCommand::ExecuteGet(Response* const response) {
     if (!GetWindowId(GetPathVariable(4), session_->current_view(), &window_id, response))
         return;
 
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_, window_id));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_, window_id));
     if (NULL == executor.get()) {
         response->SetError(new Error(kBadRequest, "cant get view executor."));
         return;
@@ -89,7 +87,7 @@ void WindowSizeCommand::ExecutePost(Response* const response) {
     if (!GetWindowId(GetPathVariable(4), session_->current_view(), &window_id, response))
         return;
 
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_, window_id));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_, window_id));
     if (NULL == executor.get()) {
         response->SetError(new Error(kBadRequest, "cant get view executor."));
         return;
@@ -149,7 +147,7 @@ void WindowPositionCommand::ExecuteGet(Response* const response) {
     if (!GetWindowId(GetPathVariable(4), session_->current_view(), &window_id, response))
         return;
 
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_, window_id));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_, window_id));
     if (NULL == executor.get()) {
         response->SetError(new Error(kBadRequest, "cant get view executor."));
         return;
@@ -178,7 +176,7 @@ void WindowPositionCommand::ExecutePost(Response* const response) {
     if (!GetWindowId(GetPathVariable(4), session_->current_view(), &window_id, response))
         return;
 
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_, window_id));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_, window_id));
     if (NULL == executor.get()) {
         response->SetError(new Error(kBadRequest, "cant get view executor."));
         return;
@@ -232,7 +230,7 @@ void WindowMaximizeCommand::ExecutePost(Response* const response) {
     if (!GetWindowId(GetPathVariable(4), session_->current_view(), &window_id, response))
         return;
 
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session_, window_id));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session_, window_id));
     if (NULL == executor.get()) {
         response->SetError(new Error(kBadRequest, "cant get view executor."));
         return;
@@ -19,6 +19,7 @@
 
 #include "base/json/json_reader.h"
 #include "base/string_split.h"
+#include "base/string_util.h"
 #include "commands/response.h"
 #include "commands/xdrpc_command.h"
 #include "webdriver_route_table.h"
@@ -28,9 +29,17 @@
 
 namespace webdriver {
 
+namespace {
+
+const char kCallsKey[] = "calls";
+const char kDataKey[] = "data";
+
+}  // namespace
+
 XDRPCCommand::XDRPCCommand(const std::vector<std::string>& path_segments,
-                           const DictionaryValue* const parameters)
-    : Command(path_segments, parameters) {}
+                           DictionaryValue* const parameters)
+    : Command(path_segments, parameters),
+      request_(parameters) {}
 
 XDRPCCommand::~XDRPCCommand() {}
 
@@ -39,24 +48,57 @@ bool XDRPCCommand::DoesPost() const {
 }
 
 void XDRPCCommand::ExecutePost(Response* const response) {
+    if (NULL == request_) {
+        response->SetError(new Error(kBadRequest, "xdrpc call is missing"));
+        return;
+    }
+
+    // parameters are not used after dispatch, so calls move their data
+    // out of them instead of copying
+    ListValue* calls = NULL;
+    if (!request_->GetList(kCallsKey, &calls)) {
+        // status is left as set by the dispatched command
+        DispatchCall(request_, response);
+        return;
+    }
+
+    ListValue* results = new ListValue();
+    for (size_t i = 0; i < calls->GetSize(); ++i) {
+        Response call_response;
+        DictionaryValue* call = NULL;
+        if (calls->GetDictionary(i, &call)) {
+            DispatchCall(call, &call_response);
+        } else {
+            call_response.SetError(new Error(
+                kBadRequest, "xdrpc call must be a dictionary"));
+        }
+        results->Append(call_response.TakeDictionary());
+    }
+    response->SetValue(results);
+}
+
+void XDRPCCommand::DispatchCall(DictionaryValue* call, Response* const response) {
     std::string method;
-    GetStringParameter("method", &method);
+    call->GetString("method", &method);
+    if (method != "GET" && method != "POST" && method != "DELETE" && method != "OPTIONS") {
+        response->SetError(new Error(
+            kBadRequest, "unsupported method: " + method));
+        return;
+    }
 
     std::string path;
-    GetStringParameter("path", &path);
+    call->GetString("path", &path);
 
-    path = path.substr(Server::GetInstance()->url_base().length());
+    const std::string& url_base = Server::GetInstance()->url_base();
+    if (StartsWithASCII(path, url_base, true))
+        path = path.substr(url_base.length());
 
     std::vector<std::string> path_segments;
     base::SplitString(path, '/', &path_segments);
 
-    const DictionaryValue* parameters = NULL;
-    GetDictionaryParameter("data", &parameters);
-    parameters = parameters->DeepCopy();
-
     std::string matched_route;
     AbstractCommandCreator* cmdCreator =
-        Server::GetInstance()->GetRouteTable().GetRouteForURL(path, &matched_route);
+        Server::GetInstance()->GetRouteTable().GetRouteForURL(path_segments, &matched_route);
     if (NULL == cmdCreator)
     {
         response->SetError(new Error(
@@ -64,6 +106,16 @@ void XDRPCCommand::ExecutePost(Response* const response) {
         return;
     }
 
+    Value* data = NULL;
+    DictionaryValue* parameters = NULL;
+    if (call->RemoveWithoutPathExpansion(kDataKey, &data) &&
+        data->GetAsDictionary(&parameters)) {
+        data = NULL;
+    } else {
+        delete data;
+        parameters = new DictionaryValue();
+    }
+
     Command* command = cmdCreator->create(path_segments, parameters);
 
     Server::GetInstance()->DispatchCommand(
@@ -71,7 +123,6 @@ void XDRPCCommand::ExecutePost(Response* const response) {
         command,
         method,
         response);
-    response->SetStatus(kSuccess);
 
     if (response->GetValue()->IsType(Value::TYPE_STRING)) {
         std::string value;
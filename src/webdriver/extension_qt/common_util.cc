@@ -19,8 +19,31 @@
 
 #include "common_util.h"
 
+#include "webdriver_session.h"
+#include "extension_qt/wd_event_dispatcher.h"
+#include "extension_qt/vncclient.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QCoreApplication>
+#include <QtGui/QImage>
+#include <QtGui/QInputMethodEvent>
+
 namespace webdriver {
 
+namespace {
+
+// how long to wait for first framebuffer update from VNC server
+const int kVncFramebufferTimeoutMs = 5000;
+
+void AppendBigEndian32(quint32 value, std::string* data) {
+    data->push_back(static_cast<char>((value >> 24) & 0xFF));
+    data->push_back(static_cast<char>((value >> 16) & 0xFF));
+    data->push_back(static_cast<char>((value >> 8) & 0xFF));
+    data->push_back(static_cast<char>(value & 0xFF));
+}
+
+}  // namespace
+
 Rect QCommonUtil::ConvertQRectToRect(const QRect &rect) {
     return Rect(rect.x(), rect.y(), rect.width(), rect.height());
 }
@@ -65,10 +88,98 @@ Qt::MouseButton QCommonUtil::ConvertMouseButtonToQtMouseButton(MouseButton butto
     return result;
 }
 
+Qt::MouseButtons QCommonUtil::ConvertMouseButtonsToQtMouseButtons(int buttons) {
+    Qt::MouseButtons result = Qt::NoButton;
+
+    for (int button = kLeftButton; button <= kRightButton; ++button) {
+        if (buttons & (1 << button))
+            result |= ConvertMouseButtonToQtMouseButton(static_cast<MouseButton>(button));
+    }
+
+    return result;
+}
+
+Qt::TouchPointState QCommonUtil::ConvertTouchPointState(InputTouchPoint::State state) {
+    switch (state) {
+        case InputTouchPoint::kPressed: return Qt::TouchPointPressed;
+        case InputTouchPoint::kMoved: return Qt::TouchPointMoved;
+        case InputTouchPoint::kReleased: return Qt::TouchPointReleased;
+        default: return Qt::TouchPointStationary;
+    }
+}
+
+bool QCommonUtil::IsBulkTextInputEnabled(Session* session) {
+    return session->capabilities().bulk_text_input &&
+           WDEventDispatcher::getInstance()->getDispatchers().isEmpty();
+}
+
+void QCommonUtil::SendKeyInputSteps(QObject* target, std::vector<QKeyInputStep>& steps) {
+    std::vector<QKeyInputStep>::iterator step;
+    for (step = steps.begin(); step != steps.end(); ++step) {
+        if (!step->text.isEmpty()) {
+            QInputMethodEvent event;
+            event.setCommitString(step->text);
+            QCoreApplication::sendEvent(target, &event);
+            continue;
+        }
+
+        std::vector<QKeyEvent>::iterator it;
+        for (it = step->key_events.begin(); it != step->key_events.end(); ++it)
+            QCoreApplication::sendEvent(target, &(*it));
+    }
+}
+
 std::string QCommonUtil::GetQtVersion() {
     return QT_VERSION_STR;
 }
 
+bool QCommonUtil::EncodeImage(const QImage& image, ScreenshotFormat format, std::string* data) {
+    if (image.isNull())
+        return false;
+
+    if (kPngScreenshot == format) {
+        QByteArray bytes;
+        QBuffer buffer(&bytes);
+        buffer.open(QIODevice::WriteOnly);
+        if (!image.save(&buffer, "PNG"))
+            return false;
+        data->assign(bytes.constData(), bytes.size());
+        return true;
+    }
+
+    // raw RGBA: 4 bytes magic, width, height, then pixels row by row
+    const QImage argb = image.convertToFormat(QImage::Format_ARGB32);
+    const int width = argb.width();
+    const int height = argb.height();
+
+    data->clear();
+    data->reserve(12 + static_cast<size_t>(width) * height * 4);
+    data->append("RGBA", 4);
+    AppendBigEndian32(width, data);
+    AppendBigEndian32(height, data);
+
+    std::string row(static_cast<size_t>(width) * 4, '\0');
+    for (int y = 0; y < height; ++y) {
+        const QRgb* pixels = reinterpret_cast<const QRgb*>(argb.constScanLine(y));
+        for (int x = 0; x < width; ++x) {
+            row[x * 4] = static_cast<char>(qRed(pixels[x]));
+            row[x * 4 + 1] = static_cast<char>(qGreen(pixels[x]));
+            row[x * 4 + 2] = static_cast<char>(qBlue(pixels[x]));
+            row[x * 4 + 3] = static_cast<char>(qAlpha(pixels[x]));
+        }
+        data->append(row);
+    }
+    return true;
+}
+
+bool QCommonUtil::GrabVncScreen(const QRect& rect, QImage* image) {
+    VNCClient* client = VNCClient::getInstance();
+    if (!client->isReady())
+        return false;
+
+    return client->grabFramebuffer(rect, image, kVncFramebufferTimeoutMs);
+}
+
 QString StringUtil::trimmed(const QString& str, const QString& symbols) {
     int start = 0;
     while (start < str.length() && symbols.contains(str.at(start))) {
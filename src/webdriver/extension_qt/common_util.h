@@ -35,7 +35,10 @@
 #endif
 
 #include "webdriver_basic_types.h"
+#include "webdriver_input_actions.h"
+#include "q_key_converter.h"
 
+class QImage;
 
 namespace webdriver {
 
@@ -49,7 +52,21 @@ public:
     static QPoint ConvertPointToQPoint(const Point &p);
     static QSize ConvertSizeToQSize(const Size &sz);
     static Qt::MouseButton ConvertMouseButtonToQtMouseButton(MouseButton button);
+    /// converts InputAction::buttons mask
+    static Qt::MouseButtons ConvertMouseButtonsToQtMouseButtons(int buttons);
+    static Qt::TouchPointState ConvertTouchPointState(InputTouchPoint::State state);
+    /// Returns true if session asked for bulk text input and no event
+    /// dispatcher (VNC, uinput) has to see every key event.
+    static bool IsBulkTextInputEnabled(Session* session);
+    /// Commits text steps with QInputMethodEvent, sends key events of other steps.
+    static void SendKeyInputSteps(QObject* target, std::vector<QKeyInputStep>& steps);
     static std::string GetQtVersion();
+    /// Encodes image in memory, see ScreenshotFormat for layout of raw format.
+    /// @return false if encoding failed
+    static bool EncodeImage(const QImage& image, ScreenshotFormat format, std::string* data);
+    /// Copies |rect| (global coordinates) from framebuffer of connected VNC server.
+    /// @return false if VNC client is not ready or framebuffer was not received
+    static bool GrabVncScreen(const QRect& rect, QImage* image);
 
 private:
     QCommonUtil() {}
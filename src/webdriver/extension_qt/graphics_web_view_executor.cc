@@ -148,6 +148,10 @@ void GraphicsWebViewCmdExecutor::GetBounds(Rect *bounds, Error **error) {
 }
     
 void GraphicsWebViewCmdExecutor::GetScreenShot(std::string* png, Error** error) {
+    GetScreenShotImage(kPngScreenshot, png, error);
+}
+
+void GraphicsWebViewCmdExecutor::GetScreenShotImage(ScreenshotFormat format, std::string* data, Error** error) {
     CHECK_VIEW_EXISTANCE
     
     QImage image(view_->boundingRect().size().toSize(), QImage::Format_RGB32);
@@ -157,7 +161,8 @@ void GraphicsWebViewCmdExecutor::GetScreenShot(std::string* png, Error** error)
     qobject_cast<QGraphicsObject*>(view_)->paint(&painter, &styleOption);
     painter.end();
 
-    saveScreenshot(image, png, error);
+    if (!QCommonUtil::EncodeImage(image, format, data))
+        *error = new Error(kUnknownError, "screenshot was not captured");
 }
 
 void GraphicsWebViewCmdExecutor::GetElementScreenShot(const ElementId& element, std::string* png, Error** error) {
@@ -200,27 +205,8 @@ void GraphicsWebViewCmdExecutor::GetElementScreenShot(const ElementId& element,
 }
 
 void GraphicsWebViewCmdExecutor::saveScreenshot(QImage& image, std::string* png, Error** error) {
-    const FilePath::CharType kPngFileName[] = FILE_PATH_LITERAL("./screen.png");
-    FilePath path = session_->temp_dir().Append(kPngFileName);;
-
-#if defined(OS_WIN)
-    session_->logger().Log(kInfoLogLevel, "Save screenshot to - " + path.MaybeAsASCII());
-#elif defined(OS_POSIX)
-    session_->logger().Log(kInfoLogLevel, "Save screenshot to - " + path.value());
-#endif
-
-#if defined(OS_POSIX)
-    if (!image.save(path.value().c_str())) 
-#elif defined(OS_WIN)
-    if (!image.save(QString::fromUtf16((ushort*)path.value().c_str())))
-#endif // OS_WIN
-    {
+    if (!QCommonUtil::EncodeImage(image, kPngScreenshot, png))
         *error = new Error(kUnknownError, "screenshot was not captured");
-        return;
-    }
-
-    if (!file_util::ReadFileToString(path, png))
-        *error = new Error(kUnknownError, "Could not read screenshot file");   
 }
 
 void GraphicsWebViewCmdExecutor::GoForward(Error** error) {
@@ -267,6 +253,7 @@ void GraphicsWebViewCmdExecutor::SendKeys(const string16& keys, Error** error) {
 
     session_->set_sticky_modifiers(modifiers);
 
+    WDEventDispatchBatch dispatch_batch;
     std::vector<QKeyEvent>::iterator it = key_events.begin();
     while (it != key_events.end()) {
 
@@ -652,10 +639,10 @@ void GraphicsWebViewCmdExecutor::ExecuteScript(const std::string& script, const
     *error = webkitProxy_->ExecuteScript(script, args, value);
 }
 
-void GraphicsWebViewCmdExecutor::ExecuteAsyncScript(const std::string& script, const base::ListValue* const args, base::Value** value, Error** error) {
+void GraphicsWebViewCmdExecutor::ExecuteAsyncScript(const std::string& script, const base::ListValue* const args, AsyncScriptResult* result, Error** error) {
     CHECK_VIEW_EXISTANCE
 
-    *error = webkitProxy_->ExecuteAsyncScript(script, args, value);
+    *error = webkitProxy_->ExecuteAsyncScript(script, args, result);
 }
 
 void GraphicsWebViewCmdExecutor::GetAppCacheStatus(int* status, Error** error) {
@@ -19,8 +19,16 @@
 
 #include "q_event_filter.h"
 
+#include <QtCore/QMetaObject>
+
+namespace {
+const char kRepaintTrackerName[] = "__wd_repaint_tracker";
+}
+
 QRepaintEventFilter::QRepaintEventFilter(QObject *parent) :
-    QObject(parent)
+    QObject(parent),
+    repaint_count_(0),
+    track_children_(false)
 {
 }
 
@@ -28,11 +36,77 @@ QRepaintEventFilter::~QRepaintEventFilter() {}
 
 bool QRepaintEventFilter::eventFilter(QObject *pobject, QEvent *pevent) {
     if (pevent->type()== QEvent::Paint) {
+        ++repaint_count_;
         emit repainted();
+    } else if (track_children_ && pevent->type() == QEvent::ChildAdded) {
+        QObject* child = static_cast<QChildEvent*>(pevent)->child();
+        if ((NULL != child) && (child != this))
+            installOnTree(child);
     }
     return false;
 }
 
+QRepaintEventFilter* QRepaintEventFilter::trackView(QObject *view) {
+    if (NULL == view)
+        return NULL;
+
+    QRepaintEventFilter* filter = view->findChild<QRepaintEventFilter*>(kRepaintTrackerName);
+    if (NULL != filter)
+        return filter;
+
+    filter = new QRepaintEventFilter(view);
+    filter->setObjectName(kRepaintTrackerName);
+    filter->track_children_ = true;
+
+    if (-1 != view->metaObject()->indexOfSignal("frameSwapped()")) {
+        QObject::connect(view, SIGNAL(frameSwapped()), filter, SLOT(onFrameSwapped()));
+    } else {
+        filter->installOnTree(view);
+    }
+
+    return filter;
+}
+
+bool QRepaintEventFilter::getCachedScreenshot(int format, std::string* data) const {
+    QHash<int, CachedScreenshot>::const_iterator it = screenshots_.find(format);
+    if ((it == screenshots_.end()) || (it->repaint_count != repaint_count_))
+        return false;
+
+    *data = it->data;
+    return true;
+}
+
+void QRepaintEventFilter::setCachedScreenshot(int format, const std::string& data) {
+    // keep only images of current state, older ones will never match
+    QHash<int, CachedScreenshot>::iterator it = screenshots_.begin();
+    while (it != screenshots_.end()) {
+        if (it->repaint_count != repaint_count_)
+            it = screenshots_.erase(it);
+        else
+            ++it;
+    }
+
+    CachedScreenshot& cached = screenshots_[format];
+    cached.repaint_count = repaint_count_;
+    cached.data = data;
+}
+
+void QRepaintEventFilter::onFrameSwapped() {
+    ++repaint_count_;
+    emit repainted();
+}
+
+void QRepaintEventFilter::installOnTree(QObject *object) {
+    // paint events are delivered to widgets only, but ChildAdded is
+    // watched on every object to catch widgets created later
+    object->removeEventFilter(this);
+    object->installEventFilter(this);
+    foreach (QObject* child, object->children()) {
+        if (child != this)
+            installOnTree(child);
+    }
+}
+
 void QCheckPagePaint::pagePainted() {
     is_painting = true;
 }
@@ -20,6 +20,9 @@
 #ifndef Q_EVENT_FILTER_H
 #define Q_EVENT_FILTER_H
 
+#include <string>
+
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/qcoreevent.h>
 
@@ -34,6 +37,37 @@ protected:
 public:
     explicit QRepaintEventFilter(QObject *parent = 0);
     virtual ~QRepaintEventFilter();
+
+    /// number of repaints seen by filter
+    int repaintCount() const { return repaint_count_; }
+
+    /// Returns filter counting repaints of view and all its child widgets.
+    /// Filter is created on first call and lives as child of view.
+    /// Windows that emit frameSwapped() (QQuickWindow) are counted by frames.
+    static QRepaintEventFilter* trackView(QObject *view);
+
+    /// Returns screenshot stored by setCachedScreenshot() in same format
+    /// if view was not repainted since then.
+    bool getCachedScreenshot(int format, std::string* data) const;
+
+    /// Remembers encoded screenshot of current view state. Should be called
+    /// right after grab, as grabbing itself may emit paint events.
+    void setCachedScreenshot(int format, const std::string& data);
+
+private slots:
+    void onFrameSwapped();
+
+private:
+    struct CachedScreenshot {
+        int repaint_count;
+        std::string data;
+    };
+
+    void installOnTree(QObject *object);
+
+    int repaint_count_;
+    bool track_children_;
+    QHash<int, CachedScreenshot> screenshots_;
 };
 
 class QCheckPagePaint : public QObject {
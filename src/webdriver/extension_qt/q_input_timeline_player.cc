@@ -0,0 +1,84 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#include "q_input_timeline_player.h"
+
+#include "webdriver_error.h"
+
+#include <QtCore/QTimerEvent>
+
+namespace webdriver {
+
+QInputTimelinePlayer::QInputTimelinePlayer(const InputTimeline& timeline, const DispatchCallback& dispatch)
+    : timeline_(timeline),
+      dispatch_(dispatch),
+      next_(0),
+      timer_id_(0),
+      error_(NULL) {}
+
+QInputTimelinePlayer::~QInputTimelinePlayer() {
+    if (timer_id_)
+        killTimer(timer_id_);
+}
+
+void QInputTimelinePlayer::Play(Error** error) {
+    clock_.start();
+    DispatchDueActions();
+
+    if (!error_ && next_ < timeline_.size())
+        loop_.exec();
+
+    *error = error_;
+}
+
+void QInputTimelinePlayer::timerEvent(QTimerEvent* event) {
+    if (event->timerId() != timer_id_) {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    killTimer(timer_id_);
+    timer_id_ = 0;
+    DispatchDueActions();
+}
+
+void QInputTimelinePlayer::DispatchDueActions() {
+    const qint64 elapsed = clock_.elapsed();
+
+    while (next_ < timeline_.size() && timeline_[next_].time <= elapsed) {
+        dispatch_.Run(timeline_[next_], &error_);
+        ++next_;
+        if (error_)
+            break;
+    }
+
+    if (error_ || next_ >= timeline_.size()) {
+        loop_.quit();
+        return;
+    }
+
+    int wait = static_cast<int>(timeline_[next_].time - elapsed);
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+    timer_id_ = startTimer(wait, Qt::PreciseTimer);
+#else
+    timer_id_ = startTimer(wait);
+#endif
+}
+
+}  // namespace webdriver
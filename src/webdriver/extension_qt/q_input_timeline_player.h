@@ -0,0 +1,67 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef Q_INPUT_TIMELINE_PLAYER_H
+#define Q_INPUT_TIMELINE_PLAYER_H
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "webdriver_input_actions.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QObject>
+
+namespace webdriver {
+
+class Error;
+
+/// Dispatches events of input timeline at their timestamps. Whole timeline
+/// is played within single event loop driven by one precise timer, so view
+/// keeps processing events between steps and timing doesn't drift.
+class QInputTimelinePlayer : public QObject {
+public:
+    typedef base::Callback<void(const InputAction&, Error**)> DispatchCallback;
+
+    QInputTimelinePlayer(const InputTimeline& timeline, const DispatchCallback& dispatch);
+    virtual ~QInputTimelinePlayer();
+
+    /// Returns when last event is dispatched or dispatch failed.
+    void Play(Error** error);
+
+protected:
+    virtual void timerEvent(QTimerEvent* event);
+
+private:
+    void DispatchDueActions();
+
+    const InputTimeline& timeline_;
+    DispatchCallback dispatch_;
+    size_t next_;
+    int timer_id_;
+    Error* error_;
+    QElapsedTimer clock_;
+    QEventLoop loop_;
+
+    DISALLOW_COPY_AND_ASSIGN(QInputTimelinePlayer);
+};
+
+}  // namespace webdriver
+
+#endif  // Q_INPUT_TIMELINE_PLAYER_H
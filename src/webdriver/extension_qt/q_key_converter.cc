@@ -349,6 +349,85 @@ bool QKeyConverter::ConvertKeysToWebKeyEvents(const string16& client_keys,
     return true;
 }
 
+bool QKeyConverter::IsPlainTextKey(char16 key) {
+    // control characters and WebDriver special keys (private use area)
+    // need key events
+    if (key < 0x20U || key == 0x7FU)
+        return false;
+    return (key < 0xE000U) || (key > 0xF8FFU);
+}
+
+bool QKeyConverter::ConvertKeysToInputSteps(const string16& client_keys,
+                               const Logger& logger,
+                               bool release_modifiers,
+                               int* modifiers,
+                               std::vector<QKeyInputStep>* steps,
+                               std::string* error_msg) {
+    std::vector<QKeyInputStep> result;
+    int sticky_modifiers = *modifiers;
+    size_t i = 0, size = client_keys.size();
+
+    while (i < size) {
+        size_t end = i;
+        if (Qt::NoModifier == sticky_modifiers) {
+            while (end < size && IsPlainTextKey(client_keys[end]))
+                ++end;
+        }
+
+        if (end > i) {
+            QKeyInputStep step;
+            step.text = QString::fromUtf16(reinterpret_cast<const ushort*>(client_keys.data() + i),
+                                           static_cast<int>(end - i));
+            result.push_back(step);
+            i = end;
+            continue;
+        }
+
+        // special key, or any key while modifier is held
+        if (result.empty() || !result.back().text.isEmpty())
+            result.push_back(QKeyInputStep());
+
+        std::vector<QKeyEvent> key_events;
+        if (!ConvertKeysToWebKeyEvents(client_keys.substr(i, 1), logger, false,
+                                       &sticky_modifiers, &key_events, error_msg))
+            return false;
+        std::vector<QKeyEvent>& step_events = result.back().key_events;
+        step_events.insert(step_events.end(), key_events.begin(), key_events.end());
+        ++i;
+    }
+
+    if (release_modifiers && Qt::NoModifier != sticky_modifiers) {
+        QKeyInputStep step;
+        if (!ConvertKeysToWebKeyEvents(string16(), logger, true,
+                                       &sticky_modifiers, &step.key_events, error_msg))
+            return false;
+        result.push_back(step);
+    }
+
+    steps->swap(result);
+    *modifiers = sticky_modifiers;
+    return true;
+}
+
+bool QKeyConverter::ConvertKeyActionToKeyEvents(const string16& key,
+                               bool key_down,
+                               const Logger& logger,
+                               int* modifiers,
+                               std::vector<QKeyEvent>* client_key_events,
+                               std::string* error_msg) {
+    std::vector<QKeyEvent> key_events;
+    if (!ConvertKeysToWebKeyEvents(key, logger, false, modifiers, &key_events, error_msg))
+        return false;
+
+    // conversion gives press and release for each key, keep only one half
+    QEvent::Type type = key_down ? QEvent::KeyPress : QEvent::KeyRelease;
+    std::vector<QKeyEvent>::const_iterator it;
+    for (it = key_events.begin(); it != key_events.end(); ++it) {
+        if (it->type() == type)
+            client_key_events->push_back(*it);
+    }
+    return true;
+}
 
 
 }  // namespace webdriver
@@ -16,6 +16,13 @@ namespace webdriver {
 
 class Logger;
 
+/// Part of key sequence: plain text that can be committed at once with
+/// QInputMethodEvent, or key events for special keys and modified input.
+struct QKeyInputStep {
+    QString text;
+    std::vector<QKeyEvent> key_events;
+};
+
 class QKeyConverter {
 public:
 
@@ -31,6 +38,24 @@ public:
                                int* modifiers,
                                std::vector<QKeyEvent>* client_key_events,
                                std::string* error_msg);
+
+    /// Converts |key| of W3C keyDown/keyUp action into press or release
+    /// events. Modifier keys toggle |modifiers| same way as above.
+    static bool ConvertKeyActionToKeyEvents(const string16& key,
+                               bool key_down,
+                               const Logger& logger,
+                               int* modifiers,
+                               std::vector<QKeyEvent>* client_key_events,
+                               std::string* error_msg);
+    /// Same as ConvertKeysToWebKeyEvents, but runs of printable characters
+    /// typed without modifiers are returned as text steps instead of
+    /// press/release pair per character.
+    static bool ConvertKeysToInputSteps(const string16& client_keys,
+                               const Logger& logger,
+                               bool release_modifiers,
+                               int* modifiers,
+                               std::vector<QKeyInputStep>* steps,
+                               std::string* error_msg);
 private:
     QKeyConverter() {};
     ~QKeyConverter() {};
@@ -44,6 +69,7 @@ private:
     static const Qt::Key kSpecialWebDriverKeys[];
 
     static bool IsModifierKey(char16 key);
+    static bool IsPlainTextKey(char16 key);
     static bool KeyCodeFromSpecialWebDriverKey(char16 key, Qt::Key* key_code);
     static bool KeyCodeFromShorthandKey(char16 key_utf16,
                              Qt::Key* key_code,
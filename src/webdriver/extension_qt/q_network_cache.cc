@@ -0,0 +1,167 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#include "q_network_cache.h"
+
+#include "webdriver_server.h"
+#include "webdriver_switches.h"
+#include "webdriver_logging.h"
+
+#include "base/command_line.h"
+#include "base/file_path.h"
+#include "base/string_number_conversions.h"
+
+#include <QtCore/QDateTime>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkDiskCache>
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+#include <QtWidgets/QGraphicsView>
+#include <QtWebKitWidgets/QWebView>
+#include <QtWebKitWidgets/QGraphicsWebView>
+#else
+#include <QtGui/QGraphicsView>
+#include <QtWebKit/QWebView>
+#include <QtWebKit/QGraphicsWebView>
+#endif
+
+namespace webdriver {
+
+namespace {
+
+const int64 kDefaultCacheSize = 50 * 1024 * 1024;
+
+}  // namespace
+
+void QSharedNetworkCache::Install(QNetworkAccessManager* manager) {
+    if (NULL == manager || NULL != manager->cache())
+        return;
+
+    bool offline = false;
+    QNetworkDiskCache* disk_cache = GetDiskCache(&offline);
+    if (NULL == disk_cache)
+        return;
+
+    // manager takes ownership
+    manager->setCache(new QSharedNetworkCache(disk_cache, offline, manager));
+}
+
+void QSharedNetworkCache::InstallForWidget(QWidget* widget) {
+    QWebView* web_view = qobject_cast<QWebView*>(widget);
+    if (NULL != web_view) {
+        Install(web_view->page()->networkAccessManager());
+        return;
+    }
+
+    QGraphicsView* graphics_view = qobject_cast<QGraphicsView*>(widget);
+    if (NULL != graphics_view) {
+        foreach(QGraphicsItem* item, graphics_view->items()) {
+            QGraphicsWebView* graphics_web_view = qobject_cast<QGraphicsWebView*>(item->toGraphicsObject());
+            if (NULL != graphics_web_view)
+                Install(graphics_web_view->page()->networkAccessManager());
+        }
+    }
+}
+
+QSharedNetworkCache::QSharedNetworkCache(QNetworkDiskCache* disk_cache, bool offline, QObject* parent)
+    : QAbstractNetworkCache(parent),
+      disk_cache_(disk_cache),
+      offline_(offline) {}
+
+QSharedNetworkCache::~QSharedNetworkCache() {}
+
+QNetworkCacheMetaData QSharedNetworkCache::metaData(const QUrl& url) {
+    QNetworkCacheMetaData meta_data = disk_cache_->metaData(url);
+    if (!offline_ || !meta_data.isValid())
+        return meta_data;
+
+    // Drop directives which force revalidation and push expiration date
+    // forward, QNetworkAccessManager will treat entry as fresh.
+    QNetworkCacheMetaData::RawHeaderList headers;
+    foreach(const QNetworkCacheMetaData::RawHeader& header, meta_data.rawHeaders()) {
+        const QByteArray name = header.first.toLower();
+        if (name == "cache-control" || name == "pragma" || name == "expires")
+            continue;
+        headers.append(header);
+    }
+    meta_data.setRawHeaders(headers);
+    meta_data.setExpirationDate(QDateTime::currentDateTime().addYears(1));
+    return meta_data;
+}
+
+void QSharedNetworkCache::updateMetaData(const QNetworkCacheMetaData& metaData) {
+    disk_cache_->updateMetaData(metaData);
+}
+
+QIODevice* QSharedNetworkCache::data(const QUrl& url) {
+    return disk_cache_->data(url);
+}
+
+bool QSharedNetworkCache::remove(const QUrl& url) {
+    return disk_cache_->remove(url);
+}
+
+qint64 QSharedNetworkCache::cacheSize() const {
+    return disk_cache_->cacheSize();
+}
+
+QIODevice* QSharedNetworkCache::prepare(const QNetworkCacheMetaData& metaData) {
+    return disk_cache_->prepare(metaData);
+}
+
+void QSharedNetworkCache::insert(QIODevice* device) {
+    disk_cache_->insert(device);
+}
+
+void QSharedNetworkCache::clear() {
+    disk_cache_->clear();
+}
+
+QNetworkDiskCache* QSharedNetworkCache::GetDiskCache(bool* offline) {
+    // Accessed from GUI thread only. Cache lives until process exit.
+    static bool initialized = false;
+    static bool offline_replay = false;
+    static QNetworkDiskCache* disk_cache = NULL;
+
+    if (!initialized) {
+        initialized = true;
+
+        CommandLine cmd_line = Server::GetInstance()->GetCommandLine();
+        if (cmd_line.HasSwitch(Switches::kHttpCacheDir)) {
+            int64 max_size = kDefaultCacheSize;
+            if (cmd_line.HasSwitch(Switches::kHttpCacheSize))
+                base::StringToInt64(cmd_line.GetSwitchValueASCII(Switches::kHttpCacheSize), &max_size);
+            offline_replay = cmd_line.HasSwitch(Switches::kHttpCacheOffline);
+
+            const std::string directory =
+                cmd_line.GetSwitchValuePath(Switches::kHttpCacheDir).AsUTF8Unsafe();
+            disk_cache = new QNetworkDiskCache();
+            disk_cache->setCacheDirectory(QString::fromUtf8(directory.c_str()));
+            disk_cache->setMaximumCacheSize(max_size);
+
+            GlobalLogger::Log(kInfoLogLevel, "HTTP cache: " + directory +
+                              ", max size " + base::Int64ToString(max_size) +
+                              (offline_replay ? ", offline replay" : ""));
+        }
+    }
+
+    *offline = offline_replay;
+    return disk_cache;
+}
+
+}  // namespace webdriver
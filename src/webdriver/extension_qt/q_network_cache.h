@@ -0,0 +1,74 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef WEBDRIVER_Q_NETWORK_CACHE_H_
+#define WEBDRIVER_Q_NETWORK_CACHE_H_
+
+#include <QtNetwork/QAbstractNetworkCache>
+
+class QNetworkAccessManager;
+class QNetworkDiskCache;
+class QWidget;
+
+namespace webdriver {
+
+/// Per-manager front end of process-wide on-disk HTTP cache.
+/// QNetworkAccessManager takes ownership of its cache, so one
+/// QNetworkDiskCache can't be set to several managers directly. Each
+/// manager gets own QSharedNetworkCache instead, which forwards all calls
+/// to shared disk cache configured by http-cache-* server switches.
+class QSharedNetworkCache : public QAbstractNetworkCache {
+public:
+    /// Sets shared cache to |manager| if cache is enabled. Manager which
+    /// already has a cache is left intact.
+    static void Install(QNetworkAccessManager* manager);
+
+    /// Sets shared cache to network managers of web views hosted by
+    /// |widget|, either QWebView or QGraphicsView with QGraphicsWebView items.
+    static void InstallForWidget(QWidget* widget);
+
+    virtual ~QSharedNetworkCache();
+
+    /// In offline replay mode returned meta data is altered to look fresh,
+    /// so cached response is used without revalidation on server.
+    virtual QNetworkCacheMetaData metaData(const QUrl& url);
+    virtual void updateMetaData(const QNetworkCacheMetaData& metaData);
+    virtual QIODevice* data(const QUrl& url);
+    virtual bool remove(const QUrl& url);
+    virtual qint64 cacheSize() const;
+    virtual QIODevice* prepare(const QNetworkCacheMetaData& metaData);
+    virtual void insert(QIODevice* device);
+    virtual void clear();
+
+private:
+    QSharedNetworkCache(QNetworkDiskCache* disk_cache, bool offline, QObject* parent);
+
+    // Returns process-wide disk cache, creates it on first call.
+    // Returns NULL if cache is not enabled.
+    static QNetworkDiskCache* GetDiskCache(bool* offline);
+
+    QNetworkDiskCache* disk_cache_;
+    bool offline_;
+
+    Q_DISABLE_COPY(QSharedNetworkCache)
+};
+
+}  // namespace webdriver
+
+#endif  // WEBDRIVER_Q_NETWORK_CACHE_H_
@@ -19,12 +19,15 @@
 
 #include "extension_qt/q_view_executor.h"
 
+#include "base/bind.h"
 #include "webdriver_logging.h"
 #include "webdriver_session.h"
 #include "q_key_converter.h"
+#include "q_input_timeline_player.h"
 #include "extension_qt/widget_view_handle.h"
 #include "widget_view_util.h"
 #include "common_util.h"
+#include "q_event_filter.h"
 #include "extension_qt/event_dispatcher.h"
 #include "extension_qt/wd_event_dispatcher.h"
 
@@ -125,10 +128,41 @@ void QViewCmdExecutor::Maximize(Error** error) {
 }
 
 void QViewCmdExecutor::GetScreenShot(std::string* png, Error** error) {
+    GetScreenShotImage(kPngScreenshot, png, error);
+}
+
+void QViewCmdExecutor::GetScreenShotImage(ScreenshotFormat format, std::string* data, Error** error) {
     QWidget* view = getView(view_id_, error);
     if (NULL == view)
         return;
 
+    if (kVncScreenshotSource == session_->capabilities().screenshot_source) {
+        // VNC framebuffer is updated outside of Qt, repaint count can't be used
+        QImage image;
+        QRect rect(view->mapToGlobal(QPoint(0, 0)), view->size());
+        if (!QCommonUtil::GrabVncScreen(rect, &image)) {
+            *error = new Error(kUnknownError, "can't grab screen from VNC server");
+            return;
+        }
+        if (!QCommonUtil::EncodeImage(image, format, data))
+            *error = new Error(kUnknownError, "screenshot was not captured");
+        return;
+    }
+
+    // hidden or minimized view isn't painted, so its repaint count can't
+    // tell whether content changed
+    QRepaintEventFilter* tracker = NULL;
+    if (session_->capabilities().reuse_screenshots &&
+        view->isVisible() && !view->isMinimized()) {
+        tracker = QRepaintEventFilter::trackView(view);
+        // paint pending update() calls, so they are counted before compare
+        QCoreApplication::sendPostedEvents(view->window(), QEvent::UpdateRequest);
+        if (tracker->getCachedScreenshot(format, data)) {
+            session_->logger().Log(kFineLogLevel, "GetScreenShot - view not repainted, reuse last screenshot");
+            return;
+        }
+    }
+
     QPixmap pixmap;
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
     pixmap = view->grab();
@@ -136,31 +170,26 @@ void QViewCmdExecutor::GetScreenShot(std::string* png, Error** error) {
     pixmap = QPixmap::grabWidget(view);
 #endif
 
-    saveScreenshot(pixmap, png, error);
+    if (!QCommonUtil::EncodeImage(pixmap.toImage(), format, data)) {
+        *error = new Error(kUnknownError, "screenshot was not captured");
+        return;
+    }
+
+    if (NULL != tracker)
+        tracker->setCachedScreenshot(format, *data);
 }
 
-void QViewCmdExecutor::saveScreenshot(QPixmap& pixmap, std::string* png, Error** error) {
-    const FilePath::CharType kPngFileName[] = FILE_PATH_LITERAL("./screen.png");
-    FilePath path = session_->temp_dir().Append(kPngFileName);;
+void QViewCmdExecutor::GetRepaintCount(int* count, Error** error) {
+    QWidget* view = getView(view_id_, error);
+    if (NULL == view)
+        return;
 
-#if defined(OS_WIN)
-    session_->logger().Log(kInfoLogLevel, "Save screenshot to - " + path.MaybeAsASCII());
-#elif defined(OS_POSIX)
-    session_->logger().Log(kInfoLogLevel, "Save screenshot to - " + path.value());
-#endif
+    *count = QRepaintEventFilter::trackView(view)->repaintCount();
+}
 
-#if defined(OS_POSIX)
-    if (!pixmap.save(path.value().c_str())) 
-#elif defined(OS_WIN)
-    if (!pixmap.save(QString::fromUtf16((ushort*)path.value().c_str())))
-#endif // OS_WIN
-    {
+void QViewCmdExecutor::saveScreenshot(QPixmap& pixmap, std::string* png, Error** error) {
+    if (!QCommonUtil::EncodeImage(pixmap.toImage(), kPngScreenshot, png))
         *error = new Error(kUnknownError, "screenshot was not captured");
-        return;
-    }
-
-    if (!file_util::ReadFileToString(path, png))
-        *error = new Error(kUnknownError, "Could not read screenshot file");   
 }
 
 void QViewCmdExecutor::SendKeys(const string16& keys, Error** error) {
@@ -172,6 +201,22 @@ void QViewCmdExecutor::SendKeys(const string16& keys, Error** error) {
     std::vector<QKeyEvent> key_events;
     int modifiers = session_->get_sticky_modifiers();
 
+    QWidget* focusWidget = view->focusWidget();
+    if (QCommonUtil::IsBulkTextInputEnabled(session_) && (NULL != focusWidget) &&
+        focusWidget->testAttribute(Qt::WA_InputMethodEnabled)) {
+        std::vector<QKeyInputStep> steps;
+        if (!QKeyConverter::ConvertKeysToInputSteps(keys, session_->logger(), false,
+                                                    &modifiers, &steps, &err_msg)) {
+            session_->logger().Log(kSevereLogLevel, "SendKeys - cant convert keys:"+err_msg);
+            *error = new Error(kUnknownError, "SendKeys - cant convert keys:"+err_msg);
+            return;
+        }
+
+        session_->set_sticky_modifiers(modifiers);
+        QCommonUtil::SendKeyInputSteps(focusWidget, steps);
+        return;
+    }
+
     if (!QKeyConverter::ConvertKeysToWebKeyEvents(keys,
                                session_->logger(),
                                false,
@@ -185,6 +230,7 @@ void QViewCmdExecutor::SendKeys(const string16& keys, Error** error) {
 
     session_->set_sticky_modifiers(modifiers);
 
+    WDEventDispatchBatch dispatch_batch;
     std::vector<QKeyEvent>::iterator it = key_events.begin();
     while (it != key_events.end()) {
 
@@ -196,6 +242,121 @@ void QViewCmdExecutor::SendKeys(const string16& keys, Error** error) {
     }
 }
 
+void QViewCmdExecutor::PlayInputTimeline(const InputTimeline& timeline, Error** error) {
+    QWidget* view = getView(view_id_, error);
+    if (NULL == view)
+        return;
+
+    QInputTimelinePlayer player(timeline, base::Bind(&QViewCmdExecutor::DispatchInputAction, base::Unretained(this)));
+    player.Play(error);
+}
+
+void QViewCmdExecutor::DispatchInputAction(const InputAction& action, Error** error) {
+    // view can be closed by one of previous events
+    QWidget* view = getView(view_id_, error);
+    if (NULL == view)
+        return;
+
+    if (InputAction::kKeyDown == action.type || InputAction::kKeyUp == action.type) {
+        std::string err_msg;
+        std::vector<QKeyEvent> key_events;
+        int modifiers = session_->get_sticky_modifiers();
+
+        if (!QKeyConverter::ConvertKeyActionToKeyEvents(action.key,
+                                   InputAction::kKeyDown == action.type,
+                                   session_->logger(),
+                                   &modifiers,
+                                   &key_events,
+                                   &err_msg)) {
+            *error = new Error(kUnknownError, "Actions - cant convert key:"+err_msg);
+            return;
+        }
+
+        session_->set_sticky_modifiers(modifiers);
+
+        WDEventDispatchBatch dispatch_batch;
+        std::vector<QKeyEvent>::iterator it = key_events.begin();
+        while (it != key_events.end()) {
+            bool consumed = WDEventDispatcher::getInstance()->dispatch(&(*it));
+
+            if (!consumed)
+                qApp->sendEvent(view, &(*it));
+            ++it;
+        }
+        return;
+    }
+
+    if (InputAction::kTouch == action.type) {
+        QList<QTouchEvent::TouchPoint> points;
+        Qt::TouchPointStates states = 0;
+        bool all_pressed = true, all_released = true;
+
+        if (touch_receiver_.isNull() && !action.touch_points.empty()) {
+            QPoint first = QCommonUtil::ConvertPointToQPoint(action.touch_points.front().position);
+            touch_receiver_ = view->childAt(first);
+            if (touch_receiver_.isNull())
+                touch_receiver_ = view;
+        }
+
+        std::vector<InputTouchPoint>::const_iterator it;
+        for (it = action.touch_points.begin(); it != action.touch_points.end(); ++it) {
+            Qt::TouchPointState state = QCommonUtil::ConvertTouchPointState(it->state);
+            QPointF point = touch_receiver_->mapFrom(view, QCommonUtil::ConvertPointToQPoint(it->position));
+            points.append(createTouchPointWithId(state, point, it->id));
+            points.last().setScreenPos(QPointF(touch_receiver_->mapToGlobal(QPoint(0, 0))) + point);
+            states |= state;
+            all_pressed = all_pressed && (InputTouchPoint::kPressed == it->state);
+            all_released = all_released && (InputTouchPoint::kReleased == it->state);
+        }
+
+        QEvent::Type type = QEvent::TouchUpdate;
+        if (all_pressed)
+            type = QEvent::TouchBegin;
+        else if (all_released)
+            type = QEvent::TouchEnd;
+
+        // OS level dispatchers (e.g. uinput) may inject event instead of Qt
+        QTouchEvent* touchEvent = createTouchEvent(type, states, points);
+        if (WDEventDispatcher::getInstance()->dispatch(touchEvent))
+            delete touchEvent;
+        else
+            QApplication::postEvent(touch_receiver_.data(), touchEvent);
+        if (QEvent::TouchEnd == type)
+            touch_receiver_.clear();
+        return;
+    }
+
+    QPoint point = QCommonUtil::ConvertPointToQPoint(action.position);
+
+    // Find child widget that will receive event
+    QWidget *receiverWidget = view->childAt(point);
+    if (NULL != receiverWidget) {
+        point = receiverWidget->mapFrom(view, point);
+    } else {
+        receiverWidget = view;
+    }
+
+    QPoint globalPos = receiverWidget->mapToGlobal(point);
+    Qt::MouseButtons buttons = QCommonUtil::ConvertMouseButtonsToQtMouseButtons(action.buttons);
+    Qt::KeyboardModifiers modifiers(session_->get_sticky_modifiers());
+
+    QEvent::Type type = QEvent::MouseMove;
+    Qt::MouseButton button = Qt::NoButton;
+    if (InputAction::kPointerDown == action.type) {
+        type = QEvent::MouseButtonPress;
+        button = QCommonUtil::ConvertMouseButtonToQtMouseButton(action.button);
+    } else if (InputAction::kPointerUp == action.type) {
+        type = QEvent::MouseButtonRelease;
+        button = QCommonUtil::ConvertMouseButtonToQtMouseButton(action.button);
+    }
+
+    QMouseEvent* mouseEvent = new QMouseEvent(type, point, globalPos, button, buttons, modifiers);
+    if (WDEventDispatcher::getInstance()->dispatch(mouseEvent))
+        delete mouseEvent;
+    else
+        QApplication::postEvent(receiverWidget, mouseEvent);
+}
+
 void QViewCmdExecutor::Close(Error** error) {
     QWidget* view = getView(view_id_, error);
     if (NULL == view)
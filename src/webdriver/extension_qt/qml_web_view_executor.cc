@@ -157,6 +157,10 @@ void QmlWebViewCmdExecutor::GetBounds(Rect *bounds, Error **error) {
 }
     
 void QmlWebViewCmdExecutor::GetScreenShot(std::string* png, Error** error) {
+    GetScreenShotImage(kPngScreenshot, png, error);
+}
+
+void QmlWebViewCmdExecutor::GetScreenShotImage(ScreenshotFormat format, std::string* data, Error** error) {
     CHECK_VIEW_EXISTANCE
     
     QImage image(view_->boundingRect().size().toSize(), QImage::Format_RGB32);
@@ -166,27 +170,8 @@ void QmlWebViewCmdExecutor::GetScreenShot(std::string* png, Error** error) {
     qobject_cast<QGraphicsObject*>(view_)->paint(&painter, &styleOption);
     painter.end();
 
-    const FilePath::CharType kPngFileName[] = FILE_PATH_LITERAL("./screen.png");
-    FilePath path = session_->temp_dir().Append(kPngFileName);;
-
-#if defined(OS_WIN)
-    session_->logger().Log(kInfoLogLevel, "Save screenshot to - " + path.MaybeAsASCII());
-#elif defined(OS_POSIX)
-    session_->logger().Log(kInfoLogLevel, "Save screenshot to - " + path.value());
-#endif
-
-#if defined(OS_POSIX)
-    if (!image.save(path.value().c_str())) 
-#elif defined(OS_WIN)
-    if (!image.save(QString::fromUtf16((ushort*)path.value().c_str())))
-#endif // OS_WIN
-    {
+    if (!QCommonUtil::EncodeImage(image, format, data))
         *error = new Error(kUnknownError, "screenshot was not captured");
-        return;
-    }
-
-    if (!file_util::ReadFileToString(path, png))
-        *error = new Error(kUnknownError, "Could not read screenshot file");
 }
 
 void QmlWebViewCmdExecutor::GoForward(Error** error) {
@@ -233,6 +218,7 @@ void QmlWebViewCmdExecutor::SendKeys(const string16& keys, Error** error) {
 
     session_->set_sticky_modifiers(modifiers);
 
+    WDEventDispatchBatch dispatch_batch;
     std::vector<QKeyEvent>::iterator it = key_events.begin();
     while (it != key_events.end()) {
 
@@ -618,10 +604,10 @@ void QmlWebViewCmdExecutor::ExecuteScript(const std::string& script, const base:
     *error = webkitProxy_->ExecuteScript(script, args, value);
 }
 
-void QmlWebViewCmdExecutor::ExecuteAsyncScript(const std::string& script, const base::ListValue* const args, base::Value** value, Error** error) {
+void QmlWebViewCmdExecutor::ExecuteAsyncScript(const std::string& script, const base::ListValue* const args, AsyncScriptResult* result, Error** error) {
     CHECK_VIEW_EXISTANCE
 
-    *error = webkitProxy_->ExecuteAsyncScript(script, args, value);
+    *error = webkitProxy_->ExecuteAsyncScript(script, args, result);
 }
 
 void QmlWebViewCmdExecutor::GetAppCacheStatus(int* status, Error** error) {
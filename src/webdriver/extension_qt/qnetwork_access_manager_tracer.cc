@@ -30,8 +30,43 @@
 #include <QtCore/QThread>
 #include <QtNetwork/QNetworkReply>
 
+namespace {
+
+// Set on blocked replies, they are logged when blocked and not when finished.
+const char kBlockedReplyProperty[] = "webdriverBlockedReply";
+
+// Empty failed reply for requests blocked by session's network rules,
+// finishes on next event loop iteration without touching network.
+class BlockedNetworkReply : public QNetworkReply {
+public:
+    BlockedNetworkReply(QNetworkAccessManager::Operation op,
+                        const QNetworkRequest& request,
+                        QObject* parent)
+        : QNetworkReply(parent) {
+        setRequest(request);
+        setUrl(request.url());
+        setOperation(op);
+        setProperty(kBlockedReplyProperty, true);
+        setError(QNetworkReply::ContentAccessDenied, "Blocked by networkRules capability");
+        open(QIODevice::ReadOnly);
+        setFinished(true);
+        QMetaObject::invokeMethod(this, "finished", Qt::QueuedConnection);
+    }
+
+    virtual void abort() {}
+
+protected:
+    virtual qint64 readData(char*, qint64) {
+        return -1;
+    }
+};
+
+}  // namespace
+
 QNetworkAccessManagerTracer::QNetworkAccessManagerTracer(webdriver::Session* session, QObject* parent)
-    :  QNetworkAccessManager(parent), session_(session) {
+    :  QNetworkAccessManager(parent), session_(session),
+       blocked_count_(0), rewritten_count_(0) {
+    connect(this, SIGNAL(finished(QNetworkReply*)), this, SLOT(writeReply(QNetworkReply*)));
 }
 
 QNetworkAccessManagerTracer::~QNetworkAccessManagerTracer() { }
@@ -39,21 +74,64 @@ QNetworkAccessManagerTracer::~QNetworkAccessManagerTracer() { }
 QNetworkReply* QNetworkAccessManagerTracer::createRequest(QNetworkAccessManager::Operation op, const QNetworkRequest &req, QIODevice *outgoingData) {
 
     timeStamp_ = static_cast<double>(base::TimeTicks::NowFromSystemTraceTime().ToInternalValue());
-    QNetworkReply* reply = QNetworkAccessManager::createRequest(op, req, outgoingData);
-    connect(this, SIGNAL(finished(QNetworkReply*)), this, SLOT(writeReply(QNetworkReply*)));
+
+    QNetworkRequest request(req);
+    const webdriver::NetworkRules& rules = session_->capabilities().network_rules;
+    if (!rules.empty()) {
+        const QByteArray url = req.url().toEncoded();
+        std::string rewritten_url;
+        switch (rules.Match(std::string(url.constData(), url.size()),
+                            req.url().host().toStdString(),
+                            &rewritten_url)) {
+        case webdriver::NetworkRules::kBlockRequest:
+            ++blocked_count_;
+            addLogEntry(webdriver::kInfoLogLevel, getMethod(op), "BLOCKED",
+                        req.url().path().toStdString());
+            return new BlockedNetworkReply(op, req, this);
+        case webdriver::NetworkRules::kRewriteRequest:
+            ++rewritten_count_;
+            request.setUrl(QUrl::fromEncoded(QByteArray(rewritten_url.c_str())));
+            break;
+        default:
+            break;
+        }
+    }
+
+    QNetworkReply* reply = QNetworkAccessManager::createRequest(op, request, outgoingData);
+
+    replies_in_flight_.insert(reply);
+    connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    connect(reply, SIGNAL(destroyed(QObject*)), this, SLOT(replyDestroyed(QObject*)));
+    emit requestStarted();
 
     return reply;
 }
 
+int QNetworkAccessManagerTracer::requestsInFlight() const {
+    return replies_in_flight_.size();
+}
+
+void QNetworkAccessManagerTracer::replyFinished() {
+    removeReplyInFlight(sender());
+}
+
+void QNetworkAccessManagerTracer::replyDestroyed(QObject* reply) {
+    // Reply may be deleted by its owner without ever finishing.
+    removeReplyInFlight(reply);
+}
+
+void QNetworkAccessManagerTracer::removeReplyInFlight(QObject* reply) {
+    if (replies_in_flight_.remove(reply) && replies_in_flight_.isEmpty())
+        emit networkIdle();
+}
+
 void QNetworkAccessManagerTracer::writeReply(QNetworkReply *reply) {
-    webdriver::LogLevel level = session_->GetMinPerfLogLevel();
+    if (reply->property(kBlockedReplyProperty).toBool())
+        return;
 
-    double thread_timestamp = static_cast<double>((base::TimeTicks::IsThreadNowSupported() ?
-              base::TimeTicks::ThreadNow() : base::TimeTicks()).ToInternalValue());
+    webdriver::LogLevel level = session_->GetMinPerfLogLevel();
 
     std::string file = reply->url().path().toStdString();
-    // delete '/' in the beginning:
-    file.erase(0, 1);
 
     //HTTP status code
     QVariant statusCode = reply->attribute( QNetworkRequest::HttpStatusCodeAttribute );
@@ -70,9 +148,27 @@ void QNetworkAccessManagerTracer::writeReply(QNetworkReply *reply) {
         }
         reason = reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toString();
     }
+    addLogEntry(level, getMethod(reply->operation()), reason.toStdString(), file);
+}
+
+void QNetworkAccessManagerTracer::addLogEntry(webdriver::LogLevel level,
+                                              const std::string& method,
+                                              const std::string& status,
+                                              const std::string& path) {
+    // tracer may be installed only for networkRules or networkIdle loading
+    if (session_->GetMinPerfLogLevel() == webdriver::kOffLogLevel)
+        return;
+
+    double thread_timestamp = static_cast<double>((base::TimeTicks::IsThreadNowSupported() ?
+              base::TimeTicks::ThreadNow() : base::TimeTicks()).ToInternalValue());
+
+    std::string file = path;
+    // delete '/' in the beginning:
+    file.erase(0, 1);
+
     base::DictionaryValue* args_entry = new base::DictionaryValue();
-    args_entry->SetString("method", getMethod(reply->operation()));
-    args_entry->SetString("status", reason.toStdString());
+    args_entry->SetString("method", method);
+    args_entry->SetString("status", status);
     args_entry->SetString("file", file);
 
     base::DictionaryValue* message_entry = new base::DictionaryValue();
@@ -80,6 +176,8 @@ void QNetworkAccessManagerTracer::writeReply(QNetworkReply *reply) {
     message_entry->SetDouble("ts", timeStamp_);
     message_entry->SetInteger("tid", static_cast<int>(base::PlatformThread::CurrentId()));
     message_entry->SetDouble("tts", thread_timestamp);
+    message_entry->SetInteger("blocked", blocked_count_);
+    message_entry->SetInteger("rewritten", rewritten_count_);
 
     base::DictionaryValue* entry = new base::DictionaryValue;
     std::string webview = webdriver::QWebViewUtil::getWebView(session_,session_->current_view())->metaObject()->className();
@@ -19,6 +19,7 @@
 
 #include "extension_qt/quick2_view_executor.h"
 
+#include "base/bind.h"
 #include "base/stringprintf.h"
 #include "base/string_number_conversions.h"
 #include "base/json/json_writer.h"
@@ -30,6 +31,9 @@
 #include "q_key_converter.h"
 #include "qml_view_util.h"
 #include "qml_objname_util.h"
+#include "common_util.h"
+#include "q_event_filter.h"
+#include "q_input_timeline_player.h"
 
 #include "extension_qt/event_dispatcher.h"
 #include "extension_qt/wd_event_dispatcher.h"
@@ -37,6 +41,8 @@
 // TODO: rename?
 #include "extension_qt/widget_element_handle.h"
 
+#include <climits>
+
 #include <QtCore/QBuffer>
 #include <QtCore/QDebug>
 #include <QtCore/QTimer>
@@ -44,6 +50,7 @@
 #include <QtQml/QQmlContext>
 #include <QtQml/QQmlExpression>
 #include <QtQml/QQmlEngine>
+#include <QtQml/QJSValueIterator>
 #include <QtGui/QStyleHints>
 #include <QtCore/QtMath>
 
@@ -170,6 +177,20 @@ void Quick2ViewCmdExecutor::SendKeys(const ElementId& element, const string16& k
     std::vector<QKeyEvent> key_events;
     int modifiers = Qt::NoModifier;
 
+    if (QCommonUtil::IsBulkTextInputEnabled(session_) &&
+        (pItem->flags() & QQuickItem::ItemAcceptsInputMethod)) {
+        std::vector<QKeyInputStep> steps;
+        if (!QKeyConverter::ConvertKeysToInputSteps(keys, session_->logger(), true,
+                                                    &modifiers, &steps, &err_msg)) {
+            session_->logger().Log(kSevereLogLevel, "SendKeys - cant convert keys:"+err_msg);
+            *error = new Error(kUnknownError, "SendKeys - cant convert keys:"+err_msg);
+            return;
+        }
+
+        QCommonUtil::SendKeyInputSteps(pItem, steps);
+        return;
+    }
+
     if (!QKeyConverter::ConvertKeysToWebKeyEvents(keys,
                                session_->logger(),
                                true,
@@ -197,6 +218,23 @@ void Quick2ViewCmdExecutor::SendKeys(const string16& keys, Error** error) {
     std::vector<QKeyEvent> key_events;
     int modifiers = session_->get_sticky_modifiers();
 
+    QQuickItem* pFocusItem = getFocusItem(view);
+
+    if (QCommonUtil::IsBulkTextInputEnabled(session_) && (NULL != pFocusItem) &&
+        (pFocusItem->flags() & QQuickItem::ItemAcceptsInputMethod)) {
+        std::vector<QKeyInputStep> steps;
+        if (!QKeyConverter::ConvertKeysToInputSteps(keys, session_->logger(), false,
+                                                    &modifiers, &steps, &err_msg)) {
+            session_->logger().Log(kSevereLogLevel, "SendKeys - cant convert keys:"+err_msg);
+            *error = new Error(kUnknownError, "SendKeys - cant convert keys:"+err_msg);
+            return;
+        }
+
+        session_->set_sticky_modifiers(modifiers);
+        QCommonUtil::SendKeyInputSteps(pFocusItem, steps);
+        return;
+    }
+
     if (!QKeyConverter::ConvertKeysToWebKeyEvents(keys,
                                session_->logger(),
                                false,
@@ -208,10 +246,9 @@ void Quick2ViewCmdExecutor::SendKeys(const string16& keys, Error** error) {
         return;
     }
 
-    QQuickItem* pFocusItem = getFocusItem(view);
-
     session_->set_sticky_modifiers(modifiers);
 
+    WDEventDispatchBatch dispatch_batch;
     std::vector<QKeyEvent>::iterator it = key_events.begin();
     while (it != key_events.end()) {
 
@@ -228,6 +265,110 @@ void Quick2ViewCmdExecutor::SendKeys(const string16& keys, Error** error) {
     }
 }
 
+void Quick2ViewCmdExecutor::PlayInputTimeline(const InputTimeline& timeline, Error** error) {
+    QQuickWindow* view = getView(view_id_, error);
+    if (NULL == view)
+        return;
+
+    QInputTimelinePlayer player(timeline, base::Bind(&Quick2ViewCmdExecutor::DispatchInputAction, base::Unretained(this)));
+    player.Play(error);
+}
+
+void Quick2ViewCmdExecutor::DispatchInputAction(const InputAction& action, Error** error) {
+    // view can be closed by one of previous events
+    QQuickWindow* view = getView(view_id_, error);
+    if (NULL == view)
+        return;
+
+    if (InputAction::kKeyDown == action.type || InputAction::kKeyUp == action.type) {
+        std::string err_msg;
+        std::vector<QKeyEvent> key_events;
+        int modifiers = session_->get_sticky_modifiers();
+
+        if (!QKeyConverter::ConvertKeyActionToKeyEvents(action.key,
+                                   InputAction::kKeyDown == action.type,
+                                   session_->logger(),
+                                   &modifiers,
+                                   &key_events,
+                                   &err_msg)) {
+            *error = new Error(kUnknownError, "Actions - cant convert key:"+err_msg);
+            return;
+        }
+
+        QQuickItem* pFocusItem = getFocusItem(view);
+
+        session_->set_sticky_modifiers(modifiers);
+
+        WDEventDispatchBatch dispatch_batch;
+        std::vector<QKeyEvent>::iterator it = key_events.begin();
+        while (it != key_events.end()) {
+            bool consumed = WDEventDispatcher::getInstance()->dispatch(&(*it));
+
+            if (!consumed) {
+                if (NULL != pFocusItem) {
+                    view->sendEvent(pFocusItem, &(*it));
+                } else {
+                    QGuiApplication::sendEvent(view, &(*it));
+                }
+            }
+            ++it;
+        }
+        return;
+    }
+
+    if (InputAction::kTouch == action.type) {
+        QList<QTouchEvent::TouchPoint> points;
+        Qt::TouchPointStates states = 0;
+        bool all_pressed = true, all_released = true;
+
+        std::vector<InputTouchPoint>::const_iterator it;
+        for (it = action.touch_points.begin(); it != action.touch_points.end(); ++it) {
+            Qt::TouchPointState state = QCommonUtil::ConvertTouchPointState(it->state);
+            QPointF point(it->position.x(), it->position.y());
+            points.append(createTouchPointWithId(state, point, it->id));
+            points.last().setScreenPos(QPointF(view->position()) + point);
+            states |= state;
+            all_pressed = all_pressed && (InputTouchPoint::kPressed == it->state);
+            all_released = all_released && (InputTouchPoint::kReleased == it->state);
+        }
+
+        QEvent::Type type = QEvent::TouchUpdate;
+        if (all_pressed)
+            type = QEvent::TouchBegin;
+        else if (all_released)
+            type = QEvent::TouchEnd;
+
+        // OS level dispatchers (e.g. uinput) may inject event instead of Qt
+        QTouchEvent* touchEvent = createTouchEvent(type, states, points);
+        if (WDEventDispatcher::getInstance()->dispatch(touchEvent))
+            delete touchEvent;
+        else
+            QGuiApplication::postEvent(view, touchEvent);
+        return;
+    }
+
+    QPointF scenePoint(action.position.x(), action.position.y());
+    QPointF screenPos(view->x() + scenePoint.x(), view->y() + scenePoint.y());
+    Qt::MouseButtons buttons = QCommonUtil::ConvertMouseButtonsToQtMouseButtons(action.buttons);
+    Qt::KeyboardModifiers sticky_modifiers(session_->get_sticky_modifiers());
+
+    QEvent::Type type = QEvent::MouseMove;
+    Qt::MouseButton button = Qt::NoButton;
+    if (InputAction::kPointerDown == action.type) {
+        type = QEvent::MouseButtonPress;
+        button = QCommonUtil::ConvertMouseButtonToQtMouseButton(action.button);
+    } else if (InputAction::kPointerUp == action.type) {
+        type = QEvent::MouseButtonRelease;
+        button = QCommonUtil::ConvertMouseButtonToQtMouseButton(action.button);
+    }
+
+    QMouseEvent* mouseEvent = new QMouseEvent(type, scenePoint, screenPos, button, buttons, sticky_modifiers);
+    if (WDEventDispatcher::getInstance()->dispatch(mouseEvent))
+        delete mouseEvent;
+    else
+        QGuiApplication::postEvent(view, mouseEvent);
+}
+
 void Quick2ViewCmdExecutor::MouseDoubleClick(Error** error) {
     QQuickWindow* view = getView(view_id_, error);
     if (NULL == view)
@@ -788,33 +929,56 @@ void Quick2ViewCmdExecutor::GetURL(std::string* url, Error** error) {
 }
 
 void Quick2ViewCmdExecutor::GetScreenShot(std::string* png, Error** error) {
+    GetScreenShotImage(kPngScreenshot, png, error);
+}
+
+void Quick2ViewCmdExecutor::GetScreenShotImage(ScreenshotFormat format, std::string* data, Error** error) {
     QQuickWindow* view = getView(view_id_, error);
     if (NULL == view)
         return;
-    
-    const FilePath::CharType kPngFileName[] = FILE_PATH_LITERAL("./screen.png");
-    FilePath path = session_->temp_dir().Append(kPngFileName);;
 
-    QImage image = view->grabWindow();
+    if (kVncScreenshotSource == session_->capabilities().screenshot_source) {
+        // VNC framebuffer is updated outside of Qt, frame count can't be used
+        QImage image;
+        if (!QCommonUtil::GrabVncScreen(view->geometry(), &image)) {
+            *error = new Error(kUnknownError, "can't grab screen from VNC server");
+            return;
+        }
+        if (!QCommonUtil::EncodeImage(image, format, data))
+            *error = new Error(kUnknownError, "screenshot was not captured");
+        return;
+    }
 
-#if defined(OS_WIN)
-    session_->logger().Log(kInfoLogLevel, "Save screenshot to - " + path.MaybeAsASCII());
-#elif defined(OS_POSIX)
-    session_->logger().Log(kInfoLogLevel, "Save screenshot to - " + path.value());
-#endif
+    // window that is not exposed doesn't render frames, so its frame
+    // count can't tell whether content changed
+    QRepaintEventFilter* tracker = NULL;
+    if (session_->capabilities().reuse_screenshots && view->isExposed()) {
+        tracker = QRepaintEventFilter::trackView(view);
+        // render pending update and deliver queued frameSwapped() before compare
+        QCoreApplication::sendPostedEvents(view, QEvent::UpdateRequest);
+        QCoreApplication::sendPostedEvents(tracker, QEvent::MetaCall);
+        if (tracker->getCachedScreenshot(format, data)) {
+            session_->logger().Log(kFineLogLevel, "GetScreenShot - view not repainted, reuse last screenshot");
+            return;
+        }
+    }
 
-#if defined(OS_POSIX)
-    if (!image.save(path.value().c_str())) 
-#elif defined(OS_WIN)
-    if (!image.save(QString::fromUtf16((ushort*)path.value().c_str())))
-#endif // OS_WIN
-    {
+    if (!QCommonUtil::EncodeImage(view->grabWindow(), format, data)) {
         *error = new Error(kUnknownError, "screenshot was not captured");
         return;
     }
 
-    if (!file_util::ReadFileToString(path, png))
-        *error = new Error(kUnknownError, "Could not read screenshot file");
+    if (NULL != tracker)
+        tracker->setCachedScreenshot(format, *data);
+}
+
+void Quick2ViewCmdExecutor::GetRepaintCount(int* count, Error** error) {
+    QQuickWindow* view = getView(view_id_, error);
+    if (NULL == view)
+        return;
+
+    // counts rendered frames, see QQuickWindow::frameSwapped()
+    *count = QRepaintEventFilter::trackView(view)->repaintCount();
 }
 
 void Quick2ViewCmdExecutor::GetElementScreenShot(const ElementId& element, std::string* png, Error** error) {
@@ -856,19 +1020,39 @@ void Quick2ViewCmdExecutor::GetElementScreenShot(const ElementId& element, std::
         *error = new Error(kUnknownError, "Could not read screenshot file");       
 }
 
+namespace {
+
+const char kScriptCacheName[] = "__wd_script_cache";
+// cache is simply dropped when full, scripts sent by clients are few
+const int kMaxCachedScripts = 256;
+// guards conversion of self-referencing objects
+const int kMaxResultDepth = 32;
+
+// Holds functions compiled in root context of view. Lives as child of the
+// view, so it is destroyed together with view and its engine.
+class QmlScriptCache : public QObject {
+public:
+    explicit QmlScriptCache(QObject* parent) : QObject(parent) {
+        setObjectName(kScriptCacheName);
+    }
+
+    static QmlScriptCache* get(QQuickWindow* view) {
+        QObject* cache = view->findChild<QObject*>(kScriptCacheName, Qt::FindDirectChildrenOnly);
+        if (NULL == cache)
+            return new QmlScriptCache(view);
+        return static_cast<QmlScriptCache*>(cache);
+    }
+
+    QHash<QString, QJSValue> functions;
+};
+
+}  // namespace
+
 void Quick2ViewCmdExecutor::ExecuteScript(const std::string& script, const base::ListValue* const args, base::Value** value, Error** error) {
     QQuickWindow* view = getView(view_id_, error);
     if (NULL == view)
         return;
 
-    std::string args_as_json;
-    base::JSONWriter::Write(static_cast<const Value* const>(args), &args_as_json);
-
-    std::string jscript = base::StringPrintf(
-        "(function(x) { %s }.apply(this, %s));",
-        script.c_str(),
-        args_as_json.c_str());
-
     QQmlEngine* engine = QQmlViewUtil::getQMLEngine(view);
     QQmlContext *rootContext = engine->rootContext();
     QVariant p = rootContext->contextProperty("ObjectNameUtils");
@@ -879,8 +1063,70 @@ void Quick2ViewCmdExecutor::ExecuteScript(const std::string& script, const base:
         rootContext->setContextProperty("ObjectNameUtils", objn);
     }
 
+    QmlScriptCache* cache = QmlScriptCache::get(view);
+    QString key = QString::fromUtf8(script.c_str());
+    QJSValue function = cache->functions.value(key);
+
+    if (!function.isCallable()) {
+        std::string jscript = base::StringPrintf("(function(x) { %s })", script.c_str());
+
+        QQmlExpression expr(rootContext, view, jscript.c_str());
+        QVariant compiled = expr.evaluate();
+        if (expr.hasError()) {
+            *error = new Error(kJavaScriptError, expr.error().toString().toStdString());
+            session_->logger().Log(kWarningLogLevel, expr.error().toString().toStdString());
+            return;
+        }
+
+        if (compiled.userType() == qMetaTypeId<QJSValue>())
+            function = compiled.value<QJSValue>();
+
+        if (!function.isCallable()) {
+            // engine did not hand out function object, evaluate script as is
+            ExecuteScriptAsExpression(view, script, args, value, error);
+            return;
+        }
+
+        if (cache->functions.size() >= kMaxCachedScripts)
+            cache->functions.clear();
+        cache->functions.insert(key, function);
+    }
+
+    QJSValueList js_args;
+    for (size_t i = 0; i < args->GetSize(); ++i) {
+        const Value* arg = NULL;
+        args->Get(i, &arg);
+        js_args.append(ConvertValueToJS(engine, arg, 0, error));
+        if (*error)
+            return;
+    }
+
+    QQmlEngine::setObjectOwnership(view, QQmlEngine::CppOwnership);
+    QJSValue result = function.callWithInstance(engine->newQObject(view), js_args);
+    if (result.isError()) {
+        *error = new Error(kJavaScriptError, result.toString().toStdString());
+        session_->logger().Log(kWarningLogLevel, result.toString().toStdString());
+        return;
+    }
+
+    scoped_ptr<Value> ret_value(ConvertJSToValue(result, 0, error));
+    if (*error)
+        return;
+
+    *value = ret_value.release();
+}
+
+void Quick2ViewCmdExecutor::ExecuteScriptAsExpression(QQuickWindow* view, const std::string& script, const base::ListValue* const args, base::Value** value, Error** error) {
+    std::string args_as_json;
+    base::JSONWriter::Write(static_cast<const Value* const>(args), &args_as_json);
 
-    QQmlExpression expr(rootContext, view, jscript.c_str());
+    std::string jscript = base::StringPrintf(
+        "(function(x) { %s }.apply(this, %s));",
+        script.c_str(),
+        args_as_json.c_str());
+
+    QQmlEngine* engine = QQmlViewUtil::getQMLEngine(view);
+    QQmlExpression expr(engine->rootContext(), view, jscript.c_str());
     QVariant result = expr.evaluate();
     if (expr.hasError()) {
         *error = new Error(kJavaScriptError, expr.error().toString().toStdString());
@@ -922,6 +1168,148 @@ void Quick2ViewCmdExecutor::ExecuteScript(const std::string& script, const base:
     *value = static_cast<Value*>(ret_value.release());
 }
 
+QJSValue Quick2ViewCmdExecutor::ConvertValueToJS(QQmlEngine* engine, const base::Value* arg, int depth, Error** error) {
+    if (depth > kMaxResultDepth) {
+        *error = new Error(kUnknownError, "script argument is too deep.");
+        return QJSValue();
+    }
+
+    switch (arg->GetType()) {
+    case Value::TYPE_BOOLEAN: {
+        bool b = false;
+        arg->GetAsBoolean(&b);
+        return QJSValue(b);
+    }
+    case Value::TYPE_INTEGER: {
+        int i = 0;
+        arg->GetAsInteger(&i);
+        return QJSValue(i);
+    }
+    case Value::TYPE_DOUBLE: {
+        double d = 0;
+        arg->GetAsDouble(&d);
+        return QJSValue(d);
+    }
+    case Value::TYPE_STRING: {
+        std::string str;
+        arg->GetAsString(&str);
+        return QJSValue(QString::fromUtf8(str.c_str()));
+    }
+    case Value::TYPE_LIST: {
+        const ListValue* list = static_cast<const ListValue*>(arg);
+        QJSValue array = engine->newArray(list->GetSize());
+        for (size_t i = 0; i < list->GetSize(); ++i) {
+            const Value* item = NULL;
+            list->Get(i, &item);
+            array.setProperty(i, ConvertValueToJS(engine, item, depth + 1, error));
+            if (*error)
+                return QJSValue();
+        }
+        return array;
+    }
+    case Value::TYPE_DICTIONARY: {
+        const DictionaryValue* dict = static_cast<const DictionaryValue*>(arg);
+        ElementId element(arg);
+        if (element.is_valid()) {
+            QElementHandle* handle = dynamic_cast<QElementHandle*>(session_->GetElementHandle(view_id_, element));
+            if (NULL == handle) {
+                *error = new Error(kNoSuchElement);
+                return QJSValue();
+            }
+            if (!handle->is_valid()) {
+                *error = new Error(kStaleElementReference);
+                return QJSValue();
+            }
+            QQmlEngine::setObjectOwnership(handle->get(), QQmlEngine::CppOwnership);
+            return engine->newQObject(handle->get());
+        }
+
+        QJSValue object = engine->newObject();
+        for (DictionaryValue::key_iterator it = dict->begin_keys(); it != dict->end_keys(); ++it) {
+            const std::string& name = *it;
+            const Value* item = NULL;
+            dict->GetWithoutPathExpansion(name, &item);
+            object.setProperty(QString::fromUtf8(name.c_str()), ConvertValueToJS(engine, item, depth + 1, error));
+            if (*error)
+                return QJSValue();
+        }
+        return object;
+    }
+    default:
+        return QJSValue(QJSValue::NullValue);
+    }
+}
+
+base::Value* Quick2ViewCmdExecutor::ConvertJSToValue(const QJSValue& result, int depth, Error** error) {
+    if (depth > kMaxResultDepth) {
+        *error = new Error(kUnknownError, "script result is too deep.");
+        return NULL;
+    }
+
+    if (result.isNull() || result.isUndefined())
+        return Value::CreateNullValue();
+
+    if (result.isBool())
+        return Value::CreateBooleanValue(result.toBool());
+
+    if (result.isNumber()) {
+        double d = result.toNumber();
+        if (d == qFloor(d) && d >= INT_MIN && d <= INT_MAX)
+            return Value::CreateIntegerValue(static_cast<int>(d));
+        return Value::CreateDoubleValue(d);
+    }
+
+    if (result.isString())
+        return Value::CreateStringValue(result.toString().toStdString());
+
+    if (result.isQObject()) {
+        QObject* object = result.toQObject();
+        if (NULL == object)
+            return Value::CreateNullValue();
+
+        ElementId element;
+        session_->AddElement(view_id_, new QElementHandle(object), &element);
+        return element.ToValue();
+    }
+
+    if (result.isArray()) {
+        scoped_ptr<ListValue> list(new ListValue());
+        quint32 length = result.property("length").toUInt();
+        for (quint32 i = 0; i < length; ++i) {
+            Value* item = ConvertJSToValue(result.property(i), depth + 1, error);
+            if (*error)
+                return NULL;
+            list->Append(item);
+        }
+        return list.release();
+    }
+
+    if (result.isCallable()) {
+        *error = new Error(kUnknownError, "cant handle function as result.");
+        return NULL;
+    }
+
+    if (result.isDate() || result.isRegExp() || result.isVariant())
+        return Value::CreateStringValue(result.toString().toStdString());
+
+    if (result.isObject()) {
+        scoped_ptr<DictionaryValue> dict(new DictionaryValue());
+        QJSValueIterator it(result);
+        while (it.hasNext()) {
+            it.next();
+            Value* item = ConvertJSToValue(it.value(), depth + 1, error);
+            if (*error)
+                return NULL;
+            dict->SetWithoutPathExpansion(it.name().toStdString(), item);
+        }
+        return dict.release();
+    }
+
+    session_->logger().Log(kWarningLogLevel, "cant handle result type.");
+    *error = new Error(kUnknownError, "cant handle result type.");
+    return NULL;
+}
+
 void Quick2ViewCmdExecutor::GetPlayerState(const ElementId &element, PlayerState *state, Error **error)
 {
     QQuickWindow* view = getView(view_id_, error);
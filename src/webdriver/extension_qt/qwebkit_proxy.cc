@@ -45,48 +45,230 @@
 #include "webdriver_logging.h"
 #include "webdriver_server.h"
 #include "webdriver_switches.h"
+#include "extension_qt/qnetwork_access_manager_tracer.h"
 
 #include "third_party/webdriver/atoms.h"
 
 namespace webdriver {
 
+namespace {
+
+// Network has to stay quiet that long for kNetworkIdlePageLoad.
+const int kNetworkIdleQuietMs = 500;
+
+// Async script atom reports its own timeout with proper error, C++ watchdog
+// fires a bit later and covers callbacks lost otherwise, navigation is
+// noticed right away by JSNotifier.
+const int kAsyncScriptWatchdogGraceMs = 100;
+
+const char kAsyncNotifierObjectPrefix[] = "__wdAsyncNotifier";
+
+// Parses response of executeScript atoms: {"status": code, "value": result}.
+Error* ParseScriptResponse(const std::string& response_json, Value** script_result) {
+    // children are detachable, so result below is removed without copy
+    scoped_ptr<Value> value(base::JSONReader::ReadAndReturnError(
+        response_json, base::JSON_ALLOW_TRAILING_COMMAS | base::JSON_DETACHABLE_CHILDREN,
+        NULL, NULL));
+    if (!value.get())
+        return new Error(kUnknownError, "Failed to parse script result");
+    if (value->GetType() != Value::TYPE_DICTIONARY)
+        return new Error(kUnknownError, "Execute script returned non-dict: " +
+                         JsonStringify(value.get()));
+    DictionaryValue* result_dict = static_cast<DictionaryValue*>(value.get());
+
+    int status;
+    if (!result_dict->GetInteger("status", &status))
+        return new Error(kUnknownError, "Execute script did not return status: " +
+                         JsonStringify(result_dict));
+    ErrorCode code = static_cast<ErrorCode>(status);
+    if (code != kSuccess) {
+        DictionaryValue* error_dict;
+        std::string error_msg;
+        if (result_dict->GetDictionary("value", &error_dict))
+            error_dict->GetString("message", &error_msg);
+        if (error_msg.empty())
+            error_msg = "Script failed with error code: " + base::IntToString(code);
+        return new Error(code, error_msg);
+    }
+
+    // Result is moved out of parsed response, not copied.
+    Value* tmp;
+    if (result_dict->RemoveWithoutPathExpansion("value", &tmp)) {
+        *script_result= tmp;
+    } else {
+        // "value" was not defined in the returned dictionary; set to null.
+        *script_result= Value::CreateNullValue();
+    }
+    return NULL;
+}
+
+const char kPageLoaderObjectName[] = "__wdPageLoader";
+
+}  // namespace
+
+QPageLoader::QPageLoader(QWebPage* page, PageLoadStrategy strategy)
+    : QObject(NULL),
+      is_loading(false),
+      is_dom_ready(false),
+      webPage(page),
+      strategy_(strategy),
+      dom_ready_bridge_(new QDomReadyBridge(this)) {
+    network_idle_timer_.setSingleShot(true);
+    network_idle_timer_.setInterval(kNetworkIdleQuietMs);
+    connect(&network_idle_timer_, SIGNAL(timeout()), this, SLOT(finishLoading()));
+    connect(dom_ready_bridge_, SIGNAL(domReady()), this, SLOT(domContentLoaded()));
+}
+
 void QPageLoader::loadPage(QUrl url) {
-    connect(webPage, SIGNAL(loadStarted()),this, SLOT(pageLoadStarted()));
+    startLoading();
     webPage->mainFrame()->load(url);
 }
 
 void QPageLoader::reloadPage() {
-    connect(webPage, SIGNAL(loadStarted()),this, SLOT(pageLoadStarted()));
+    startLoading();
     webPage->mainFrame()->load(webPage->mainFrame()->url());
 }
 
+void QPageLoader::startLoading() {
+    connect(webPage, SIGNAL(loadStarted()),this, SLOT(pageLoadStarted()));
+    if (strategy_ == kEagerPageLoad || strategy_ == kNetworkIdlePageLoad) {
+        connect(webPage->mainFrame(), SIGNAL(javaScriptWindowObjectCleared()),
+                this, SLOT(injectDomReadyListener()));
+    }
+    if (strategy_ == kNetworkIdlePageLoad) {
+        QNetworkAccessManagerTracer* tracer =
+            qobject_cast<QNetworkAccessManagerTracer*>(webPage->networkAccessManager());
+        if (tracer) {
+            connect(tracer, SIGNAL(requestStarted()), this, SLOT(requestStarted()));
+            connect(tracer, SIGNAL(networkIdle()), this, SLOT(networkIdle()));
+        } else {
+            // No request accounting for this page, wait for load instead.
+            strategy_ = kNormalPageLoad;
+        }
+    }
+}
+
+bool QPageLoader::waitForLoaded(int timeout_ms) {
+    if (!is_loading)
+        return true;
+
+    QEventLoop loop;
+    QTimer timer;
+    timer.setSingleShot(true);
+    connect(this, SIGNAL(loaded()), &loop, SLOT(quit()));
+    connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+    timer.start(timeout_ms);
+    loop.exec();
+    return !is_loading;
+}
+
 void QPageLoader::pageLoadStarted() {
     is_loading = true;
-    connect(webPage, SIGNAL(loadFinished(bool)),this, SLOT(pageLoadFinished()), Qt::QueuedConnection);
+    if (strategy_ == kNetworkIdlePageLoad) {
+        // finished load only means document is ready, e.g. for content
+        // without DOMContentLoaded; loading ends once network is quiet
+        connect(webPage, SIGNAL(loadFinished(bool)),this, SLOT(domContentLoaded()), Qt::QueuedConnection);
+    } else {
+        connect(webPage, SIGNAL(loadFinished(bool)),this, SLOT(pageLoadFinished()), Qt::QueuedConnection);
+    }
 }
 
 void QPageLoader::pageLoadFinished() {
+    finishLoading();
+}
+
+void QPageLoader::injectDomReadyListener() {
+    // Listener outlives loader if page never gets DOM ready while we wait,
+    // so it checks that bridge object is still there.
+    webPage->mainFrame()->addToJavaScriptWindowObject(kPageLoaderObjectName, dom_ready_bridge_);
+    webPage->mainFrame()->evaluateJavaScript(QString(
+        "document.addEventListener('DOMContentLoaded', function() {"
+        "  try { window.%1.domContentLoaded(); } catch (e) {}"
+        "}, false);").arg(kPageLoaderObjectName));
+}
+
+void QDomReadyBridge::domContentLoaded() {
+    emit domReady();
+}
+
+void QPageLoader::domContentLoaded() {
+    if (!is_loading || is_dom_ready)
+        return;
+    is_dom_ready = true;
+
+    if (strategy_ == kEagerPageLoad) {
+        finishLoading();
+    } else if (strategy_ == kNetworkIdlePageLoad) {
+        QNetworkAccessManagerTracer* tracer =
+            qobject_cast<QNetworkAccessManagerTracer*>(webPage->networkAccessManager());
+        if (tracer && !tracer->requestsInFlight())
+            network_idle_timer_.start();
+    }
+}
+
+void QPageLoader::requestStarted() {
+    network_idle_timer_.stop();
+}
+
+void QPageLoader::networkIdle() {
+    if (is_loading && is_dom_ready)
+        network_idle_timer_.start();
+}
+
+void QPageLoader::finishLoading() {
+    if (!is_loading)
+        return;
     is_loading = false;
+    network_idle_timer_.stop();
     emit loaded();
-}	
-
-JSNotifier::JSNotifier():
-    isCompleted(false) {
 }
 
-QVariant JSNotifier::getResult() {
-    return res;
+int JSNotifier::next_id_ = 0;
+
+JSNotifier::JSNotifier(QWebFrame* frame, AsyncScriptResult* result, int timeout_ms)
+    : QObject(frame),
+      result_(result),
+      js_name_(QString("%1%2").arg(kAsyncNotifierObjectPrefix).arg(next_id_++)) {
+    frame->addToJavaScriptWindowObject(js_name_, this);
+    // connected after object is added, adding may set up window and emit it
+    connect(frame, SIGNAL(javaScriptWindowObjectCleared()), this, SLOT(documentUnloaded()));
+
+    watchdog_.setSingleShot(true);
+    connect(&watchdog_, SIGNAL(timeout()), this, SLOT(timeout()));
+    watchdog_.start(timeout_ms + kAsyncScriptWatchdogGraceMs);
 }
 
-bool JSNotifier::IsCompleted() {
-    return isCompleted;
+JSNotifier::~JSNotifier() {
+    // no-op if script already completed
+    result_->Complete(NULL, new Error(kJavaScriptError,
+        "Document was unloaded while waiting for async script result"));
 }
 
 void JSNotifier::setResult(QVariant result) {
-    res = result;
-    isCompleted = true;
-    emit completed();
-}	
+    watchdog_.stop();
+
+    Value* value = NULL;
+    Error* error = ParseScriptResponse(result.toString().toStdString(), &value);
+    result_->Complete(value, error);
+    deleteLater();
+}
+
+void JSNotifier::timeout() {
+    result_->Complete(NULL, new Error(kScriptTimeout, "Timed out waiting for async script result"));
+    // callback coming later only fails inside page
+    QWebFrame* frame = qobject_cast<QWebFrame*>(parent());
+    if (frame)
+        frame->evaluateJavaScript(QString("delete window.%1;").arg(js_name_));
+    deleteLater();
+}
+
+void JSNotifier::documentUnloaded() {
+    // window with notifier property is gone too
+    watchdog_.stop();
+    result_->Complete(NULL, new Error(kJavaScriptError,
+        "Document was unloaded while waiting for async script result"));
+    deleteLater();
+}
 
 BrowserLogHandler::BrowserLogHandler(QObject *parent): QObject(parent), jslogger() {
 }
@@ -144,9 +326,7 @@ JSLogger::JSLogger() {
 }
 
 base::ListValue* JSLogger::getLog() {
-    base::ListValue* retVal = browserLog.entries_list()->DeepCopy();
-    browserLog.clear_entries_list();
-    return retVal;
+    return browserLog.TakeEntries();
 }
 
 void  JSLogger::SetMinLogLevel(LogLevel level) {
@@ -165,6 +345,38 @@ void JSLogger::error(QVariant message) {
     browserLogger.Log(kSevereLogLevel, message.toString().toStdString());
 }	
 
+QWebFrameCache::QWebFrameCache(QWebPage* page)
+    : QObject(page) {
+    connect(page, SIGNAL(loadStarted()), this, SLOT(Invalidate()));
+    connect(page, SIGNAL(frameCreated(QWebFrame*)), this, SLOT(Invalidate()));
+}
+
+QWebFrameCache* QWebFrameCache::ForPage(QWebPage* page) {
+    QWebFrameCache* cache = page->findChild<QWebFrameCache*>();
+    if (!cache)
+        cache = new QWebFrameCache(page);
+    return cache;
+}
+
+QWebFrame* QWebFrameCache::Lookup(const std::string& frame_path) {
+    FrameMap::iterator it = frames_.find(frame_path);
+    if (it == frames_.end())
+        return NULL;
+    if (it->second.isNull()) {
+        frames_.erase(it);
+        return NULL;
+    }
+    return static_cast<QWebFrame*>(it->second.data());
+}
+
+void QWebFrameCache::Insert(const std::string& frame_path, QWebFrame* frame) {
+    frames_[frame_path] = frame;
+}
+
+void QWebFrameCache::Invalidate() {
+    frames_.clear();
+}
+
 QWebkitProxy::QWebkitProxy(Session* session, QWebPage* webpage) :
 				session_(session),
 				page_(webpage) {}
@@ -229,21 +441,15 @@ Error* QWebkitProxy::GoBack() {
 }
 
 Error* QWebkitProxy::Reload() {
-	// TODO: take into account page load strategy
-    {
-        // sync reload
-        QPageLoader pageLoader(page_);
-        QEventLoop loop;
-        //TODO: 
-        //page_->stop();
-        QObject::connect(&pageLoader, SIGNAL(loaded()),&loop,SLOT(quit()));
-        pageLoader.reloadPage();
-        if (pageLoader.isLoading()) {
-            loop.exec();
-        }
+    const PageLoadStrategy strategy = session_->capabilities().page_load_strategy;
+    if (strategy == kNonePageLoad) {
+        page_->mainFrame()->load(page_->mainFrame()->url());
+        return NULL;
     }
 
-    return NULL;
+    QPageLoader pageLoader(page_, strategy);
+    pageLoader.reloadPage();
+    return WaitForPageLoad(&pageLoader);
 }
 
 Error* QWebkitProxy::GetSource(std::string* source) {
@@ -642,26 +848,24 @@ Error* QWebkitProxy::SwitchToTopFrameIfCurrentFrameInvalid() {
 Error* QWebkitProxy::NavigateToURL(const std::string& url, bool sync) {
 	QUrl address(QString(url.c_str()));
 
-    base::Time start_time = base::Time::Now();
-    if (sync) {
-        QPageLoader pageLoader(page_);
-        QEventLoop loop;
-        // TODO:
-        //page_->stop();
-        QObject::connect(&pageLoader, SIGNAL(loaded()),&loop,SLOT(quit()));
-        pageLoader.loadPage(address);
-        if (pageLoader.isLoading()) {
-            loop.exec();
-        }
-    } else {
+    const PageLoadStrategy strategy = session_->capabilities().page_load_strategy;
+    if (!sync || strategy == kNonePageLoad) {
         page_->mainFrame()->load(address);
-    }
-    if ((base::Time::Now() - start_time).InMilliseconds() > session_->page_load_timeout()) {
-        return new Error(kTimeout, "page loading timed out");
+        return NULL;
     }
 
+    QPageLoader pageLoader(page_, strategy);
+    pageLoader.loadPage(address);
+    return WaitForPageLoad(&pageLoader);
+}
 
-    return NULL;
+Error* QWebkitProxy::WaitForPageLoad(QPageLoader* loader) {
+    if (loader->waitForLoaded(session_->page_load_timeout()))
+        return NULL;
+
+    // Do not leave page loading in background of next commands.
+    page_->triggerAction(QWebPage::Stop);
+    return new Error(kTimeout, "page loading timed out");
 }
 
 Error* QWebkitProxy::GetURL(std::string* url) {
@@ -681,12 +885,12 @@ Error* QWebkitProxy::ExecuteScript(const std::string& script, const base::ListVa
                 value);
 }
 
-Error* QWebkitProxy::ExecuteAsyncScript(const std::string& script, const base::ListValue* const args, base::Value** value) {
+Error* QWebkitProxy::ExecuteAsyncScript(const std::string& script, const base::ListValue* const args, AsyncScriptResult* result) {
 	return ExecuteAsyncScript(
                 GetFrame(session_->current_frame()),
                 script,
                 args,
-                value);
+                result);
 }
 
 Error* QWebkitProxy::GetAppCacheStatus(int* status) {
@@ -1251,7 +1455,16 @@ Error* QWebkitProxy::IsOnline(bool* online) {
 }
 
 QWebFrame* QWebkitProxy::GetFrame(const FramePath& frame_path) {
-    QWebFrame* frame = FindFrameByPath(page_->mainFrame(), frame_path);
+    QWebFrame* frame = NULL;
+    if (!frame_path.value().empty()) {
+        QWebFrameCache* cache = QWebFrameCache::ForPage(page_);
+        frame = cache->Lookup(frame_path.value());
+        if (frame == NULL) {
+            frame = FindFrameByPath(page_->mainFrame(), frame_path);
+            if (frame != NULL)
+                cache->Insert(frame_path.value(), frame);
+        }
+    }
     if (frame == NULL)
         frame = page_->mainFrame();
 
@@ -1313,6 +1526,8 @@ void QWebkitProxy::AddIdToCurrentFrame(QWebPage* page, const FramePath &frame_pa
     QWebFrame *pFrame = FindFrameByMeta(page_->mainFrame(), frame_path);
 
     pFrame->setProperty("frame_id", QString(frame_path.value().c_str()));
+    // Frame ids changed, cached paths may no longer match tree walk.
+    QWebFrameCache::ForPage(page_)->Invalidate();
 }
 
 Error* QWebkitProxy::ExecuteScript(QWebFrame* frame,
@@ -1332,13 +1547,13 @@ Error* QWebkitProxy::ExecuteScript(QWebFrame* frame,
         atoms::asString(atoms::EXECUTE_SCRIPT).c_str(), script.c_str(),
         args_as_json.c_str());
 
-    return ExecuteScriptAndParseValue(frame, jscript, value, false);
+    return ExecuteScriptAndParseValue(frame, jscript, value);
 }
 
 Error* QWebkitProxy::ExecuteAsyncScript(QWebFrame* frame,
                                    const std::string& script,
                                    const ListValue* const args,
-                                   Value** value) {
+                                   AsyncScriptResult* result) {
 
     std::string args_as_json;
     base::JSONWriter::Write(static_cast<const Value* const>(args),
@@ -1346,18 +1561,27 @@ Error* QWebkitProxy::ExecuteAsyncScript(QWebFrame* frame,
 
     int timeout_ms = session_->async_script_timeout();
 
+    // Notifier completes |result| from script callback, command waits for it
+    // on its own thread.
+    JSNotifier* notifier = new JSNotifier(frame, result, timeout_ms);
+
     // Every injected script is fed through the executeScript atom. This atom
     // will catch any errors that are thrown and convert them to the
     // appropriate JSON structure.
+    const std::string notifier_name = notifier->jsName().toStdString();
+    std::string callback = base::StringPrintf(
+        "function(result) {var n = window.%s; delete window.%s; n.setResult(result);}",
+        notifier_name.c_str(), notifier_name.c_str());
     std::string jscript = base::StringPrintf(
         "(%s).apply(null, [function(){%s},%s,%d,%s,true]);",
         atoms::asString(atoms::EXECUTE_ASYNC_SCRIPT).c_str(),
         script.c_str(),
         args_as_json.c_str(),
         timeout_ms,
-        "function(result) {jsnotify.setResult(result);}");
+        callback.c_str());
 
-    return ExecuteScriptAndParseValue(frame, jscript, value, true);
+    frame->evaluateJavaScript(jscript.c_str());
+    return NULL;
 }
 
 Error* QWebkitProxy::ExecuteScriptAndParse(QWebFrame* frame,
@@ -1387,69 +1611,21 @@ Error* QWebkitProxy::ExecuteScriptAndParse(QWebFrame* frame,
 
 Error* QWebkitProxy::ExecuteScriptAndParseValue(QWebFrame* frame,
                                            const std::string& script,
-                                           Value** script_result, bool isAsync) {
+                                           Value** script_result) {
     std::string response_json;
-    Error* error = ExecuteScriptImpl(frame, script, &response_json, isAsync);
+    Error* error = ExecuteScriptImpl(frame, script, &response_json);
     if (error)
         return error;
 
-    scoped_ptr<Value> value(base::JSONReader::ReadAndReturnError(
-        response_json, base::JSON_ALLOW_TRAILING_COMMAS, NULL, NULL));
-    if (!value.get())
-        return new Error(kUnknownError, "Failed to parse script result");
-    if (value->GetType() != Value::TYPE_DICTIONARY)
-        return new Error(kUnknownError, "Execute script returned non-dict: " +
-                         JsonStringify(value.get()));
-    DictionaryValue* result_dict = static_cast<DictionaryValue*>(value.get());
-
-    int status;
-    if (!result_dict->GetInteger("status", &status))
-        return new Error(kUnknownError, "Execute script did not return status: " +
-                         JsonStringify(result_dict));
-    ErrorCode code = static_cast<ErrorCode>(status);
-    if (code != kSuccess) {
-        DictionaryValue* error_dict;
-        std::string error_msg;
-        if (result_dict->GetDictionary("value", &error_dict))
-            error_dict->GetString("message", &error_msg);
-        if (error_msg.empty())
-            error_msg = "Script failed with error code: " + base::IntToString(code);
-        return new Error(code, error_msg);
-    }
-
-    Value* tmp;
-    if (result_dict->Get("value", &tmp)) {
-        *script_result= tmp->DeepCopy();
-    } else {
-        // "value" was not defined in the returned dictionary; set to null.
-        *script_result= Value::CreateNullValue();
-    }
-    return NULL;
+    return ParseScriptResponse(response_json, script_result);
 }
 
 Error* QWebkitProxy::ExecuteScriptImpl(QWebFrame* frame,
                                const std::string &script,
-                               std::string *result,
-                               bool isAsync)
+                               std::string *result)
 {
-    std::string res;
-    if (isAsync)
-    {
-        QEventLoop loop;
-        JSNotifier* jsNotify = new JSNotifier();
-        frame->addToJavaScriptWindowObject("jsnotify", jsNotify );
-        QObject::connect(jsNotify, SIGNAL(completed()), &loop, SLOT(quit()));
-        frame->evaluateJavaScript(script.c_str());
-        if (!jsNotify->IsCompleted())
-            loop.exec();
-        res = jsNotify->getResult().toString().toStdString();
-        jsNotify->deleteLater();
-    }
-    else
-    {
-        QVariant f1result = frame->evaluateJavaScript(script.c_str());
-        res = f1result.toString().toStdString();
-    }
+    QVariant f1result = frame->evaluateJavaScript(script.c_str());
+    std::string res = f1result.toString().toStdString();
     *result = res;
 
     session_->logger().Log(kFineLogLevel, "ExecuteScriptImpl - "+res);
@@ -25,6 +25,8 @@
 #include <map>
 
 #include <QtCore/QtGlobal>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
 #include <QtCore/QVariant>
 
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
@@ -34,11 +36,14 @@
 #endif
 
 #include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
 #include "base/string16.h"
 #include "webdriver_view_id.h"
 #include "webdriver_element_id.h"
 #include "webdriver_logging.h"
 #include "webdriver_basic_types.h"
+#include "webdriver_capabilities_parser.h"
+#include "webdriver_async_script.h"
 
 namespace base {
 class Value;    
@@ -54,47 +59,88 @@ class Error;
 class FramePath;
 class ValueParser;
 
+/// The only object of QPageLoader exposed to page JavaScript, so page can
+/// report DOMContentLoaded of main frame and call nothing else.
+class QDomReadyBridge : public QObject {
+    Q_OBJECT
+public:
+    explicit QDomReadyBridge(QObject* parent) : QObject(parent) {}
+
+signals:
+    void domReady();
+
+public slots:
+    /// Called by page script on DOMContentLoaded of main frame.
+    void domContentLoaded();
+};
+
+/// Loads page and tells when it is loaded enough for given PageLoadStrategy.
 class QPageLoader : public QObject {
     Q_OBJECT
 public:
-    explicit QPageLoader(QWebPage* page) :
-                QObject(NULL) {webPage = page; is_loading = false;}
+    explicit QPageLoader(QWebPage* page,
+                         PageLoadStrategy strategy = kNormalPageLoad);
 
     void loadPage(QUrl url);
     void reloadPage();
     bool isLoading() {return is_loading;}
-    
+
+    /// Runs event loop until loaded() or |timeout_ms| expires.
+    /// @return false on timeout
+    bool waitForLoaded(int timeout_ms);
+
 signals:
     void loaded();
-    
-public slots:
+
+private slots:
     void pageLoadStarted();
     void pageLoadFinished();
+    void domContentLoaded();
+    void injectDomReadyListener();
+    void networkIdle();
+    void requestStarted();
+    void finishLoading();
+
 private:
+    void startLoading();
+
     bool is_loading;
+    bool is_dom_ready;
     QWebPage* webPage;
-    
+    PageLoadStrategy strategy_;
+    // Measures quiet period for kNetworkIdlePageLoad.
+    QTimer network_idle_timer_;
+    QDomReadyBridge* dom_ready_bridge_;
 };
 
-//Notify automation module about end of execution of async script
+/// Receives result of async script from page and completes AsyncScriptResult.
+/// Child of frame; completes with error once document of frame is replaced
+/// (main frame object outlives navigation) or frame is destroyed. Deletes
+/// itself once result is set or |timeout_ms| expires, no event loop is spun
+/// while waiting. Script removes window property of notifier before it sets
+/// result, on timeout notifier removes it itself.
 class JSNotifier : public QObject {
     Q_OBJECT
 
 public:
-    JSNotifier();
-    QVariant getResult();
-    bool IsCompleted();
+    JSNotifier(QWebFrame* frame, AsyncScriptResult* result, int timeout_ms);
+    virtual ~JSNotifier();
 
+    /// Name of this object in window of frame, unique for every script.
+    const QString& jsName() const { return js_name_; }
 
 public slots:
     void setResult(QVariant result);
 
-signals:
-    void completed();
+private slots:
+    void timeout();
+    void documentUnloaded();
 
 private:
-    QVariant res;
-    bool isCompleted;
+    scoped_refptr<AsyncScriptResult> result_;
+    QTimer watchdog_;
+    QString js_name_;
+    static int next_id_;
 };
 
 class JSLogger : public QObject {
@@ -133,6 +179,31 @@ private:
     JSLogger jslogger;
 };
 
+/// Per page cache of resolved frame paths. Attached to page as its child, so
+/// it outlives proxies which are created for every command. Cleared when
+/// page starts loading or creates new frame, destroyed frames drop out
+/// through QPointer.
+class QWebFrameCache : public QObject {
+    Q_OBJECT
+
+public:
+    /// Returns cache of |page|, creating it on first use.
+    static QWebFrameCache* ForPage(QWebPage* page);
+
+    /// Returns frame previously resolved for |frame_path| or NULL.
+    QWebFrame* Lookup(const std::string& frame_path);
+    void Insert(const std::string& frame_path, QWebFrame* frame);
+
+public slots:
+    void Invalidate();
+
+private:
+    explicit QWebFrameCache(QWebPage* page);
+
+    typedef std::map<std::string, QPointer<QObject> > FrameMap;
+    FrameMap frames_;
+};
+
 class QWebkitProxy {
 public:
     explicit QWebkitProxy(Session* session, QWebPage* webpage);
@@ -175,7 +246,7 @@ public:
     virtual Error* NavigateToURL(const std::string& url, bool sync);
     virtual Error* GetURL(std::string* url);
     virtual Error* ExecuteScript(const std::string& script, const base::ListValue* const args, base::Value** value);
-    virtual Error* ExecuteAsyncScript(const std::string& script, const base::ListValue* const args, base::Value** value);
+    virtual Error* ExecuteAsyncScript(const std::string& script, const base::ListValue* const args, AsyncScriptResult* result);
     virtual Error* GetAppCacheStatus(int* status);
     virtual Error* GetCookies(const std::string& url, base::ListValue** cookies);
     virtual Error* SetCookie(const std::string& url, base::DictionaryValue* cookie_dict);
@@ -210,6 +281,10 @@ protected:
 
     void AddIdToCurrentFrame(QWebPage* page, const FramePath &frame_path);
 
+    /// Waits for |loader| within session's page load timeout, stops loading
+    /// and returns timeout error if it expires.
+    Error* WaitForPageLoad(QPageLoader* loader);
+
     Error* ExecuteScript(QWebFrame* frame,
                         const std::string& script,
                         const base::ListValue* const args,
@@ -218,7 +293,7 @@ protected:
     Error* ExecuteAsyncScript(QWebFrame* frame,
                             const std::string& script,
                             const base::ListValue* const args,
-                            base::Value** value);
+                            AsyncScriptResult* result);
 
     Error* ExecuteScriptAndParse(QWebFrame* frame,
                                 const std::string& anonymous_func_script,
@@ -228,12 +303,11 @@ protected:
 
     Error* ExecuteScriptAndParseValue(QWebFrame* frame,
                                     const std::string& script,
-                                    base::Value** script_result, bool isAsync);
+                                    base::Value** script_result);
 
     Error* ExecuteScriptImpl(QWebFrame* frame,
                                const std::string &script,
-                               std::string *result,
-                               bool isAsync);
+                               std::string *result);
 
     Error* FindElementsHelper(QWebFrame* frame,
                             const ElementId& root_element,
@@ -4,6 +4,7 @@
 #include "webdriver_session.h"
 #include "webdriver_logging.h"
 #include "extension_qt/qnetwork_access_manager_tracer.h"
+#include "q_network_cache.h"
 #include <QtCore/QVariant>
 #include <QtCore/QTime>
 #include <QtCore/QDebug>
@@ -36,6 +37,7 @@ QWebView* QWebViewExt::createWindow(QWebPage::WebWindowType type)
 {
     QWebViewExt* newView = new QWebViewExt;
     setWebInspectorProperty(newView);
+    webdriver::QSharedNetworkCache::Install(newView->page()->networkAccessManager());
 
     newView->show();
     newView->setAttribute(Qt::WA_DeleteOnClose, true);
@@ -71,9 +73,14 @@ void QWebViewExt::setNetworkAccessManagerTracer()
         return;
     }
     webdriver::Session* session = sessionMap.begin()->second;
-    if (session->GetMinPerfLogLevel() == webdriver::kOffLogLevel)
+    // tracer also applies networkRules and counts requests for networkIdle
+    // page load strategy, so it is needed without performance log too
+    const webdriver::Capabilities& caps = session->capabilities();
+    if (session->GetMinPerfLogLevel() == webdriver::kOffLogLevel &&
+        caps.network_rules.empty() &&
+        caps.page_load_strategy != webdriver::kNetworkIdlePageLoad)
     {
-        webdriver::GlobalLogger::Log(webdriver::kInfoLogLevel, "Performance Log is disabled by defaul");
+        webdriver::GlobalLogger::Log(webdriver::kInfoLogLevel, "Network tracer is not needed, Performance Log is disabled by default");
         return;
     }
     manager_ = new QNetworkAccessManagerTracer(session, this->page());
@@ -123,6 +123,7 @@ void QWindowViewCmdExecutor::SendKeys(const string16& keys, Error** error) {
 
     session_->set_sticky_modifiers(modifiers);
 
+    WDEventDispatchBatch dispatch_batch;
     std::vector<QKeyEvent>::iterator it = key_events.begin();
     while (it != key_events.end()) {
 
@@ -36,15 +36,34 @@ bool UInputEventDispatcher::dispatch(QEvent *event, bool consumed)
     if (consumed)
         return false;
 
-    QKeyEvent *keyEvent = dynamic_cast<QKeyEvent*>(event);
-    if(NULL != keyEvent)
+    switch (event->type())
     {
-        _eventManager->injectKeyEvent(keyEvent);
-
-        return true;
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease:
+            _eventManager->injectKeyEvent(static_cast<QKeyEvent*>(event));
+            return true;
+        case QEvent::MouseMove:
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+            return _eventManager->injectMouseEvent(static_cast<QMouseEvent*>(event));
+        case QEvent::TouchBegin:
+        case QEvent::TouchUpdate:
+        case QEvent::TouchEnd:
+            return _eventManager->injectTouchEvent(static_cast<QTouchEvent*>(event));
+        default:
+            return false;
     }
+}
+
+void UInputEventDispatcher::beginBatch()
+{
+    _eventManager->beginBatch();
+}
 
-    return false;
+void UInputEventDispatcher::endBatch()
+{
+    _eventManager->endBatch();
 }
 
 #endif // OS_LINUX
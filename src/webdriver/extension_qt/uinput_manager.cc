@@ -26,8 +26,20 @@
 #include <linux/input.h>
 #include <linux/uinput.h>
 #include <QtCore/qnamespace.h>
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+#include <QtGui/QGuiApplication>
+#include <QtGui/QScreen>
+#else
+#include <QtGui/QApplication>
+#include <QtGui/QDesktopWidget>
+#endif
+#include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <unistd.h>
+
+// number of simultaneous touch contacts of pointer device
+#define MAX_TOUCH_SLOTS 10
 
 static int lookup_code(int keysym);
 
@@ -43,7 +55,11 @@ UInputManager* UInputManager::getInstance()
 
 UInputManager::UInputManager()
     : _deviceDescriptor(0),
-      _isReady(false)
+      _pointerDescriptor(-1),
+      _isReady(false),
+      _isPointerReady(false),
+      _batchDepth(0),
+      _nextTrackingId(0)
 {
     _logger = new Logger();
 }
@@ -52,6 +68,11 @@ UInputManager::~UInputManager()
 {
     delete _logger;
     ioctl(_deviceDescriptor, UI_DEV_DESTROY);   // try destroy device
+    if (0 <= _pointerDescriptor)
+    {
+        ioctl(_pointerDescriptor, UI_DEV_DESTROY);
+        close(_pointerDescriptor);
+    }
 }
 
 bool UInputManager::registerUinputDevice()
@@ -103,29 +124,74 @@ bool UInputManager::registerUinputDevice()
     }
 
     _isReady = true;
+
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+    QScreen *screen = QGuiApplication::primaryScreen();
+    QRect screenRect = (NULL != screen) ? screen->geometry() : QRect();
+#else
+    QRect screenRect = QApplication::desktop()->screenGeometry();
+#endif
+    if (!registerPointerDevice(screenRect))
+        _logger->Log(kWarningLogLevel, "Can't create uinput pointer device, mouse and touch events are not injected");
+
     return true;
 }
 
-int UInputManager::injectKeyEvent(QKeyEvent *event)
+bool UInputManager::registerPointerDevice(const QRect &screen)
 {
-    struct input_event ev;
-    int res = -1;
+    if (screen.isEmpty())
+        return false;
 
-    memset(&ev, 0, sizeof(ev));
+    // uinput creates one device per descriptor
+    _pointerDescriptor = open("/dev/uinput", O_WRONLY | O_NONBLOCK);
+    if (0 > _pointerDescriptor)
+        return false;
 
-    gettimeofday(&(ev.time), NULL);
+    bool ok = true;
+    ok = ok && (0 <= ioctl(_pointerDescriptor, UI_SET_EVBIT, EV_SYN));
+    ok = ok && (0 <= ioctl(_pointerDescriptor, UI_SET_EVBIT, EV_KEY));
+    ok = ok && (0 <= ioctl(_pointerDescriptor, UI_SET_EVBIT, EV_ABS));
+    ok = ok && (0 <= ioctl(_pointerDescriptor, UI_SET_KEYBIT, BTN_LEFT));
+    ok = ok && (0 <= ioctl(_pointerDescriptor, UI_SET_KEYBIT, BTN_RIGHT));
+    ok = ok && (0 <= ioctl(_pointerDescriptor, UI_SET_KEYBIT, BTN_MIDDLE));
+    ok = ok && (0 <= ioctl(_pointerDescriptor, UI_SET_KEYBIT, BTN_TOUCH));
+    ok = ok && (0 <= ioctl(_pointerDescriptor, UI_SET_ABSBIT, ABS_X));
+    ok = ok && (0 <= ioctl(_pointerDescriptor, UI_SET_ABSBIT, ABS_Y));
+    ok = ok && (0 <= ioctl(_pointerDescriptor, UI_SET_ABSBIT, ABS_MT_SLOT));
+    ok = ok && (0 <= ioctl(_pointerDescriptor, UI_SET_ABSBIT, ABS_MT_TRACKING_ID));
+    ok = ok && (0 <= ioctl(_pointerDescriptor, UI_SET_ABSBIT, ABS_MT_POSITION_X));
+    ok = ok && (0 <= ioctl(_pointerDescriptor, UI_SET_ABSBIT, ABS_MT_POSITION_Y));
 
-    if (QKeyEvent::KeyPress == event->type())
-    {
-        ev.value = 1;
-    }
-    else if (QKeyEvent::KeyRelease == event->type())
+    struct uinput_user_dev uidev;
+    memset(&uidev, 0, sizeof(uidev));
+    uidev.id.bustype = BUS_USB;
+    uidev.id.version = 0x01;
+    snprintf(uidev.name, UINPUT_MAX_NAME_SIZE, "wd_abs_input");
+    uidev.absmax[ABS_X] = uidev.absmax[ABS_MT_POSITION_X] = screen.width() - 1;
+    uidev.absmax[ABS_Y] = uidev.absmax[ABS_MT_POSITION_Y] = screen.height() - 1;
+    uidev.absmax[ABS_MT_SLOT] = MAX_TOUCH_SLOTS - 1;
+    uidev.absmax[ABS_MT_TRACKING_ID] = 0xffff;
+
+    ok = ok && ((ssize_t)sizeof(uidev) == write(_pointerDescriptor, &uidev, sizeof(uidev)));
+    ok = ok && (0 <= ioctl(_pointerDescriptor, UI_DEV_CREATE));
+
+    if (!ok)
     {
-        ev.value = 0;
+        close(_pointerDescriptor);
+        _pointerDescriptor = -1;
+        return false;
     }
-    printf("#### Key code: %d\n", event->key());
-    printf("#### Key text: %s, modifiers: %d\n", event->text().toStdString().c_str(), (int)event->modifiers());
-    int key_text = event->text().toStdString().c_str()[0];
+
+    _screen = screen;
+    _isPointerReady = true;
+    return true;
+}
+
+int UInputManager::injectKeyEvent(QKeyEvent *event)
+{
+    int value = (QKeyEvent::KeyPress == event->type()) ? 1 : 0;
+    QByteArray text = event->text().toLatin1();
+    int key_text = text.isEmpty() ? 0 : text.at(0);
 
     // Check keyCode for capital letters
     if ((key_text>='>' && key_text<='Z') ||       // '>','?','@'  included
@@ -135,28 +201,128 @@ int UInputManager::injectKeyEvent(QKeyEvent *event)
             (key_text>='{' && key_text<='}') ||    // '{' - '}'
             '<' == key_text )
     {
-        ev.type = EV_KEY;
-        ev.code = KEY_RIGHTSHIFT;
-        res = write(_deviceDescriptor, &ev, sizeof(ev));
+        queueEvent(_keyEvents, EV_KEY, KEY_RIGHTSHIFT, value);
+    }
+
+    int code = lookup_code(event->key());
+    queueEvent(_keyEvents, EV_KEY, code, value);
+    queueEvent(_keyEvents, EV_SYN, SYN_REPORT, 0);
+
+    if (0 == _batchDepth)
+        flushEvents();
+
+    return code;
+}
+
+bool UInputManager::injectMouseEvent(QMouseEvent *event)
+{
+    if (!_isPointerReady)
+        return false;
+
+    int code = 0;
+    switch (event->button())
+    {
+        case Qt::LeftButton: code = BTN_LEFT; break;
+        case Qt::RightButton: code = BTN_RIGHT; break;
+        case Qt::MidButton: code = BTN_MIDDLE; break;
+        default: break;
+    }
+
+    int value = 0;
+    switch (event->type())
+    {
+        case QEvent::MouseMove: code = 0; break;
+        // OS detects double click itself, so it is just second press
+        case QEvent::MouseButtonDblClick:
+        case QEvent::MouseButtonPress: value = 1; break;
+        case QEvent::MouseButtonRelease: value = 0; break;
+        default: return false;
+    }
+
+    queuePosition(ABS_X, ABS_Y, event->globalPos());
+    if (0 != code)
+        queueEvent(_pointerEvents, EV_KEY, code, value);
+    queueEvent(_pointerEvents, EV_SYN, SYN_REPORT, 0);
+
+    if (0 == _batchDepth)
+        flushEvents();
+
+    return true;
+}
+
+bool UInputManager::injectTouchEvent(QTouchEvent *event)
+{
+    if (!_isPointerReady)
+        return false;
+
+    const bool wasTouched = !_touchSlots.isEmpty();
+    bool positionSet = false;
+
+    foreach (const QTouchEvent::TouchPoint &point, event->touchPoints())
+    {
+        int slot = _touchSlots.value(point.id(), -1);
+        if (-1 == slot)
+        {
+            // contact which was not pressed via this device
+            if (Qt::TouchPointPressed != point.state())
+                continue;
+
+            slot = freeTouchSlot();
+            if (-1 == slot)
+            {
+                _logger->Log(kWarningLogLevel, "Too many touch points for uinput device");
+                continue;
+            }
+            _touchSlots.insert(point.id(), slot);
+            queueEvent(_pointerEvents, EV_ABS, ABS_MT_SLOT, slot);
+            queueEvent(_pointerEvents, EV_ABS, ABS_MT_TRACKING_ID, _nextTrackingId);
+            _nextTrackingId = (_nextTrackingId + 1) & 0xffff;
+        }
+        else
+        {
+            queueEvent(_pointerEvents, EV_ABS, ABS_MT_SLOT, slot);
+        }
+
+        if (Qt::TouchPointReleased == point.state())
+        {
+            queueEvent(_pointerEvents, EV_ABS, ABS_MT_TRACKING_ID, -1);
+            _touchSlots.remove(point.id());
+            continue;
+        }
+
+        QPoint pos = point.screenPos().toPoint();
+        queuePosition(ABS_MT_POSITION_X, ABS_MT_POSITION_Y, pos);
+        // single touch emulation follows first contact
+        if (!positionSet)
+        {
+            queuePosition(ABS_X, ABS_Y, pos);
+            positionSet = true;
+        }
     }
 
-    ev.type = EV_KEY;
-    ev.code = lookup_code(event->key());
+    const bool isTouched = !_touchSlots.isEmpty();
+    if (wasTouched != isTouched)
+        queueEvent(_pointerEvents, EV_KEY, BTN_TOUCH, isTouched ? 1 : 0);
+    queueEvent(_pointerEvents, EV_SYN, SYN_REPORT, 0);
 
-    res = write(_deviceDescriptor, &ev, sizeof(ev));
-    _logger->Log(kInfoLogLevel, std::string("#### Write event time: ") +
-                 QString::number(ev.time.tv_sec).toStdString() + std::string(".") +
-                 QString::number(ev.time.tv_usec).toStdString() + std::string(", res: ") +
-                 QString::number(res).toStdString() + std::string(", errno: ") +
-                 QString::number(errno).toStdString() );
+    if (0 == _batchDepth)
+        flushEvents();
 
-    ev.type = EV_SYN;
-    ev.code = SYN_REPORT;
-    ev.value = 0;
+    return true;
+}
 
-    res = write(_deviceDescriptor, &ev, sizeof(ev));
+void UInputManager::beginBatch()
+{
+    ++_batchDepth;
+}
+
+void UInputManager::endBatch()
+{
+    if (0 == _batchDepth)
+        return;
 
-    return res;
+    if (0 == --_batchDepth)
+        flushEvents();
 }
 
 void UInputManager::registerHandledKeys()
@@ -201,20 +367,87 @@ bool UInputManager::isReady()
     return _isReady;
 }
 
-int UInputManager::injectSynEvent()
+bool UInputManager::isPointerReady()
 {
-    struct input_event ev;
+    return _isPointerReady;
+}
+
+int UInputManager::freeTouchSlot() const
+{
+    QList<int> used = _touchSlots.values();
+    for (int slot = 0; slot < MAX_TOUCH_SLOTS; ++slot)
+    {
+        if (!used.contains(slot))
+            return slot;
+    }
+    return -1;
+}
 
+void UInputManager::queueEvent(std::vector<struct input_event> &queue, int type, int code, int value)
+{
+    // kernel stamps events itself, time is left zero
+    struct input_event ev;
     memset(&ev, 0, sizeof(ev));
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+
+    queue.push_back(ev);
+}
 
-    ev.type = EV_SYN;
-    ev.code = SYN_REPORT;
-    ev.value = 0;
-    gettimeofday(&(ev.time), NULL);
+void UInputManager::queuePosition(int codeX, int codeY, const QPoint &globalPos)
+{
+    QPoint pos = globalPos - _screen.topLeft();
+    queueEvent(_pointerEvents, EV_ABS, codeX, qBound(0, pos.x(), _screen.width() - 1));
+    queueEvent(_pointerEvents, EV_ABS, codeY, qBound(0, pos.y(), _screen.height() - 1));
+}
+
+void UInputManager::flushEvents()
+{
+    if (_isReady)
+        writeEvents(_deviceDescriptor, _keyEvents);
+    else
+        _keyEvents.clear();
+    writeEvents(_pointerDescriptor, _pointerEvents);
+}
+
+int UInputManager::writeEvents(int descriptor, std::vector<struct input_event> &events)
+{
+    if (events.empty())
+        return 0;
 
-    int res = write(_deviceDescriptor, &ev, sizeof(ev));
+    const size_t written = writeBatch(descriptor, events);
+    if (events.size() != written)
+    {
+        _logger->Log(kWarningLogLevel, std::string("Can't write uinput events, errno: ") +
+                     QString::number(errno).toStdString());
+    }
+    else
+    {
+        _logger->Log(kFineLogLevel, std::string("Written uinput events: ") +
+                     QString::number(events.size()).toStdString());
+    }
+
+    events.clear();
+    return written;
+}
+
+size_t UInputManager::writeBatch(int descriptor, const std::vector<struct input_event> &events)
+{
+    if (events.empty())
+        return 0;
+
+    // uinput takes whole events only, partial write means error
+    const ssize_t size = events.size() * sizeof(struct input_event);
+    ssize_t res;
+    do
+    {
+        res = write(descriptor, &events[0], size);
+    } while (0 > res && EINTR == errno);
 
-    return res;
+    if (0 > res)
+        return 0;
+    return res / sizeof(struct input_event);
 }
 
 static int lookup_code(int keysym) {
@@ -37,11 +37,23 @@ bool VNCEventDispatcher::dispatch(QEvent *event, bool consumed)
     {
         case QEvent::KeyPress:
         case QEvent::KeyRelease: _vncClient->sendKeyEvent(dynamic_cast<QKeyEvent*>(event)); break;
+        case QEvent::MouseMove:
         case QEvent::MouseButtonPress:
         case QEvent::MouseButtonRelease:
         case QEvent::MouseButtonDblClick: _vncClient->sendMouseEvent(dynamic_cast<QMouseEvent*>(event)); break;
-        default: break;
+        // other events are left for next dispatchers and Qt
+        default: return false;
     }
 
     return true;
 }
+
+void VNCEventDispatcher::beginBatch()
+{
+    _vncClient->beginBatch();
+}
+
+void VNCEventDispatcher::endBatch()
+{
+    _vncClient->endBatch();
+}
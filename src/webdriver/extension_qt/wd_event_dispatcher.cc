@@ -61,3 +61,19 @@ bool WDEventDispatcher::dispatch(QEvent *event)
 
     return consumed;
 }
+
+void WDEventDispatcher::beginBatch()
+{
+    foreach (EventDispatcher* item, _dispatchers)
+    {
+        item->beginBatch();
+    }
+}
+
+void WDEventDispatcher::endBatch()
+{
+    foreach (EventDispatcher* item, _dispatchers)
+    {
+        item->endBatch();
+    }
+}
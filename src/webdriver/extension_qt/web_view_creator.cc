@@ -28,6 +28,7 @@
 #include "common_util.h"
 #include "q_content_type_resolver.h"
 #include "q_event_filter.h"
+#include "q_network_cache.h"
 #include "base/string_number_conversions.h"
 
 #include <QtNetwork/QNetworkAccessManager>
@@ -64,6 +65,7 @@ bool QWebViewCreator::CreateViewByClassName(const Logger& logger, const std::str
 
         if (NULL == widget)
             return false;
+        QSharedNetworkCache::InstallForWidget(widget);
         if (NULL != size && NULL != position) {
             Rect* rect = new Rect(*position, *size);
             widget->setGeometry(QCommonUtil::ConvertRectToQRect(*rect));
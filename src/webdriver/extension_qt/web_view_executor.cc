@@ -252,6 +252,21 @@ void QWebViewCmdExecutor::SendKeys(const ElementId& element, const string16& key
     std::vector<QKeyEvent> key_events;
     int modifiers = Qt::NoModifier;
 
+    // view enables input methods while editable element has focus
+    if (QCommonUtil::IsBulkTextInputEnabled(session_) &&
+        view_->testAttribute(Qt::WA_InputMethodEnabled)) {
+        std::vector<QKeyInputStep> steps;
+        if (!QKeyConverter::ConvertKeysToInputSteps(keys, session_->logger(), true,
+                                                    &modifiers, &steps, &err_msg)) {
+            session_->logger().Log(kSevereLogLevel, "ElementSendKeys - cant convert keys:"+err_msg);
+            *error = new Error(kUnknownError, "ElementSendKeys - cant convert keys:"+err_msg);
+            return;
+        }
+
+        QCommonUtil::SendKeyInputSteps(view_, steps);
+        return;
+    }
+
     if (!QKeyConverter::ConvertKeysToWebKeyEvents(keys,
                                session_->logger(),
                                true,
@@ -613,10 +628,10 @@ void QWebViewCmdExecutor::ExecuteScript(const std::string& script, const base::L
     *error = webkitProxy_->ExecuteScript(script, args, value);
 }
 
-void QWebViewCmdExecutor::ExecuteAsyncScript(const std::string& script, const base::ListValue* const args, base::Value** value, Error** error) {
+void QWebViewCmdExecutor::ExecuteAsyncScript(const std::string& script, const base::ListValue* const args, AsyncScriptResult* result, Error** error) {
     CHECK_VIEW_EXISTANCE
 
-    *error = webkitProxy_->ExecuteAsyncScript(script, args, value);
+    *error = webkitProxy_->ExecuteAsyncScript(script, args, result);
 }
 
 void QWebViewCmdExecutor::GetAppCacheStatus(int* status, Error** error) {
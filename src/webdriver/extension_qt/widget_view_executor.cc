@@ -176,6 +176,10 @@ void QWidgetViewCmdExecutor::GetSource(std::string* source, Error** error) {
     QBuffer buff(&byteArray);
     buff.open(QIODevice::ReadWrite);
     QWidgetXmlSerializer serializer(&buff);
+    // elementIds registered in session are stable between calls, so page
+    // source can be diffed and its ids used in element commands
+    serializer.setSession(session_);
+    serializer.setViewId(view_id_);
     serializer.createXml(view);
     *source = byteArray.data();
 }
@@ -203,6 +207,20 @@ void QWidgetViewCmdExecutor::SendKeys(const ElementId& element, const string16&
     std::vector<QKeyEvent> key_events;
     int modifiers = Qt::NoModifier;
 
+    if (QCommonUtil::IsBulkTextInputEnabled(session_) &&
+        pWidget->testAttribute(Qt::WA_InputMethodEnabled)) {
+        std::vector<QKeyInputStep> steps;
+        if (!QKeyConverter::ConvertKeysToInputSteps(keys, session_->logger(), true,
+                                                    &modifiers, &steps, &err_msg)) {
+            session_->logger().Log(kSevereLogLevel, "SendKeys - cant convert keys:"+err_msg);
+            *error = new Error(kUnknownError, "SendKeys - cant convert keys:"+err_msg);
+            return;
+        }
+
+        QCommonUtil::SendKeyInputSteps(pWidget, steps);
+        return;
+    }
+
     if (!QKeyConverter::ConvertKeysToWebKeyEvents(keys,
                                session_->logger(),
                                true,
@@ -1595,6 +1613,14 @@ void QWidgetViewCmdExecutor::FindNativeElementsByXpath(QWidget* parent, const st
     buff.open(QIODevice::ReadWrite);
     QWidgetXmlSerializer serializer(&buff);
     serializer.setDumpAll(true);
+    // dump only properties the query can look at
+    QStringList attributes;
+    if (QWidgetXmlSerializer::getXPathAttributes(query, &attributes)) {
+        if (attributes.isEmpty())
+            serializer.setDumpAll(false);
+        else
+            serializer.setDumpProperties(attributes);
+    }
     serializer.createXml(parent);
 
     buff.seek(0);
@@ -23,6 +23,8 @@
 #include "extension_qt/widget_element_handle.h"
 #include "extension_qt/widget_view_handle.h"
 
+#include <ctype.h>
+
 #include <QtCore/QMetaProperty>
 
 namespace webdriver {
@@ -71,12 +73,8 @@ void QWidgetXmlSerializer::addWidget(QObject* widget) {
     QString elementName = getElementName(pWidget);
     writer_.writeStartElement(elementName);
 
-    if (dumpAll_) {
-        for (int propertyIndex = 0; propertyIndex < pWidget->metaObject()->propertyCount(); propertyIndex++) {
-            const QMetaProperty& property = pWidget->metaObject()->property(propertyIndex);
-            writer_.writeAttribute(property.name(), property.read(pWidget).toString());
-        }
-    }
+    if (dumpAll_)
+        writeProperties(pWidget, QString());
 
     if (!pWidget->objectName().isEmpty())
         writer_.writeAttribute("id", pWidget->objectName());
@@ -84,15 +82,7 @@ void QWidgetXmlSerializer::addWidget(QObject* widget) {
     if (!pWidget->windowTitle().isEmpty())
         writer_.writeAttribute("name", pWidget->windowTitle());
 
-    QString elementKey;
-    if (session_) {
-        ElementId elementId = session_->GetElementIdForHandle(viewId_, new QElementHandle(pWidget));
-        if (!elementId.is_valid())
-            session_->AddElement(viewId_, new QElementHandle(pWidget), &elementId);
-        elementKey = QString::fromStdString(elementId.id());
-    } else {
-        elementKey = GenerateRandomID().c_str();
-    }
+    QString elementKey = getElementKey(pWidget);
     elementsMap_.insert(elementKey, QPointer<QObject>(pWidget));
     writer_.writeAttribute("elementId", elementKey);
 
@@ -114,14 +104,8 @@ void QWidgetXmlSerializer::addWidget(QObject* widget) {
         elementsMap_.insert(elementKey, QPointer<QObject>(action));
         writer_.writeAttribute("elementId", elementKey);
 
-        QString skipAttr("text");
-        if (dumpAll_) {
-            for (int propertyIndex = 0; propertyIndex < action->metaObject()->propertyCount(); propertyIndex++) {
-                const QMetaProperty& property = action->metaObject()->property(propertyIndex);
-                if (0 == skipAttr.compare(property.name())) continue;
-                writer_.writeAttribute(property.name(), property.read(action).toString());
-            }
-        }
+        if (dumpAll_)
+            writeProperties(action, QString("text"));
         
         writer_.writeEndElement();
     }
@@ -137,6 +121,89 @@ void QWidgetXmlSerializer::addWidget(QObject* widget) {
     writer_.writeEndElement();
 }
 
+bool QWidgetXmlSerializer::getXPathAttributes(const std::string& query, QStringList* attributes) {
+    if (std::string::npos != query.find("attribute::"))
+        return false;
+
+    size_t pos = query.find('@');
+    while (std::string::npos != pos) {
+        size_t end = pos + 1;
+        while (end < query.length() &&
+               (isalnum(static_cast<unsigned char>(query[end])) ||
+                query[end] == '_' || query[end] == '-' || query[end] == '.')) {
+            ++end;
+        }
+        // "@*" or "@ns:*" like constructs
+        if (end == pos + 1 || (end < query.length() && query[end] == ':'))
+            return false;
+
+        attributes->append(QString::fromLatin1(query.data() + pos + 1, end - pos - 1));
+        pos = query.find('@', end);
+    }
+    return true;
+}
+
+const QWidgetXmlSerializer::PropertyTable& QWidgetXmlSerializer::getPropertyTable(const QMetaObject* metaObject) {
+    QHash<const QMetaObject*, PropertyTable>::const_iterator it = propertyTables_.find(metaObject);
+    if (it != propertyTables_.end())
+        return it.value();
+
+    PropertyTable& table = propertyTables_[metaObject];
+    for (int propertyIndex = 0; propertyIndex < metaObject->propertyCount(); propertyIndex++) {
+        PropertyInfo info;
+        info.property = metaObject->property(propertyIndex);
+        info.name = QString::fromLatin1(info.property.name());
+        if (!dumpProperties_.isEmpty() && !dumpProperties_.contains(info.name))
+            continue;
+        QVariant sample(info.property.userType(), static_cast<const void*>(NULL));
+        info.readable = sample.canConvert(QVariant::String);
+        table.append(info);
+    }
+    return table;
+}
+
+void QWidgetXmlSerializer::writeProperties(QObject* object, const QString& skipAttr) {
+    const PropertyTable& table = getPropertyTable(object->metaObject());
+    for (PropertyTable::const_iterator it = table.begin(); it != table.end(); ++it) {
+        if (!skipAttr.isEmpty() && skipAttr == it->name)
+            continue;
+        if (it->readable)
+            writer_.writeAttribute(it->name, it->property.read(object).toString());
+        else
+            writer_.writeAttribute(it->name, QString());
+    }
+}
+
+QString QWidgetXmlSerializer::getElementKey(QWidget* widget) {
+    if (NULL == session_)
+        return GenerateRandomID().c_str();
+
+    // index elements already known to session once, lookup by pointer then.
+    // Handles of destroyed widgets are kept in session, so clients holding
+    // their ids still get stale element reference.
+    if (!elementsIndexed_) {
+        elementsIndexed_ = true;
+        std::vector<std::pair<ElementId, ElementHandle*> > elements;
+        session_->GetElements(viewId_, &elements);
+        for (size_t i = 0; i < elements.size(); ++i) {
+            QElementHandle* handle = dynamic_cast<QElementHandle*>(elements[i].second);
+            if ((NULL == handle) || !handle->is_valid())
+                continue;
+            knownElements_.insert(handle->get(), QString::fromStdString(elements[i].first.id()));
+        }
+    }
+
+    QHash<const QObject*, QString>::const_iterator it = knownElements_.find(widget);
+    if (it != knownElements_.end())
+        return it.value();
+
+    ElementId elementId;
+    session_->AddElement(viewId_, new QElementHandle(widget), &elementId);
+    QString elementKey = QString::fromStdString(elementId.id());
+    knownElements_.insert(widget, elementKey);
+    return elementKey;
+}
+
 QString QWidgetXmlSerializer::getElementName(const QObject* object) const {
     QString elementName = object->metaObject()->className();
     if (supportedClasses_.empty())
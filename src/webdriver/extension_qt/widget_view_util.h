@@ -29,6 +29,11 @@
 #include <QtGui/QWidget>
 #endif
 
+#include <QtCore/QHash>
+#include <QtCore/QMetaProperty>
+#include <QtCore/QSet>
+#include <QtCore/QVector>
+
 #include "common_util.h"
 #include "webdriver_view_id.h"
 
@@ -52,8 +57,12 @@ private:
 class QWidgetXmlSerializer : public QViewXmlSerializer<QObject> {
 public:
     QWidgetXmlSerializer(QIODevice* buff)
-        : QViewXmlSerializer<QObject>(buff)
-    {}
+        : QViewXmlSerializer<QObject>(buff),
+          elementsIndexed_(false)
+    {
+        // output is parsed by XPath engine or XSLT, indentation only costs time
+        writer_.setAutoFormatting(false);
+    }
 
     void setViewId(ViewId viewId) {
         viewId_ = viewId;
@@ -63,12 +72,39 @@ public:
         supportedClasses_ = classes;
     }
 
+    /// Limits properties written in dumpAll mode to given names.
+    /// Empty list means all properties.
+    void setDumpProperties(const QStringList& properties) {
+        dumpProperties_ = properties.toSet();
+    }
+
+    /// Collects names of attributes referenced by XPath query.
+    /// @return false if query can access any attribute (e.g. "@*")
+    static bool getXPathAttributes(const std::string& query, QStringList* attributes);
+
 private:
+    struct PropertyInfo {
+        QMetaProperty property;
+        QString name;
+        // value of property can be converted to string, otherwise
+        // empty attribute is written without reading property
+        bool readable;
+    };
+    typedef QVector<PropertyInfo> PropertyTable;
+
     virtual void addWidget(QObject* widget);
     QString getElementName(const QObject* object) const;
+    const PropertyTable& getPropertyTable(const QMetaObject* metaObject);
+    void writeProperties(QObject* object, const QString& skipAttr);
+    QString getElementKey(QWidget* widget);
 
     ViewId viewId_;
     QStringList supportedClasses_;
+    QSet<QString> dumpProperties_;
+    QHash<const QMetaObject*, PropertyTable> propertyTables_;
+    // elementIds already registered in session for widgets of view
+    QHash<const QObject*, QString> knownElements_;
+    bool elementsIndexed_;
 };
 
 }  // namespace webdriver
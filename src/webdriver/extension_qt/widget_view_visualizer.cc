@@ -23,11 +23,19 @@
 #include <dlfcn.h>
 #endif
 #include <QtCore/QBuffer>
-#if defined(OS_LINUX)
+#if (1 == WD_ENABLE_XSLT)
+#include <libxml/parser.h>
+#include <libxslt/transform.h>
+#include <libxslt/xslt.h>
+#include <libxslt/xsltutils.h>
+#elif defined(OS_LINUX)
 #include <QtCore/QProcess>
 #endif
 #include "base/file_util.h"
+#include "base/synchronization/lock.h"
+#include "webdriver_server.h"
 #include "webdriver_session.h"
+#include "webdriver_switches.h"
 #include "widget_view_util.h"
 
 namespace webdriver {
@@ -56,12 +64,50 @@ FilePath LookupRecursively(const FilePath& folder, const FilePath& path) {
     return path;
 }
 
-static const FilePath STYLESHEET_PATH = LookupRecursively(CurrentDynamicObjectPath().DirName(), FilePath::FromUTF8Unsafe("src/webdriver/extension_qt/widget_view_visualizer.xsl"));
+static const FilePath STYLESHEET_PATH = LookupRecursively(CurrentDynamicObjectPath().DirName(), FilePath::FromUTF8Unsafe("web/widget_view_visualizer.xsl"));
 static const QString STYLESHEET_WEB_PATH = "http://localhost:9517/widget_view_visualizer.xsl";
+#if (1 != WD_ENABLE_XSLT)
 static const FilePath PROCESSOR_PATH = LookupRecursively(CurrentDynamicObjectPath().DirName(), FilePath::FromUTF8Unsafe("src/third_party/saxon/saxon9he.jar"));
-static bool XSLT_PROCESS = false;
+#endif
 static bool XSLT_INJECT_STYLESHEET = false;
 
+// Source is transformed by driver only on request, otherwise client applies
+// stylesheet itself.
+static bool IsXsltProcessEnabled() {
+    return Server::GetInstance()->GetCommandLine().HasSwitch(Switches::kVisualizerXslt);
+}
+
+#if (1 == WD_ENABLE_XSLT)
+namespace {
+
+// Stylesheet compiled on first use and kept for process lifetime.
+// Compiled stylesheet is read-only during transformation, so it can be
+// shared by sessions.
+class CompiledStylesheet {
+public:
+    CompiledStylesheet() : stylesheet_(NULL), loaded_(false) {}
+
+    xsltStylesheetPtr Get(const FilePath& path) {
+        base::AutoLock lock(lock_);
+        if (!loaded_) {
+            loaded_ = true;
+            stylesheet_ = xsltParseStylesheetFile(
+                    reinterpret_cast<const xmlChar*>(path.AsUTF8Unsafe().c_str()));
+        }
+        return stylesheet_;
+    }
+
+private:
+    base::Lock lock_;
+    xsltStylesheetPtr stylesheet_;
+    bool loaded_;
+};
+
+CompiledStylesheet g_widget_stylesheet;
+
+}  // namespace
+#endif
+
 QWidgetViewVisualizerSourceCommand::QWidgetViewVisualizerSourceCommand(Session* session, ViewId viewId, QWidget* view)
     : session_(session), viewId_(viewId), view_(view)
 {}
@@ -80,19 +126,51 @@ void QWidgetViewVisualizerSourceCommand::Execute(std::string* source, Error** er
         serializer.setStylesheet(STYLESHEET_WEB_PATH);
     }
     serializer.createXml(view_);
-    *source = byteArray.data();
-
-    session_->logger().Log(kInfoLogLevel, "[VisualizerSource] before transform:");
-    session_->logger().Log(kInfoLogLevel, *source);
 
-    if (XSLT_PROCESS) {
-#if defined(OS_LINUX)
-        *source = transform(*source, STYLESHEET_PATH.value());
+    if (IsXsltProcessEnabled()) {
+#if (1 == WD_ENABLE_XSLT)
+        // serialized buffer is parsed in place, without copy to string
+        *source = transform(byteArray);
+        return;
+#elif defined(OS_LINUX)
+        *source = transform(std::string(byteArray.constData(), byteArray.size()), STYLESHEET_PATH.value());
+        return;
 #endif
     }
+    *source = byteArray.data();
 }
 
-#if defined(OS_LINUX)
+#if (1 == WD_ENABLE_XSLT)
+std::string QWidgetViewVisualizerSourceCommand::transform(const QByteArray& source) const {
+    xsltStylesheetPtr stylesheet = g_widget_stylesheet.Get(STYLESHEET_PATH);
+    if (NULL == stylesheet) {
+        session_->logger().Log(kSevereLogLevel, "Can not compile stylesheet " + STYLESHEET_PATH.AsUTF8Unsafe());
+        return "";
+    }
+
+    xmlDocPtr doc = xmlReadMemory(source.constData(), source.size(), NULL, "UTF-8", XML_PARSE_NONET);
+    if (NULL == doc) {
+        session_->logger().Log(kSevereLogLevel, "Can not parse xml for xsl processor!");
+        return "";
+    }
+
+    std::string result;
+    xmlDocPtr transformed = xsltApplyStylesheet(stylesheet, doc, NULL);
+    if (NULL != transformed) {
+        xmlChar* output = NULL;
+        int length = 0;
+        if (0 == xsltSaveResultToString(&output, &length, transformed, stylesheet) && (NULL != output))
+            result.assign(reinterpret_cast<const char*>(output), length);
+        xmlFree(output);
+        xmlFreeDoc(transformed);
+    } else {
+        session_->logger().Log(kSevereLogLevel, "XSL transformation failure!");
+    }
+
+    xmlFreeDoc(doc);
+    return result;
+}
+#elif defined(OS_LINUX)
 std::string QWidgetViewVisualizerSourceCommand::transform(const std::string& source, const std::string& stylesheet) const {
     return transform(source, std::wstring(stylesheet.begin(), stylesheet.end()));
 }
@@ -40,7 +40,9 @@ public:
     void Execute(std::string* source, Error** error);
 
 private:
-#if defined(OS_LINUX)
+#if (1 == WD_ENABLE_XSLT)
+    std::string transform(const QByteArray& source) const;
+#elif defined(OS_LINUX)
     std::string transform(const std::string& source, const std::string& stylesheet) const;
     std::string transform(const std::string& source, const std::wstring& stylesheet) const;
 #endif
@@ -0,0 +1,282 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#include "http_compression.h"
+
+#include <vector>
+
+#include "base/format_macros.h"
+#include "base/logging.h"
+#include "base/string_split.h"
+#include "base/string_util.h"
+#include "base/stringprintf.h"
+
+#if (1 == WD_ENABLE_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace webdriver {
+
+namespace {
+
+// zlib windowBits values selecting stream format.
+const int kMaxWindowBits = 15;
+const int kGzipWindowBits = kMaxWindowBits + 16;
+const int kAutoDetectWindowBits = kMaxWindowBits + 32;
+
+// Size of output block for single deflate()/inflate() call.
+const size_t kZlibBlockSize = 16 * 1024;
+
+// Returns false if |params| of Accept-Encoding element contain "q=0".
+bool IsAcceptable(const std::vector<std::string>& params) {
+    for (size_t i = 1; i < params.size(); ++i) {
+        std::string param;
+        TrimWhitespaceASCII(params[i], TRIM_ALL, &param);
+        if (StartsWithASCII(param, "q=", false)) {
+            std::string q = param.substr(2);
+            TrimString(q, "0.", &q);
+            return !q.empty();
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool IsContentCodingSupported(ContentCoding coding) {
+    if (kIdentityCoding == coding)
+        return true;
+#if (1 == WD_ENABLE_ZLIB)
+    return (kGzipCoding == coding) || (kDeflateCoding == coding);
+#else
+    return false;
+#endif
+}
+
+const char* ContentCodingToString(ContentCoding coding) {
+    switch (coding) {
+        case kIdentityCoding: return "identity";
+        case kGzipCoding: return "gzip";
+        case kDeflateCoding: return "deflate";
+        default: return "unknown";
+    }
+}
+
+ContentCoding ContentCodingFromString(const char* value) {
+    if (NULL == value)
+        return kIdentityCoding;
+
+    std::string coding;
+    TrimWhitespaceASCII(value, TRIM_ALL, &coding);
+    if (coding.empty() || LowerCaseEqualsASCII(coding, "identity"))
+        return kIdentityCoding;
+    if (LowerCaseEqualsASCII(coding, "gzip") || LowerCaseEqualsASCII(coding, "x-gzip"))
+        return kGzipCoding;
+    if (LowerCaseEqualsASCII(coding, "deflate"))
+        return kDeflateCoding;
+    return kUnknownCoding;
+}
+
+ContentCoding NegotiateContentCoding(const char* accept_encoding) {
+    if (NULL == accept_encoding)
+        return kIdentityCoding;
+
+    // Explicitly listed coding takes precedence over "*" in any order.
+    bool gzip = false, gzip_listed = false;
+    bool deflate = false, deflate_listed = false;
+    bool any = false;
+    std::vector<std::string> elements;
+    base::SplitString(accept_encoding, ',', &elements);
+    for (size_t i = 0; i < elements.size(); ++i) {
+        std::vector<std::string> params;
+        base::SplitString(elements[i], ';', &params);
+        if (params.empty())
+            continue;
+        bool acceptable = IsAcceptable(params);
+        std::string name;
+        TrimWhitespaceASCII(params[0], TRIM_ALL, &name);
+        ContentCoding coding = ContentCodingFromString(name.c_str());
+        if (kGzipCoding == coding) {
+            gzip_listed = true;
+            gzip = acceptable;
+        } else if (kDeflateCoding == coding) {
+            deflate_listed = true;
+            deflate = acceptable;
+        } else if (name == "*") {
+            any = acceptable;
+        }
+    }
+    if (!gzip_listed)
+        gzip = any;
+    if (!deflate_listed)
+        deflate = any;
+
+    if (gzip && IsContentCodingSupported(kGzipCoding))
+        return kGzipCoding;
+    if (deflate && IsContentCodingSupported(kDeflateCoding))
+        return kDeflateCoding;
+    return kIdentityCoding;
+}
+
+#if (1 == WD_ENABLE_ZLIB)
+
+struct StreamCompressor::State {
+    z_stream stream;
+    bool finished;
+};
+
+StreamCompressor::StreamCompressor() {}
+
+StreamCompressor::~StreamCompressor() {
+    if (state_.get())
+        deflateEnd(&state_->stream);
+}
+
+bool StreamCompressor::Init(ContentCoding coding, int level) {
+    DCHECK(!state_.get());
+    if (kGzipCoding != coding && kDeflateCoding != coding)
+        return false;
+
+    scoped_ptr<State> state(new State());
+    memset(&state->stream, 0, sizeof(state->stream));
+    state->finished = false;
+    int window_bits = (kGzipCoding == coding) ? kGzipWindowBits : kMaxWindowBits;
+    if (Z_OK != deflateInit2(&state->stream, level, Z_DEFLATED, window_bits,
+                             8, Z_DEFAULT_STRATEGY))
+        return false;
+    state_.reset(state.release());
+    return true;
+}
+
+bool StreamCompressor::Compress(const char* data, size_t length,
+                                bool finish, std::string* out) {
+    if (!state_.get() || state_->finished)
+        return false;
+
+    z_stream* stream = &state_->stream;
+    stream->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream->avail_in = static_cast<uInt>(length);
+
+    int flush = finish ? Z_FINISH : Z_NO_FLUSH;
+    int ret;
+    do {
+        size_t offset = out->length();
+        out->resize(offset + kZlibBlockSize);
+        stream->next_out = reinterpret_cast<Bytef*>(&(*out)[offset]);
+        stream->avail_out = kZlibBlockSize;
+        ret = deflate(stream, flush);
+        out->resize(offset + kZlibBlockSize - stream->avail_out);
+        if (Z_STREAM_ERROR == ret)
+            return false;
+    } while (0 == stream->avail_out || (finish && Z_STREAM_END != ret));
+
+    state_->finished = finish;
+    return true;
+}
+
+bool DecompressContent(ContentCoding coding,
+                       const std::string& input,
+                       size_t max_size,
+                       std::string* output,
+                       std::string* error_msg) {
+    if (kGzipCoding != coding && kDeflateCoding != coding) {
+        *error_msg = "unsupported content coding";
+        return false;
+    }
+
+    // Some clients send "deflate" as raw stream without zlib header.
+    bool raw = (kDeflateCoding == coding) && input.length() >= 2 &&
+               ((static_cast<unsigned char>(input[0]) & 0x0F) != Z_DEFLATED ||
+                ((static_cast<unsigned char>(input[0]) << 8) |
+                  static_cast<unsigned char>(input[1])) % 31 != 0);
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (Z_OK != inflateInit2(&stream, raw ? -kMaxWindowBits : kAutoDetectWindowBits)) {
+        *error_msg = "can't init decompressor";
+        return false;
+    }
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.length());
+
+    output->clear();
+    int ret = Z_OK;
+    while (Z_STREAM_END != ret) {
+        size_t offset = output->length();
+        if (offset >= max_size) {
+            *error_msg = base::StringPrintf("decompressed body is too large (limit %" PRIuS ")",
+                                            max_size);
+            break;
+        }
+        output->resize(offset + kZlibBlockSize);
+        stream.next_out = reinterpret_cast<Bytef*>(&(*output)[offset]);
+        stream.avail_out = kZlibBlockSize;
+        ret = inflate(&stream, Z_NO_FLUSH);
+        output->resize(offset + kZlibBlockSize - stream.avail_out);
+        if (Z_OK != ret && Z_STREAM_END != ret) {
+            *error_msg = "corrupted compressed body";
+            break;
+        }
+        if (Z_OK == ret && 0 == stream.avail_in && 0 != stream.avail_out) {
+            *error_msg = "truncated compressed body";
+            break;
+        }
+    }
+    inflateEnd(&stream);
+
+    if (Z_STREAM_END != ret || output->length() > max_size) {
+        if (error_msg->empty())
+            *error_msg = "corrupted compressed body";
+        output->clear();
+        return false;
+    }
+    return true;
+}
+
+#else  // WD_ENABLE_ZLIB
+
+struct StreamCompressor::State {
+};
+
+StreamCompressor::StreamCompressor() {}
+
+StreamCompressor::~StreamCompressor() {}
+
+bool StreamCompressor::Init(ContentCoding coding, int level) {
+    return false;
+}
+
+bool StreamCompressor::Compress(const char* data, size_t length,
+                                bool finish, std::string* out) {
+    return false;
+}
+
+bool DecompressContent(ContentCoding coding,
+                       const std::string& input,
+                       size_t max_size,
+                       std::string* output,
+                       std::string* error_msg) {
+    *error_msg = "server is built without compression support";
+    return false;
+}
+
+#endif  // WD_ENABLE_ZLIB
+
+}  // namespace webdriver
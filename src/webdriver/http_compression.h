@@ -0,0 +1,83 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef WEBDRIVER_HTTP_COMPRESSION_H_
+#define WEBDRIVER_HTTP_COMPRESSION_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+
+namespace webdriver {
+
+// HTTP content codings known to server. Anything except identity requires
+// build with zlib (WD_ENABLE_ZLIB).
+enum ContentCoding {
+    kIdentityCoding = 0,
+    kGzipCoding,
+    kDeflateCoding,
+    kUnknownCoding
+};
+
+// Returns true if server is able to encode/decode |coding|.
+bool IsContentCodingSupported(ContentCoding coding);
+
+// Returns token for Content-Encoding header, e.g. "gzip".
+const char* ContentCodingToString(ContentCoding coding);
+
+// Parses Content-Encoding header value. NULL or empty value means identity.
+ContentCoding ContentCodingFromString(const char* value);
+
+// Picks preferred supported coding from Accept-Encoding header value,
+// honouring "q=0" exclusions. Returns kIdentityCoding if none is acceptable.
+ContentCoding NegotiateContentCoding(const char* accept_encoding);
+
+// Incremental compressor producing gzip or deflate (zlib) stream.
+class StreamCompressor {
+public:
+    StreamCompressor();
+    ~StreamCompressor();
+
+    // @param coding kGzipCoding or kDeflateCoding
+    // @param level zlib compression level, 1..9
+    bool Init(ContentCoding coding, int level);
+
+    // Compresses |length| bytes of |data| appending output to |out|.
+    // When |finish| is true stream is terminated and no more input accepted.
+    bool Compress(const char* data, size_t length, bool finish, std::string* out);
+
+private:
+    struct State;
+    scoped_ptr<State> state_;
+
+    DISALLOW_COPY_AND_ASSIGN(StreamCompressor);
+};
+
+// Decodes gzip or deflate encoded |input| into |output|. Fails if data is
+// corrupted or decoded size would exceed |max_size|.
+bool DecompressContent(ContentCoding coding,
+                       const std::string& input,
+                       size_t max_size,
+                       std::string* output,
+                       std::string* error_msg);
+
+}  // namespace webdriver
+
+#endif  // WEBDRIVER_HTTP_COMPRESSION_H_
@@ -24,6 +24,7 @@ const int HttpResponse::kNotImplemented = 501;
 namespace {
 
 const char* kContentLengthHeader = "content-length";
+const char* kTransferEncodingHeader = "transfer-encoding";
 
 }  // namespace
 
@@ -113,6 +114,13 @@ std::string HttpResponse::GetReasonPhrase() const {
 }
 
 void HttpResponse::GetData(std::string* data) const {
+    GetHeaderData(data);
+
+    if (body_.length())
+        *data += body_;
+}
+
+void HttpResponse::GetHeaderData(std::string* data) const {
     *data += base::StringPrintf("HTTP/1.1 %d %s\r\n",
         status_, GetReasonPhrase().c_str());
 
@@ -121,16 +129,13 @@ void HttpResponse::GetData(std::string* data) const {
             ++header) {
         *data += header->first + ":" + header->second + "\r\n";
     }
-    std::string length;
-    if (!GetHeader(kContentLengthHeader, &length)) {
+    if (!GetHeader(kContentLengthHeader, NULL) &&
+        !GetHeader(kTransferEncodingHeader, NULL)) {
         *data += base::StringPrintf(
             "%s:%" PRIuS "\r\n",
             kContentLengthHeader, body_.length());
     }
     *data += "\r\n";
-
-    if (body_.length())
-        *data += body_;
 }
 
 int HttpResponse::status() const {
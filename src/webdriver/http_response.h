@@ -61,6 +61,11 @@ public:
     // This will add an appropriate "Content-Length" header if not already set.
     void GetData(std::string* data) const;
 
+    // Appends status line and headers of this response to |data|, including
+    // the terminating empty line. "Content-Length" is added from body unless
+    // it is already set or body is sent with "Transfer-Encoding".
+    void GetHeaderData(std::string* data) const;
+
     int status() const;
     void set_status(int status);
     const std::string& body() const;
@@ -80,8 +80,6 @@ UrlCommandWrapper::UrlCommandWrapper(Command* delegate)
 
 UrlCommandWrapper::~UrlCommandWrapper() {}
 
-typedef scoped_ptr<ViewCmdExecutor> ExecutorPtr;    
-
 void UrlCommandWrapper::ExecutePost(Response* const response) {
     Session* session;
     std::string session_id;
@@ -107,7 +105,7 @@ void UrlCommandWrapper::ExecutePost(Response* const response) {
         }
 
         ViewId current_view = session->current_view();
-	    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session, current_view));
+	    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session, current_view));
         if (NULL == executor.get()) {
             break;
         }
@@ -179,7 +177,7 @@ void UrlCommandWrapper::ExecutePost(Response* const response) {
 
             session->logger().Log(kInfoLogLevel, "New view("+viewId.id()+") created for url - "+url);
 
-		    executor.reset(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session, viewId));
+		    executor = ViewCmdExecutorFactory::GetInstance()->GetExecutor(session, viewId);
    			if (NULL == executor.get()) {
    				session->logger().Log(kSevereLogLevel, "cant get executor for new view.");
         		break;
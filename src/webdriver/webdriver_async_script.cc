@@ -0,0 +1,66 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#include "webdriver_async_script.h"
+
+#include "base/logging.h"
+#include "base/values.h"
+#include "webdriver_error.h"
+
+namespace webdriver {
+
+AsyncScriptResult::AsyncScriptResult()
+    : completed_event_(true, false),
+      completed_(false) {
+}
+
+AsyncScriptResult::~AsyncScriptResult() { }
+
+bool AsyncScriptResult::Complete(base::Value* value, Error* error) {
+    scoped_ptr<base::Value> scoped_value(value);
+    scoped_ptr<Error> scoped_error(error);
+
+    base::AutoLock lock(lock_);
+    if (completed_)
+        return false;
+
+    completed_ = true;
+    value_.swap(scoped_value);
+    error_.swap(scoped_error);
+    completed_event_.Signal();
+    return true;
+}
+
+bool AsyncScriptResult::TimedWait(const base::TimeDelta& timeout) {
+    return completed_event_.TimedWait(timeout);
+}
+
+bool AsyncScriptResult::IsCompleted() const {
+    base::AutoLock lock(lock_);
+    return completed_;
+}
+
+Error* AsyncScriptResult::TakeResult(base::Value** value) {
+    base::AutoLock lock(lock_);
+    DCHECK(completed_);
+    *value = value_.release();
+    return error_.release();
+}
+
+}  // namespace webdriver
@@ -46,9 +46,22 @@ const char Capabilities::kWindowPosition[]              = "windowposition";
 const char Capabilities::kMaximize[]                    = "maximize";
 const char Capabilities::kHybrid[]                      = "hybrid";
 const char Capabilities::kReuseUI[]                     = "reuseUI";
+const char Capabilities::kBulkTextInput[]               = "bulkTextInput";
+const char Capabilities::kPageLoadStrategy[]            = "pageLoadStrategy";
+const char Capabilities::kNetworkRules[]                = "networkRules";
+const char Capabilities::kScreenshotSource[]            = "screenshotSource";
+const char Capabilities::kReuseScreenshots[]            = "reuseScreenshots";
 
 namespace {
 
+const char* const kPageLoadStrategyNames[] = {
+    "none", "eager", "normal", "networkIdle"
+};
+
+const char* const kScreenshotSourceNames[] = {
+    "view", "vnc"
+};
+
 Error* CreateBadInputError(const std::string& name,
                            Value::Type type,
                            const Value* option) {
@@ -61,9 +74,21 @@ Error* CreateBadInputError(const std::string& name,
 
 }  // namespace
 
+const char* PageLoadStrategyToString(PageLoadStrategy strategy) {
+    return kPageLoadStrategyNames[strategy];
+}
+
+const char* ScreenshotSourceToString(ScreenshotSource source) {
+    return kScreenshotSourceNames[source];
+}
+
 Capabilities::Capabilities()
     : options(CommandLine::NO_PROGRAM),
       load_async(false),
+      bulk_text_input(false),
+      page_load_strategy(kNormalPageLoad),
+      screenshot_source(kViewScreenshotSource),
+      reuse_screenshots(false),
       caps(new DictionaryValue()) {
     log_levels[LogType::kDriver] = kAllLogLevel;
     log_levels[LogType::kBrowser] = kAllLogLevel;
@@ -109,6 +134,11 @@ Error* CapabilitiesParser::Parse() {
     std::map<std::string, Parser> parser_map;
   
     parser_map[Capabilities::kLoadAsync] = &CapabilitiesParser::ParseLoadAsync;
+    parser_map[Capabilities::kBulkTextInput] = &CapabilitiesParser::ParseBulkTextInput;
+    parser_map[Capabilities::kPageLoadStrategy] = &CapabilitiesParser::ParsePageLoadStrategy;
+    parser_map[Capabilities::kNetworkRules] = &CapabilitiesParser::ParseNetworkRules;
+    parser_map[Capabilities::kScreenshotSource] = &CapabilitiesParser::ParseScreenshotSource;
+    parser_map[Capabilities::kReuseScreenshots] = &CapabilitiesParser::ParseReuseScreenshots;
     parser_map[Capabilities::kBrowserStartWindow] = &CapabilitiesParser::ParseBrowserStartWindow;
     parser_map[Capabilities::kBrowserClass] = &CapabilitiesParser::ParseBrowserClass;
 
@@ -141,6 +171,50 @@ Error* CapabilitiesParser::ParseLoadAsync(const Value* option) {
     return NULL;
 }
 
+Error* CapabilitiesParser::ParseBulkTextInput(const Value* option) {
+    if (!option->GetAsBoolean(&caps_->bulk_text_input))
+        return CreateBadInputError("bulkTextInput", Value::TYPE_BOOLEAN, option);
+    return NULL;
+}
+
+Error* CapabilitiesParser::ParseReuseScreenshots(const Value* option) {
+    if (!option->GetAsBoolean(&caps_->reuse_screenshots))
+        return CreateBadInputError("reuseScreenshots", Value::TYPE_BOOLEAN, option);
+    return NULL;
+}
+
+Error* CapabilitiesParser::ParsePageLoadStrategy(const Value* option) {
+    std::string strategy;
+    if (!option->GetAsString(&strategy))
+        return CreateBadInputError("pageLoadStrategy", Value::TYPE_STRING, option);
+
+    for (size_t i = 0; i < arraysize(kPageLoadStrategyNames); ++i) {
+        if (strategy == kPageLoadStrategyNames[i]) {
+            caps_->page_load_strategy = static_cast<PageLoadStrategy>(i);
+            return NULL;
+        }
+    }
+    return new Error(kBadRequest, "Unknown pageLoadStrategy: " + strategy);
+}
+
+Error* CapabilitiesParser::ParseNetworkRules(const Value* option) {
+    return caps_->network_rules.Parse(option);
+}
+
+Error* CapabilitiesParser::ParseScreenshotSource(const Value* option) {
+    std::string source;
+    if (!option->GetAsString(&source))
+        return CreateBadInputError("screenshotSource", Value::TYPE_STRING, option);
+
+    for (size_t i = 0; i < arraysize(kScreenshotSourceNames); ++i) {
+        if (source == kScreenshotSourceNames[i]) {
+            caps_->screenshot_source = static_cast<ScreenshotSource>(i);
+            return NULL;
+        }
+    }
+    return new Error(kBadRequest, "Unknown screenshotSource: " + source);
+}
+
 Error* CapabilitiesParser::ParseLoggingPrefs(const base::Value* option) {
     const DictionaryValue* logging_prefs;
     if (!option->GetAsDictionary(&logging_prefs))
@@ -0,0 +1,467 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#include "webdriver_input_actions.h"
+
+#include <algorithm>
+
+#include "base/stringprintf.h"
+#include "base/utf_string_conversions.h"
+#include "base/values.h"
+#include "webdriver_element_id.h"
+#include "webdriver_error.h"
+#include "webdriver_view_executor.h"
+
+namespace webdriver {
+
+namespace {
+
+const char kKeySource[] = "key";
+const char kPointerSource[] = "pointer";
+const char kNoneSource[] = "none";
+
+bool IsTouchSource(const std::string& type, PointerType pointer_type) {
+    return (type == kPointerSource) && (kTouchPointer == pointer_type);
+}
+
+bool ParsePointerType(const base::DictionaryValue* source, PointerType* pointer_type) {
+    *pointer_type = kMousePointer;
+
+    const base::DictionaryValue* parameters = NULL;
+    if (!source->GetDictionary("parameters", &parameters))
+        return true;
+
+    std::string name;
+    if (!parameters->GetString("pointerType", &name) || name == "mouse")
+        return true;
+
+    if (name == "pen") {
+        *pointer_type = kPenPointer;
+        return true;
+    }
+    if (name == "touch") {
+        *pointer_type = kTouchPointer;
+        return true;
+    }
+    return false;
+}
+
+bool GetDuration(const base::DictionaryValue* action, int* duration, Error** error) {
+    *duration = 0;
+    if (!action->HasKey("duration"))
+        return true;
+
+    double value = 0;
+    if (!action->GetDouble("duration", &value) || value < 0) {
+        *error = new Error(kBadRequest, "'duration' must be non-negative number");
+        return false;
+    }
+    *duration = static_cast<int>(value);
+    return true;
+}
+
+}  // namespace
+
+InputTouchPoint::InputTouchPoint(int id, State state, const Point& position)
+    : id(id), state(state), position(position) {}
+
+InputAction::InputAction()
+    : type(kPointerMove), time(0), button(kLeftButton), buttons(0), position(0, 0) {}
+
+InputState::Source::Source()
+    : pointer_type(kMousePointer), position(0, 0), buttons(0), touching(false), touch_id(0) {}
+
+InputState::InputState() : next_touch_id_(1) {}
+
+InputState::~InputState() {}
+
+struct InputTimelineBuilder::RawEvent {
+    RawEvent() : type(InputAction::kPointerMove), time(0), button(kLeftButton), position(0, 0) {}
+
+    bool operator<(const RawEvent& other) const { return time < other.time; }
+
+    std::string source;
+    InputAction::Type type;
+    int time;
+    string16 key;
+    MouseButton button;
+    Point position;
+};
+
+const int InputTimelineBuilder::kPointerMoveInterval = 16;
+
+InputTimelineBuilder::InputTimelineBuilder(ViewCmdExecutor* executor, const InputState& state,
+                                           const Point& mouse_position)
+    : executor_(executor),
+      state_(state),
+      mouse_position_(mouse_position) {}
+
+InputTimelineBuilder::~InputTimelineBuilder() {}
+
+bool InputTimelineBuilder::Build(const base::ListValue* actions, InputTimeline* timeline, Error** error) {
+    std::vector<std::string> ids;
+    std::vector<const base::ListValue*> sequences;
+    size_t ticks = 0;
+
+    for (size_t i = 0; i < actions->GetSize(); ++i) {
+        const base::DictionaryValue* source = NULL;
+        std::string id, type;
+        const base::ListValue* sequence = NULL;
+        PointerType pointer_type = kMousePointer;
+
+        if (!actions->GetDictionary(i, &source) ||
+            !source->GetString("id", &id) ||
+            !source->GetString("type", &type) ||
+            !source->GetList("actions", &sequence)) {
+            *error = new Error(kBadRequest, "input source must have 'id', 'type' and 'actions'");
+            return false;
+        }
+
+        if (type != kKeySource && type != kPointerSource && type != kNoneSource) {
+            *error = new Error(kBadRequest, "unsupported input source type: " + type);
+            return false;
+        }
+
+        if (type == kPointerSource && !ParsePointerType(source, &pointer_type)) {
+            *error = new Error(kBadRequest, "unsupported pointer type of source: " + id);
+            return false;
+        }
+
+        InputState::SourcesMap::iterator it = state_.sources_.find(id);
+        if (it != state_.sources_.end()) {
+            if (it->second.type != type || it->second.pointer_type != pointer_type) {
+                *error = new Error(kBadRequest, "input source was used with different type: " + id);
+                return false;
+            }
+        } else {
+            InputState::Source& created = state_.sources_[id];
+            created.type = type;
+            created.pointer_type = pointer_type;
+            if (type == kPointerSource && kTouchPointer != pointer_type)
+                created.position = mouse_position_;
+        }
+
+        ids.push_back(id);
+        sequences.push_back(sequence);
+        ticks = std::max(ticks, sequence->GetSize());
+    }
+
+    raw_events_.clear();
+    int time = 0;
+
+    for (size_t tick = 0; tick < ticks; ++tick) {
+        int tick_duration = 0;
+
+        for (size_t i = 0; i < sequences.size(); ++i) {
+            if (tick >= sequences[i]->GetSize())
+                continue;
+
+            const base::DictionaryValue* action = NULL;
+            std::string subtype;
+            if (!sequences[i]->GetDictionary(tick, &action) ||
+                !action->GetString("type", &subtype)) {
+                *error = new Error(kBadRequest, "action must have 'type'");
+                return false;
+            }
+
+            const std::string& type = state_.sources_[ids[i]].type;
+            int duration = 0;
+
+            if (subtype == "pause") {
+                if (!GetDuration(action, &duration, error))
+                    return false;
+            } else if (type == kKeySource) {
+                if (!ParseKeyAction(ids[i], action, subtype, time, error))
+                    return false;
+            } else if (type == kPointerSource) {
+                if (!ParsePointerAction(ids[i], action, subtype, time, &duration, error))
+                    return false;
+            } else {
+                *error = new Error(kBadRequest, "unsupported action for source: " + ids[i]);
+                return false;
+            }
+
+            tick_duration = std::max(tick_duration, duration);
+        }
+
+        time += tick_duration;
+    }
+
+    ComposeTimeline(timeline);
+    return true;
+}
+
+void InputTimelineBuilder::BuildRelease(InputTimeline* timeline) {
+    raw_events_.clear();
+
+    InputState::SourcesMap::iterator it;
+    for (it = state_.sources_.begin(); it != state_.sources_.end(); ++it) {
+        const InputState::Source& source = it->second;
+
+        std::set<string16>::const_iterator key;
+        for (key = source.pressed_keys.begin(); key != source.pressed_keys.end(); ++key) {
+            AddRawEvent(it->first, InputAction::kKeyUp, 0);
+            raw_events_.back().key = *key;
+        }
+
+        if (IsTouchSource(source.type, source.pointer_type)) {
+            if (source.touching)
+                AddRawEvent(it->first, InputAction::kPointerUp, 0);
+            continue;
+        }
+
+        for (int button = kLeftButton; button <= kRightButton; ++button) {
+            if (source.buttons & (1 << button)) {
+                AddRawEvent(it->first, InputAction::kPointerUp, 0);
+                raw_events_.back().button = static_cast<MouseButton>(button);
+            }
+        }
+    }
+
+    ComposeTimeline(timeline);
+    state_.sources_.clear();
+}
+
+bool InputTimelineBuilder::ParseKeyAction(const std::string& source_id, const base::DictionaryValue* action,
+                                          const std::string& subtype, int time, Error** error) {
+    InputAction::Type type;
+    if (subtype == "keyDown") {
+        type = InputAction::kKeyDown;
+    } else if (subtype == "keyUp") {
+        type = InputAction::kKeyUp;
+    } else {
+        *error = new Error(kBadRequest, "unsupported key action: " + subtype);
+        return false;
+    }
+
+    std::string value;
+    if (!action->GetString("value", &value) || value.empty()) {
+        *error = new Error(kBadRequest, "key action must have 'value'");
+        return false;
+    }
+
+    AddRawEvent(source_id, type, time);
+    raw_events_.back().key = UTF8ToUTF16(value);
+    return true;
+}
+
+bool InputTimelineBuilder::ParsePointerAction(const std::string& source_id, const base::DictionaryValue* action,
+                                              const std::string& subtype, int time, int* duration, Error** error) {
+    InputState::Source& source = state_.sources_[source_id];
+
+    if (subtype == "pointerDown" || subtype == "pointerUp") {
+        int button = kLeftButton;
+        if (action->HasKey("button") &&
+            (!action->GetInteger("button", &button) || button < kLeftButton || button > kRightButton)) {
+            *error = new Error(kBadRequest, "unsupported pointer button");
+            return false;
+        }
+
+        AddRawEvent(source_id, (subtype == "pointerDown") ? InputAction::kPointerDown : InputAction::kPointerUp, time);
+        raw_events_.back().button = static_cast<MouseButton>(button);
+        return true;
+    }
+
+    if (subtype != "pointerMove") {
+        *error = new Error(kBadRequest, "unsupported pointer action: " + subtype);
+        return false;
+    }
+
+    Point target;
+    if (!GetDuration(action, duration, error) ||
+        !GetMoveTarget(source_id, action, &target, error))
+        return false;
+
+    Point start = source.position;
+    int steps = std::max(1, *duration / kPointerMoveInterval);
+
+    for (int step = 1; step <= steps; ++step) {
+        AddRawEvent(source_id, InputAction::kPointerMove, time + (*duration) * step / steps);
+        raw_events_.back().position = Point(
+                start.x() + (target.x() - start.x()) * step / steps,
+                start.y() + (target.y() - start.y()) * step / steps);
+    }
+
+    source.position = target;
+    return true;
+}
+
+bool InputTimelineBuilder::GetMoveTarget(const std::string& source_id, const base::DictionaryValue* action,
+                                         Point* target, Error** error) {
+    double x = 0, y = 0;
+    if ((action->HasKey("x") && !action->GetDouble("x", &x)) ||
+        (action->HasKey("y") && !action->GetDouble("y", &y))) {
+        *error = new Error(kBadRequest, "'x' and 'y' must be numbers");
+        return false;
+    }
+
+    const base::Value* origin = NULL;
+    std::string origin_name = "viewport";
+    if (action->Get("origin", &origin) &&
+        !origin->GetAsString(&origin_name)) {
+        ElementId element(origin);
+        if (!element.is_valid()) {
+            *error = new Error(kBadRequest, "'origin' must be 'viewport', 'pointer' or element");
+            return false;
+        }
+
+        Point location;
+        Size size;
+        executor_->GetElementLocationInView(element, &location, error);
+        if (*error)
+            return false;
+        executor_->GetElementSize(element, &size, error);
+        if (*error)
+            return false;
+
+        *target = Point(location.x() + size.width() / 2 + x,
+                        location.y() + size.height() / 2 + y);
+        return true;
+    }
+
+    if (origin_name == "viewport") {
+        *target = Point(x, y);
+    } else if (origin_name == "pointer") {
+        *target = state_.sources_[source_id].position;
+        target->Offset(x, y);
+    } else {
+        *error = new Error(kBadRequest, "unsupported 'origin': " + origin_name);
+        return false;
+    }
+    return true;
+}
+
+void InputTimelineBuilder::AddRawEvent(const std::string& source_id, InputAction::Type type, int time) {
+    RawEvent event;
+    event.source = source_id;
+    event.type = type;
+    event.time = time;
+    event.position = state_.sources_[source_id].position;
+    raw_events_.push_back(event);
+}
+
+void InputTimelineBuilder::ComposeTimeline(InputTimeline* timeline) {
+    // raw events of one tick are added in source order, moves may go
+    // beyond tick start, so only time has to be restored
+    std::stable_sort(raw_events_.begin(), raw_events_.end());
+
+    size_t begin = 0;
+    while (begin < raw_events_.size()) {
+        const int time = raw_events_[begin].time;
+        TouchedMap touched;
+        size_t end = begin;
+
+        for (; end < raw_events_.size() && raw_events_[end].time == time; ++end) {
+            const RawEvent& raw = raw_events_[end];
+            InputState::Source& source = state_.sources_[raw.source];
+
+            if (IsTouchSource(source.type, source.pointer_type)) {
+                // contacts changed at same time go into single touch event,
+                // unless contact is pressed or released again, e.g. by tap
+                TouchedMap::const_iterator pending = touched.find(raw.source);
+                if (pending != touched.end() &&
+                    InputTouchPoint::kMoved != pending->second &&
+                    InputAction::kPointerMove != raw.type)
+                    FlushTouch(time, &touched, timeline);
+
+                if (InputAction::kPointerDown == raw.type && !source.touching) {
+                    source.touching = true;
+                    source.touch_id = state_.next_touch_id_++;
+                    touched[raw.source] = InputTouchPoint::kPressed;
+                } else if (InputAction::kPointerUp == raw.type && source.touching) {
+                    touched[raw.source] = InputTouchPoint::kReleased;
+                } else if (InputAction::kPointerMove == raw.type && source.touching &&
+                           !touched.count(raw.source)) {
+                    touched[raw.source] = InputTouchPoint::kMoved;
+                }
+                source.position = raw.position;
+                continue;
+            }
+
+            // keep order of touch and other sources
+            FlushTouch(time, &touched, timeline);
+
+            InputAction action;
+            action.type = raw.type;
+            action.time = raw.time;
+
+            if (InputAction::kKeyDown == raw.type) {
+                if (!source.pressed_keys.insert(raw.key).second)
+                    continue;
+                action.key = raw.key;
+            } else if (InputAction::kKeyUp == raw.type) {
+                if (0 == source.pressed_keys.erase(raw.key))
+                    continue;
+                action.key = raw.key;
+            } else {
+                const int mask = 1 << raw.button;
+                if (InputAction::kPointerDown == raw.type) {
+                    if (source.buttons & mask)
+                        continue;
+                    source.buttons |= mask;
+                } else if (InputAction::kPointerUp == raw.type) {
+                    if (!(source.buttons & mask))
+                        continue;
+                    source.buttons &= ~mask;
+                }
+                action.button = raw.button;
+                action.buttons = source.buttons;
+                action.position = raw.position;
+                if (kMousePointer == source.pointer_type)
+                    mouse_position_ = raw.position;
+            }
+
+            timeline->push_back(action);
+        }
+
+        FlushTouch(time, &touched, timeline);
+        begin = end;
+    }
+
+    raw_events_.clear();
+}
+
+void InputTimelineBuilder::FlushTouch(int time, TouchedMap* touched, InputTimeline* timeline) {
+    if (touched->empty())
+        return;
+
+    InputAction action;
+    action.type = InputAction::kTouch;
+    action.time = time;
+
+    InputState::SourcesMap::iterator it;
+    for (it = state_.sources_.begin(); it != state_.sources_.end(); ++it) {
+        InputState::Source& source = it->second;
+        if (!IsTouchSource(source.type, source.pointer_type) || !source.touching)
+            continue;
+
+        TouchedMap::const_iterator state = touched->find(it->first);
+        InputTouchPoint::State point_state =
+                (state != touched->end()) ? state->second : InputTouchPoint::kStationary;
+        action.touch_points.push_back(InputTouchPoint(source.touch_id, point_state, source.position));
+
+        if (InputTouchPoint::kReleased == point_state)
+            source.touching = false;
+    }
+
+    timeline->push_back(action);
+    touched->clear();
+}
+
+}  // namespace webdriver
@@ -260,6 +260,10 @@ void StdOutLog::set_min_log_level(LogLevel level) {
     min_log_level_ = level;
 }
 
+LogLevel StdOutLog::min_log_level() const {
+    return min_log_level_;
+}
+
 InMemoryLog::InMemoryLog() { }
 
 InMemoryLog::~InMemoryLog() {  }
@@ -284,6 +288,13 @@ void InMemoryLog::clear_entries_list() {
     entries_list_.Clear();
 }
 
+ListValue* InMemoryLog::TakeEntries() {
+    ListValue* entries = new ListValue();
+    base::AutoLock auto_lock(entries_lock_);
+    entries->Swap(&entries_list_);
+    return entries;
+}
+
 PerfLog::PerfLog(): min_log_level_(kOffLogLevel) { }
 
 PerfLog::~PerfLog() { }
@@ -319,6 +330,10 @@ void Logger::Log(LogLevel level, const std::string& message) const {
     }
 }
 
+bool Logger::IsLoggable(LogLevel level) const {
+    return level >= min_log_level_ && !handlers_.empty();
+}
+
 void Logger::AddHandler(LogHandler* log_handler) {
     handlers_.push_back(log_handler);
 }
@@ -0,0 +1,213 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#include "webdriver_network_rules.h"
+
+#include <algorithm>
+
+#include "base/string_util.h"
+#include "base/values.h"
+#include "webdriver_error.h"
+
+namespace webdriver {
+
+namespace {
+
+const char kHostPatternPrefix[] = "*.";
+
+// "ads.example.com" -> "moc.elpmaxe.sda.", leading dot keeps "*.example.com"
+// from matching "badexample.com".
+std::string ReverseHost(const std::string& host) {
+    std::string reversed = "." + StringToLowerASCII(host);
+    std::reverse(reversed.begin(), reversed.end());
+    return reversed;
+}
+
+Error* GetPatternList(const base::DictionaryValue* dict,
+                      const std::string& key,
+                      std::vector<std::string>* patterns) {
+    const base::Value* value;
+    if (!dict->GetWithoutPathExpansion(key, &value))
+        return NULL;
+    const base::ListValue* list;
+    if (!value->GetAsList(&list))
+        return new Error(kBadRequest, "networkRules." + key + " must be a list");
+    for (size_t i = 0; i < list->GetSize(); ++i) {
+        std::string pattern;
+        if (!list->GetString(i, &pattern) || pattern.empty())
+            return new Error(kBadRequest,
+                             "networkRules." + key + " must contain non-empty strings");
+        patterns->push_back(pattern);
+    }
+    return NULL;
+}
+
+}  // namespace
+
+PrefixTrie::PrefixTrie() : nodes_(1) {}
+
+PrefixTrie::~PrefixTrie() {}
+
+int PrefixTrie::FindChild(int node, unsigned char c) const {
+    const std::vector<std::pair<unsigned char, int> >& children =
+        nodes_[node].children;
+    std::vector<std::pair<unsigned char, int> >::const_iterator it =
+        std::lower_bound(children.begin(), children.end(),
+                         std::make_pair(c, -1));
+    if (it == children.end() || it->first != c)
+        return -1;
+    return it->second;
+}
+
+void PrefixTrie::Insert(const std::string& key, int value) {
+    int node = 0;
+    for (size_t i = 0; i < key.length(); ++i) {
+        const unsigned char c = static_cast<unsigned char>(key[i]);
+        int next = FindChild(node, c);
+        if (next < 0) {
+            next = static_cast<int>(nodes_.size());
+            nodes_.push_back(Node());
+            std::vector<std::pair<unsigned char, int> >& children =
+                nodes_[node].children;
+            children.insert(
+                std::lower_bound(children.begin(), children.end(),
+                                 std::make_pair(c, -1)),
+                std::make_pair(c, next));
+        }
+        node = next;
+    }
+    nodes_[node].value = value;
+}
+
+int PrefixTrie::FindLongestPrefix(const std::string& text, size_t* length) const {
+    int node = 0;
+    int found = nodes_[0].value;
+    size_t found_length = 0;
+    for (size_t i = 0; i < text.length(); ++i) {
+        node = FindChild(node, static_cast<unsigned char>(text[i]));
+        if (node < 0)
+            break;
+        if (nodes_[node].value >= 0) {
+            found = nodes_[node].value;
+            found_length = i + 1;
+        }
+    }
+    if (length)
+        *length = found_length;
+    return found;
+}
+
+void NetworkRules::PatternSet::Add(const std::string& pattern) {
+    if (StartsWithASCII(pattern, kHostPatternPrefix, true)) {
+        reversed_hosts.Insert(
+            ReverseHost(pattern.substr(arraysize(kHostPatternPrefix) - 1)), 0);
+    } else {
+        url_prefixes.Insert(pattern, 0);
+    }
+}
+
+bool NetworkRules::PatternSet::Matches(const std::string& url,
+                                       const std::string& reversed_host) const {
+    return url_prefixes.FindLongestPrefix(url, NULL) >= 0 ||
+           reversed_hosts.FindLongestPrefix(reversed_host, NULL) >= 0;
+}
+
+bool NetworkRules::PatternSet::empty() const {
+    return url_prefixes.empty() && reversed_hosts.empty();
+}
+
+NetworkRules::NetworkRules() {}
+
+NetworkRules::~NetworkRules() {}
+
+Error* NetworkRules::Parse(const base::Value* value) {
+    const base::DictionaryValue* dict;
+    if (!value->GetAsDictionary(&dict))
+        return new Error(kBadRequest, "networkRules must be a dictionary");
+
+    std::vector<std::string> patterns;
+    Error* error = GetPatternList(dict, "block", &patterns);
+    if (error)
+        return error;
+    for (size_t i = 0; i < patterns.size(); ++i)
+        AddBlockPattern(patterns[i]);
+
+    patterns.clear();
+    error = GetPatternList(dict, "allow", &patterns);
+    if (error)
+        return error;
+    for (size_t i = 0; i < patterns.size(); ++i)
+        AddAllowPattern(patterns[i]);
+
+    const base::Value* rewrite_value;
+    if (dict->GetWithoutPathExpansion("rewrite", &rewrite_value)) {
+        const base::DictionaryValue* rewrite;
+        if (!rewrite_value->GetAsDictionary(&rewrite))
+            return new Error(kBadRequest, "networkRules.rewrite must be a dictionary");
+        for (base::DictionaryValue::Iterator it(*rewrite); it.HasNext(); it.Advance()) {
+            std::string replacement;
+            if (it.key().empty() || !it.value().GetAsString(&replacement))
+                return new Error(kBadRequest,
+                                 "networkRules.rewrite must map URL prefixes to strings");
+            AddRewrite(it.key(), replacement);
+        }
+    }
+    return NULL;
+}
+
+void NetworkRules::AddBlockPattern(const std::string& pattern) {
+    blocked_.Add(pattern);
+}
+
+void NetworkRules::AddAllowPattern(const std::string& pattern) {
+    allowed_.Add(pattern);
+}
+
+void NetworkRules::AddRewrite(const std::string& prefix,
+                              const std::string& replacement) {
+    rewrite_prefixes_.Insert(prefix, static_cast<int>(rewrite_replacements_.size()));
+    rewrite_replacements_.push_back(replacement);
+}
+
+bool NetworkRules::empty() const {
+    return blocked_.empty() && rewrite_replacements_.empty();
+}
+
+NetworkRules::Action NetworkRules::Match(const std::string& url,
+                                         const std::string& host,
+                                         std::string* rewritten_url) const {
+    if (empty())
+        return kAllowRequest;
+
+    if (!blocked_.empty()) {
+        const std::string reversed_host = ReverseHost(host);
+        if (blocked_.Matches(url, reversed_host) &&
+            !allowed_.Matches(url, reversed_host))
+            return kBlockRequest;
+    }
+
+    size_t length;
+    const int rewrite = rewrite_prefixes_.FindLongestPrefix(url, &length);
+    if (rewrite < 0)
+        return kAllowRequest;
+    *rewritten_url = rewrite_replacements_[rewrite] + url.substr(length);
+    return kRewriteRequest;
+}
+
+}  // namespace webdriver
@@ -105,6 +105,7 @@ bool CommandRoutes::IsStandardRoute(const std::string& pattern) {
 		standardCommandRoutes.insert(kTouchDoubleClick);
 		standardCommandRoutes.insert(kTouchLongClick);
 		standardCommandRoutes.insert(kTouchFlick);
+		standardCommandRoutes.insert(kActions);
 		standardCommandRoutes.insert(kOrientation);
 		standardCommandRoutes.insert(kXdrpc);
 		standardCommandRoutes.insert(kCiscoPlayerState);
@@ -196,6 +197,7 @@ const char CommandRoutes::kTouchScroll[]  				= "/session/*/touch/scroll";
 const char CommandRoutes::kTouchDoubleClick[]			= "/session/*/touch/doubleclick";
 const char CommandRoutes::kTouchLongClick[]  			= "/session/*/touch/longclick";
 const char CommandRoutes::kTouchFlick[]					= "/session/*/touch/flick";
+const char CommandRoutes::kActions[]					= "/session/*/actions";
 const char CommandRoutes::kOrientation[]				= "/session/*/orientation";
 const char CommandRoutes::kXdrpc[]						= "/xdrpc";
 const char CommandRoutes::kCiscoPlayerState[]           = "/session/*/element/*/-cisco-player-element/state";
@@ -205,6 +207,9 @@ const char CommandRoutes::kCiscoPlayerMute[]            = "/session/*/element/*/
 const char CommandRoutes::kCiscoPlayerPlayingSpeed[]    = "/session/*/element/*/-cisco-player-element/speed";
 const char CommandRoutes::kVisualizerSource[]           = "/session/*/-cisco-visualizer-source";
 const char CommandRoutes::kVisualizerShowPoint[]        = "/session/*/-cisco-visualizer-show-point";
+const char CommandRoutes::kCiscoScreenshot[]            = "/session/*/-cisco-screenshot/*";
+const char CommandRoutes::kCiscoScreenshotStream[]      = "/session/*/-cisco-screenshot-stream";
+const char CommandRoutes::kCiscoSourceDiff[]            = "/session/*/-cisco-source-diff";
 const char CommandRoutes::kTouchPinchZoom[]             = "/session/*/touch/-cisco-pinch-zoom";
 const char CommandRoutes::kTouchPinchRotate[]           = "/session/*/touch/-cisco-pinch-rotate";
 const char CommandRoutes::kShutdown[]                   = "/shutdown";
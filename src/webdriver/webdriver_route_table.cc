@@ -37,6 +37,7 @@
 #include "commands/cisco_player_commands.h"
 #include "commands/xdrpc_command.h"
 #include "commands/touch_commands.h"
+#include "commands/actions_command.h"
 #include "commands/orientation_command.h"
 #include "commands/visualizer_commands.h"
 #include "commands/browser_connection_command.h"
@@ -102,11 +103,18 @@ std::vector<std::string> RouteTable::GetRoutes() {
 }
 
 CommandCreatorPtr RouteTable::GetRouteForURL(const std::string& url, std::string* pattern) const {
+    std::vector<std::string> url_segments;
+    base::SplitString(url, '/', &url_segments);
+
+    return GetRouteForURL(url_segments, pattern);
+}
+
+CommandCreatorPtr RouteTable::GetRouteForURL(const std::vector<std::string>& url_segments, std::string* pattern) const {
     std::vector<webdriver::internal::RouteDetails>::const_iterator route;
     for (route = routes_.begin();
          route < routes_.end();
          ++route) {
-        if (MatchPattern(url, route->uri_regex_)) {
+        if (MatchPattern(url_segments, route->segments_)) {
             if (NULL != pattern) {
                 *pattern = route->uri_regex_;
             }
@@ -179,13 +187,8 @@ bool RouteTable::CheckCustomPrefix(const std::string& prefix) {
     return true;
 }
 
-bool RouteTable::MatchPattern(const std::string& url, const std::string& pattern) const {
-    std::vector<std::string> url_segments;
-    std::vector<std::string> pattern_segments;
-
-    base::SplitString(url, '/', &url_segments);
-    base::SplitString(pattern, '/', &pattern_segments);
-
+bool RouteTable::MatchPattern(const std::vector<std::string>& url_segments,
+                              const std::vector<std::string>& pattern_segments) const {
     unsigned int segments_num = url_segments.size();
 
     if (segments_num != pattern_segments.size()) {
@@ -310,6 +313,7 @@ DefaultRouteTable::DefaultRouteTable()
     Add<TouchDoubleClickCommand>        (CommandRoutes::kTouchDoubleClick);
     Add<TouchLongClickCommand>          (CommandRoutes::kTouchLongClick);
     Add<TouchFlickCommand>              (CommandRoutes::kTouchFlick);
+    Add<ActionsCommand>                 (CommandRoutes::kActions);
     Add<OrientationCommand>             (CommandRoutes::kOrientation);
     Add<XDRPCCommand>                   (CommandRoutes::kXdrpc);
     Add<CISCO_StateCommand>             (CommandRoutes::kCiscoPlayerState);
@@ -319,6 +323,9 @@ DefaultRouteTable::DefaultRouteTable()
     Add<CISCO_PlaybackSpeedCommand>     (CommandRoutes::kCiscoPlayerPlayingSpeed);
     Add<VisualizerSourceCommand>        (CommandRoutes::kVisualizerSource);
     Add<VisualizerShowPointCommand>     (CommandRoutes::kVisualizerShowPoint);
+    Add<RawScreenshotCommand>           (CommandRoutes::kCiscoScreenshot);
+    Add<ScreenshotStreamCommand>        (CommandRoutes::kCiscoScreenshotStream);
+    Add<IncrementalSourceCommand>       (CommandRoutes::kCiscoSourceDiff);
     Add<TouchPinchZoomCommand>          (CommandRoutes::kTouchPinchZoom);
     Add<TouchPinchRotateCommand>        (CommandRoutes::kTouchPinchRotate);
 
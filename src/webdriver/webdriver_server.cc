@@ -10,10 +10,11 @@
 #include "mongoose.h"
 
 #include <iostream>
+#include <limits>
 
 //#include "base/command_line.h"
-//#include "base/format_macros.h"
 #include "base/file_util.h"
+#include "base/format_macros.h"
 #include "base/json/json_reader.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/string_split.h"
@@ -21,6 +22,7 @@
 #include "base/stringprintf.h"
 #include "base/sys_info.h"
 #include "base/string_number_conversions.h"
+#include "http_compression.h"
 #include "http_response.h"
 #include "webdriver_logging.h"
 #include "webdriver_switches.h"
@@ -39,11 +41,181 @@
 
 namespace webdriver {
 
+namespace {
+
+// Default limit for size of HTTP request body.
+const size_t kDefaultMaxBodySize = 1024 * 1024 * 64;  // 64MB
+
+// Maximum length of chunk-size line (incl. extensions) in chunked body.
+const size_t kMaxChunkLineLength = 1024;
+
+// Reads exactly |length| bytes into |buffer|. mg_read() returns less than
+// requested only if peer closed connection or socket timeout expired.
+bool ReadExactly(struct mg_connection* connection, char* buffer, size_t length) {
+    size_t bytes_read = 0;
+    while (bytes_read < length) {
+        int n = mg_read(connection, buffer + bytes_read, length - bytes_read);
+        if (n <= 0)
+            return false;
+        bytes_read += n;
+    }
+    return true;
+}
+
+// Reads single CRLF terminated line of chunked body, without terminator.
+bool ReadChunkLine(struct mg_connection* connection, std::string* line) {
+    line->clear();
+    char c;
+    while (line->length() < kMaxChunkLineLength) {
+        if (mg_read(connection, &c, 1) != 1)
+            return false;
+        if (c == '\n') {
+            if (!line->empty() && (*line)[line->length() - 1] == '\r')
+                line->resize(line->length() - 1);
+            return true;
+        }
+        line->push_back(c);
+    }
+    return false;
+}
+
+// Size of pieces in which JSON response body is serialized and sent.
+const size_t kResponseChunkSize = 64 * 1024;
+
+// Default minimal size of response body to be compressed.
+const size_t kDefaultCompressionThreshold = 8 * 1024;
+
+// Checks if |etag| is listed in value of If-None-Match request header.
+bool IsETagMatched(const char* if_none_match, const std::string& etag) {
+    if (NULL == if_none_match)
+        return false;
+
+    std::vector<std::string> tags;
+    base::SplitString(if_none_match, ',', &tags);
+    for (size_t i = 0; i < tags.size(); ++i) {
+        std::string tag;
+        TrimWhitespaceASCII(tags[i], TRIM_ALL, &tag);
+        // weak comparison, as allowed for If-None-Match
+        if (StartsWithASCII(tag, "W/", true))
+            tag = tag.substr(2);
+        if (tag == "*" || tag == etag)
+            return true;
+    }
+    return false;
+}
+
+// Sends response body produced piece by piece. Body is buffered until it
+// reaches |buffer_limit|: smaller bodies go out with Content-Length, larger
+// ones with chunked transfer coding, compressed if |coding| is negotiated.
+class ResponseBodySink : public base::JSONWriter::Sink {
+public:
+    ResponseBodySink(struct mg_connection* connection,
+                     HttpResponse* http_response,
+                     ContentCoding coding,
+                     int compression_level,
+                     size_t buffer_limit)
+        : connection_(connection),
+          http_response_(http_response),
+          coding_(coding),
+          compression_level_(compression_level),
+          buffer_limit_(buffer_limit),
+          streaming_(false) {}
+    virtual ~ResponseBodySink() {}
+
+    virtual bool Write(const char* data, size_t length) {
+        if (streaming_)
+            return WriteBody(data, length, false);
+
+        buffer_.append(data, length);
+        if (buffer_.length() < buffer_limit_)
+            return true;
+
+        std::string pending;
+        pending.swap(buffer_);
+        return StartStreaming() &&
+               WriteBody(pending.data(), pending.length(), false);
+    }
+
+    // Sends whatever is buffered and terminates body.
+    bool Finish() {
+        if (streaming_)
+            return WriteBody(NULL, 0, true) && WriteRaw("0\r\n\r\n", 5);
+
+        http_response_->AddHeader("Content-Length",
+                                  base::Uint64ToString(buffer_.length()));
+        std::string headers;
+        http_response_->GetHeaderData(&headers);
+        return WriteRaw(headers.data(), headers.length()) &&
+               WriteRaw(buffer_.data(), buffer_.length());
+    }
+
+private:
+    bool StartStreaming() {
+        streaming_ = true;
+        if (kIdentityCoding != coding_) {
+            compressor_.reset(new StreamCompressor());
+            if (compressor_->Init(coding_, compression_level_)) {
+                http_response_->AddHeader("Content-Encoding",
+                                          ContentCodingToString(coding_));
+            } else {
+                GlobalLogger::Log(kWarningLogLevel, "can't init response compressor, send as is");
+                compressor_.reset(NULL);
+            }
+        }
+        http_response_->AddHeader("Transfer-Encoding", "chunked");
+        std::string headers;
+        http_response_->GetHeaderData(&headers);
+        return WriteRaw(headers.data(), headers.length());
+    }
+
+    bool WriteBody(const char* data, size_t length, bool finish) {
+        if (NULL == compressor_.get())
+            return WriteChunk(data, length);
+
+        compressed_.clear();
+        return compressor_->Compress(data, length, finish, &compressed_) &&
+               WriteChunk(compressed_.data(), compressed_.length());
+    }
+
+    bool WriteChunk(const char* data, size_t length) {
+        if (0 == length)
+            return true;
+        std::string chunk_header = base::StringPrintf(
+            "%lx\r\n", static_cast<unsigned long>(length));
+        return WriteRaw(chunk_header.data(), chunk_header.length()) &&
+               WriteRaw(data, length) &&
+               WriteRaw("\r\n", 2);
+    }
+
+    bool WriteRaw(const char* data, size_t length) {
+        if (0 == length)
+            return true;
+        return mg_write(connection_, data, length) == static_cast<int>(length);
+    }
+
+    struct mg_connection* connection_;
+    HttpResponse* http_response_;
+    ContentCoding coding_;
+    int compression_level_;
+    size_t buffer_limit_;
+    bool streaming_;
+    std::string buffer_;
+    std::string compressed_;
+    scoped_ptr<StreamCompressor> compressor_;
+
+    DISALLOW_COPY_AND_ASSIGN(ResponseBodySink);
+};
+
+}  // namespace
+
 Server::Server()
     : options_(NULL),
       routeTable_(NULL),
       mg_ctx_(NULL),
-      state_(STATE_UNCONFIGURED) {
+      state_(STATE_UNCONFIGURED),
+      max_body_size_(kDefaultMaxBodySize),
+      compression_level_(0),
+      compression_threshold_(kDefaultCompressionThreshold) {
 }
 
 Server::~Server() {}
@@ -106,6 +278,9 @@ int Server::Reset() {
         return 1; // cant reset not idle 
 
     mg_options_.clear();
+    max_body_size_ = kDefaultMaxBodySize;
+    compression_level_ = 0;
+    compression_threshold_ = kDefaultCompressionThreshold;
     routeTable_.reset(NULL);
     options_.reset(NULL);
     FileLog::SetGlobalLog(NULL);
@@ -124,6 +299,12 @@ int Server::SetRouteTable(RouteTable* routeTable) {
     return 1;
 }
 
+RouteTable* Server::GetMutableRouteTable() {
+    if (state_ == STATE_IDLE)
+        return routeTable_.get();
+    return NULL;
+}
+
 int Server::Start() {
     if (state_ != STATE_IDLE) {
         return 1;
@@ -166,8 +347,6 @@ int Server::Start() {
 }
 
 int Server::Stop(bool force) {
-    typedef scoped_ptr<ViewCmdExecutor> ExecutorPtr;        
-
     if (state_ != STATE_RUNNING)
         return 0; // nothing todo
 
@@ -201,7 +380,7 @@ int Server::Stop(bool force) {
 
         for (size_t i = 0; i < views.size(); ++i) {
             Error* error = NULL;
-            ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session, views.at(i)));
+            ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session, views.at(i)));
 
             if (NULL == executor.get()) {
                 GlobalLogger::Log(kWarningLogLevel, "Server::Stop(): cant terminate view(no executor), skip.");
@@ -231,10 +410,6 @@ int Server::Stop(bool force) {
     return 0;
 }
 
-// Maximum safe size of HTTP response message. Any larger than this,
-// the message may not be transferred at all.
-const size_t kMaxHttpMessageSize = 1024 * 1024 * 16;  // 16MB
-
 // mongoose callback
 void* Server::ProcessHttpRequestCb(int event_raised,
                          struct mg_connection* connection,
@@ -303,24 +478,74 @@ bool Server::ProcessHttpRequest(struct mg_connection* connection,
 
 void Server::SendNoContentResponse(struct mg_connection* connection,
                            const struct mg_request_info* request_info) {
-    WriteHttpResponse(connection, HttpResponse(HttpResponse::kNoContent));
+    HttpResponse http_response(HttpResponse::kNoContent);
+    WriteHttpResponse(connection, &http_response);
 }
 
 void Server::SendResponse(struct mg_connection* const connection,
                   const std::string& request_method,
                   const Response& response) {
     HttpResponse http_response;
-    PrepareHttpResponse(request_method, response, &http_response);
-    WriteHttpResponse(connection, http_response);
+    if (PrepareHttpResponse(request_method, response, &http_response)) {
+        WriteStreamedHttpResponse(connection, &http_response, response);
+    } else {
+        WriteHttpResponse(connection, &http_response);
+    }
 }
 
 void Server::WriteHttpResponse(struct mg_connection* connection,
-                       const HttpResponse& response) {
-    HttpResponse modified_response(response);
-    modified_response.AddHeader("connection", "close");
+                       HttpResponse* response) {
+    response->AddHeader("connection", "close");
     std::string data;
-    modified_response.GetData(&data);
+    response->GetHeaderData(&data);
     mg_write(connection, data.data(), data.length());
+    if (!response->body().empty())
+        mg_write(connection, response->body().data(), response->body().length());
+}
+
+void Server::WriteStreamedHttpResponse(struct mg_connection* connection,
+                       HttpResponse* http_response,
+                       const Response& response) {
+    http_response->AddHeader("connection", "close");
+
+    if (response.HasRawBody() && kSuccess == response.GetStatus()) {
+        const std::string& etag = response.GetRawBodyETag();
+        if (!etag.empty()) {
+            http_response->AddHeader("ETag", etag);
+            if (IsETagMatched(mg_get_header(connection, "If-None-Match"), etag)) {
+                http_response->set_status(HttpResponse::kNotModified);
+                std::string headers;
+                http_response->GetHeaderData(&headers);
+                mg_write(connection, headers.data(), headers.length());
+                return;
+            }
+        }
+
+        // Binary bodies are sent as is: static ones with Content-Length,
+        // streams chunked from the first byte so frames are not held back.
+        size_t buffer_limit = response.IsRawBodyStreamed() ? 0 : std::numeric_limits<size_t>::max();
+        ResponseBodySink sink(connection, http_response, kIdentityCoding,
+                              0, buffer_limit);
+        if (!response.WriteRawBody(&sink) || !sink.Finish()) {
+            GlobalLogger::Log(kWarningLogLevel, "WriteStreamedHttpResponse - connection dropped while sending raw response");
+        }
+        return;
+    }
+
+    ContentCoding coding = kIdentityCoding;
+    size_t buffer_limit = kResponseChunkSize;
+    if (compression_level_ > 0) {
+        http_response->AddHeader("Vary", "Accept-Encoding");
+        coding = NegotiateContentCoding(mg_get_header(connection, "Accept-Encoding"));
+        if (kIdentityCoding != coding)
+            buffer_limit = compression_threshold_;
+    }
+
+    ResponseBodySink sink(connection, http_response, coding,
+                          compression_level_, buffer_limit);
+    if (!response.WriteJSON(kResponseChunkSize, &sink) || !sink.Finish()) {
+        GlobalLogger::Log(kWarningLogLevel, "WriteStreamedHttpResponse - connection dropped while sending response");
+    }
 }
 
 const CommandLine& Server::GetCommandLine() const
@@ -328,7 +553,7 @@ const CommandLine& Server::GetCommandLine() const
     return *(options_.get());
 }
 
-void Server::PrepareHttpResponse(const std::string& request_method,
+bool Server::PrepareHttpResponse(const std::string& request_method,
                                  const Response& command_response,
                                  HttpResponse* const http_response) {
     ErrorCode status = command_response.GetStatus();
@@ -345,7 +570,7 @@ void Server::PrepareHttpResponse(const std::string& request_method,
           http_response->set_body("Unable to set 'Location' header: response "
                                   "value is not a string: " +
                                   command_response.ToJSON());
-          return;
+          return false;
       }
       http_response->AddHeader("Location", location);
     }
@@ -358,7 +583,7 @@ void Server::PrepareHttpResponse(const std::string& request_method,
           http_response->set_body(
                       "Unable to set 'Allow' header: response value was "
                       "not a list of strings: " + command_response.ToJSON());
-          return;
+          return false;
       }
 
       const ListValue* const list_value =
@@ -374,7 +599,7 @@ void Server::PrepareHttpResponse(const std::string& request_method,
               http_response->set_body(
                           "Unable to set 'Allow' header: response value was "
                           "not a list of strings: " + command_response.ToJSON());
-              return;
+              return false;
           }
       }
       http_response->AddHeader("Allow", JoinString(allowed_methods, ','));
@@ -410,15 +635,19 @@ void Server::PrepareHttpResponse(const std::string& request_method,
         break;
     }
 
-    http_response->SetMimeType("application/json; charset=utf-8");
+    if (command_response.HasRawBody() && kSuccess == status)
+        http_response->SetMimeType(command_response.GetRawMimeType());
+    else
+        http_response->SetMimeType("application/json; charset=utf-8");
 
     // Sets access control headers to allow cross-origin resource sharing from any origin.
     http_response->AddHeader("Access-Control-Allow-Origin", "*");
     http_response->AddHeader("Access-Control-Allow-Methods", "DELETE,GET,HEAD,POST");
     http_response->AddHeader("Access-Control-Allow-Headers", "Accept,Content-Type");
 
-    http_response->set_body(command_response.ToJSON());
-}	
+    // body is serialized by caller straight to connection
+    return true;
+}
 
 bool Server::ParseRequestInfo(const struct mg_request_info* const request_info,
                       struct mg_connection* const connection,
@@ -448,11 +677,20 @@ bool Server::ParseRequestInfo(const struct mg_request_info* const request_info,
 
     if (*method == "POST") {
         std::string json;
-        ReadRequestBody(request_info, connection, &json);
+        std::string read_error;
+        if (!ReadRequestBody(connection, &json, &read_error) ||
+            !DecodeRequestBody(connection, &json, &read_error)) {
+            response->SetError(new Error(
+                                   kBadRequest,
+                                   "Failed to read command data: " + read_error));
+            return false;
+        }
         if (json.length() > 0) {
             std::string error_msg;
+            // detachable, so commands can move parts of parameters out
             scoped_ptr<Value> params(base::JSONReader::ReadAndReturnError(
-                                         json, base::JSON_ALLOW_TRAILING_COMMAS, NULL, &error_msg));
+                                         json, base::JSON_ALLOW_TRAILING_COMMAS | base::JSON_DETACHABLE_CHILDREN,
+                                         NULL, &error_msg));
             if (!params.get()) {
                 response->SetError(new Error(
                                        kBadRequest,
@@ -472,30 +710,116 @@ bool Server::ParseRequestInfo(const struct mg_request_info* const request_info,
     return true;
 }
 
-void Server::ReadRequestBody(const struct mg_request_info* const request_info,
-                     struct mg_connection* const connection,
-                     std::string* request_body) {
-    int content_length = 0;
-    // 64 maximum header count hard-coded in mongoose.h
-    for (int header_index = 0; header_index < 64; ++header_index) {
-        if (request_info->http_headers[header_index].name == NULL) {
-            break;
+bool Server::ReadRequestBody(struct mg_connection* const connection,
+                     std::string* request_body,
+                     std::string* error_msg) {
+    const char* transfer_encoding = mg_get_header(connection, "Transfer-Encoding");
+    const char* content_length_str = mg_get_header(connection, "Content-Length");
+
+    if (NULL == content_length_str &&
+        NULL != transfer_encoding &&
+        LowerCaseEqualsASCII(transfer_encoding, "chunked")) {
+        return ReadChunkedRequestBody(connection, request_body, error_msg);
+    }
+
+    if (NULL == content_length_str)
+        return true;
+
+    int64 content_length = 0;
+    if (!base::StringToInt64(content_length_str, &content_length) ||
+        content_length < 0) {
+        *error_msg = "invalid Content-Length: " + std::string(content_length_str);
+        return false;
+    }
+    if (static_cast<uint64>(content_length) > max_body_size_) {
+        *error_msg = base::StringPrintf("request body is too large (%" PRId64
+                                        " bytes, limit %" PRIuS ")",
+                                        content_length, max_body_size_);
+        return false;
+    }
+    if (0 == content_length)
+        return true;
+
+    // Body is read straight into the buffer handed over to JSON parser.
+    request_body->resize(static_cast<size_t>(content_length));
+    if (!ReadExactly(connection, &(*request_body)[0], request_body->length())) {
+        request_body->clear();
+        *error_msg = "connection closed or timed out while reading request body";
+        return false;
+    }
+    return true;
+}
+
+bool Server::ReadChunkedRequestBody(struct mg_connection* const connection,
+                     std::string* request_body,
+                     std::string* error_msg) {
+    std::string line;
+
+    while (true) {
+        if (!ReadChunkLine(connection, &line)) {
+            *error_msg = "broken chunked request body";
+            return false;
         }
-        if (strcmp(request_info->http_headers[header_index].name,
-                   "Content-Length") == 0) {
-            content_length = atoi(request_info->http_headers[header_index].value);
+        // chunk extensions are ignored
+        size_t ext = line.find(';');
+        if (ext != std::string::npos)
+            line.resize(ext);
+        TrimWhitespaceASCII(line, TRIM_ALL, &line);
+
+        int chunk_size = 0;
+        if (line.empty() || !base::HexStringToInt(line, &chunk_size) || chunk_size < 0) {
+            *error_msg = "invalid chunk size: " + line;
+            return false;
+        }
+        if (0 == chunk_size)
             break;
+
+        if (request_body->length() + chunk_size > max_body_size_) {
+            *error_msg = base::StringPrintf("request body is too large (limit %" PRIuS ")",
+                                            max_body_size_);
+            return false;
+        }
+
+        size_t offset = request_body->length();
+        request_body->resize(offset + chunk_size);
+        if (!ReadExactly(connection, &(*request_body)[offset], chunk_size) ||
+            !ReadChunkLine(connection, &line) || !line.empty()) {
+            *error_msg = "broken chunked request body";
+            return false;
         }
     }
-    if (content_length > 0) {
-        request_body->resize(content_length);
-        int bytes_read = 0;
-        while (bytes_read < content_length) {
-            bytes_read += mg_read(connection,
-                                  &(*request_body)[bytes_read],
-                                  content_length - bytes_read);
+
+    // skip trailer headers up to terminating empty line
+    do {
+        if (!ReadChunkLine(connection, &line)) {
+            *error_msg = "broken chunked request body";
+            return false;
         }
+    } while (!line.empty());
+
+    // connection may be kept alive only if body was read to its end
+    mg_end_chunked_body(connection);
+    return true;
+}
+
+bool Server::DecodeRequestBody(struct mg_connection* const connection,
+                     std::string* request_body,
+                     std::string* error_msg) {
+    const char* content_encoding = mg_get_header(connection, "Content-Encoding");
+    ContentCoding coding = ContentCodingFromString(content_encoding);
+    if (kIdentityCoding == coding || request_body->empty())
+        return true;
+
+    if (!IsContentCodingSupported(coding)) {
+        *error_msg = "unsupported Content-Encoding: " + std::string(content_encoding);
+        return false;
     }
+
+    std::string decoded;
+    if (!DecompressContent(coding, *request_body, max_body_size_, &decoded, error_msg))
+        return false;
+    request_body->swap(decoded);
+    return true;
 }
 
 const RouteTable& Server::GetRouteTable() const
@@ -610,6 +934,52 @@ int Server::InitMongooseOptions() {
             GlobalLogger::Log(kSevereLogLevel, "Root '" + root + "' does not exist!");
         }
     }
+    if (options_->HasSwitch(webdriver::Switches::kMaxBodySize)) {
+        if (!base::StringToSizeT(options_->GetSwitchValueASCII(webdriver::Switches::kMaxBodySize),
+                           &max_body_size_)) {
+            GlobalLogger::Log(kSevereLogLevel, "'max-body-size' option must be an integer");
+            return 1;
+        }
+    }
+    if (options_->HasSwitch(webdriver::Switches::kRequestTimeout)) {
+        int request_timeout;
+        if (!base::StringToInt(options_->GetSwitchValueASCII(webdriver::Switches::kRequestTimeout),
+                           &request_timeout)) {
+            GlobalLogger::Log(kSevereLogLevel, "'request-timeout' option must be an integer");
+            return 1;
+        }
+        mg_options_.push_back("request_timeout_ms");
+        mg_options_.push_back(base::IntToString(request_timeout));
+    }
+
+    if (options_->HasSwitch(webdriver::Switches::kCompressionLevel)) {
+        if (!base::StringToInt(options_->GetSwitchValueASCII(webdriver::Switches::kCompressionLevel),
+                           &compression_level_) ||
+            compression_level_ < 0 || compression_level_ > 9) {
+            GlobalLogger::Log(kSevereLogLevel, "'compression-level' option must be an integer in range 0..9");
+            return 1;
+        }
+        if (compression_level_ > 0 && !IsContentCodingSupported(kGzipCoding)) {
+            GlobalLogger::Log(kWarningLogLevel, "server is built without compression support, 'compression-level' ignored");
+            compression_level_ = 0;
+        }
+    }
+    if (options_->HasSwitch(webdriver::Switches::kCompressionThreshold)) {
+        if (!base::StringToSizeT(options_->GetSwitchValueASCII(webdriver::Switches::kCompressionThreshold),
+                           &compression_threshold_)) {
+            GlobalLogger::Log(kSevereLogLevel, "'compression-threshold' option must be an integer");
+            return 1;
+        }
+    }
+    if (options_->HasSwitch(webdriver::Switches::kHttpCacheSize)) {
+        int64 http_cache_size;
+        if (!base::StringToInt64(options_->GetSwitchValueASCII(webdriver::Switches::kHttpCacheSize),
+                                 &http_cache_size) || http_cache_size <= 0) {
+            GlobalLogger::Log(kSevereLogLevel, "'http-cache-size' option must be a positive integer");
+            return 1;
+        }
+    }
+
     mg_options_.push_back("extra_mime_types");
     mg_options_.push_back(".xhtml=application/xhtml+xml,.qml=text/x-qml");
 
@@ -691,6 +1061,16 @@ int Server::ParseConfigToOptions() {
             std::string url_base;
             int http_threads;
             std::string log_path;
+            int max_body_size;
+            int request_timeout;
+            int compression_level;
+            int compression_threshold;
+            std::string http_cache_dir;
+            int http_cache_size;
+            bool http_cache_offline;
+            std::string views;
+            std::string vnc_login;
+            bool uinput;
             if (result_dict->GetInteger(webdriver::Switches::kPort, &port))
                 options_->AppendSwitchASCII(webdriver::Switches::kPort, base::IntToString(port));
             if (result_dict->GetString(webdriver::Switches::kRoot, &root))
@@ -701,6 +1081,26 @@ int Server::ParseConfigToOptions() {
                 options_->AppendSwitchASCII(webdriver::Switches::kHttpThread, base::IntToString(http_threads));
             if (result_dict->GetString(webdriver::Switches::kLogPath, &log_path))
                 options_->AppendSwitchASCII(webdriver::Switches::kLogPath, log_path);
+            if (result_dict->GetInteger(webdriver::Switches::kMaxBodySize, &max_body_size))
+                options_->AppendSwitchASCII(webdriver::Switches::kMaxBodySize, base::IntToString(max_body_size));
+            if (result_dict->GetInteger(webdriver::Switches::kRequestTimeout, &request_timeout))
+                options_->AppendSwitchASCII(webdriver::Switches::kRequestTimeout, base::IntToString(request_timeout));
+            if (result_dict->GetInteger(webdriver::Switches::kCompressionLevel, &compression_level))
+                options_->AppendSwitchASCII(webdriver::Switches::kCompressionLevel, base::IntToString(compression_level));
+            if (result_dict->GetInteger(webdriver::Switches::kCompressionThreshold, &compression_threshold))
+                options_->AppendSwitchASCII(webdriver::Switches::kCompressionThreshold, base::IntToString(compression_threshold));
+            if (result_dict->GetString(webdriver::Switches::kHttpCacheDir, &http_cache_dir))
+                options_->AppendSwitchASCII(webdriver::Switches::kHttpCacheDir, http_cache_dir);
+            if (result_dict->GetInteger(webdriver::Switches::kHttpCacheSize, &http_cache_size))
+                options_->AppendSwitchASCII(webdriver::Switches::kHttpCacheSize, base::IntToString(http_cache_size));
+            if (result_dict->GetBoolean(webdriver::Switches::kHttpCacheOffline, &http_cache_offline) && http_cache_offline)
+                options_->AppendSwitch(webdriver::Switches::kHttpCacheOffline);
+            if (result_dict->GetString(webdriver::Switches::kViews, &views))
+                options_->AppendSwitchASCII(webdriver::Switches::kViews, views);
+            if (result_dict->GetString(webdriver::Switches::kVNCLogin, &vnc_login))
+                options_->AppendSwitchASCII(webdriver::Switches::kVNCLogin, vnc_login);
+            if (result_dict->GetBoolean(webdriver::Switches::kUserInputDevice, &uinput) && uinput)
+                options_->AppendSwitch(webdriver::Switches::kUserInputDevice);
 
             return 0;
         }
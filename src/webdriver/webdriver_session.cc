@@ -16,6 +16,7 @@
 #include "base/json/json_writer.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop_proxy.h"
+#include "base/stl_util.h"
 #include "base/string_number_conversions.h"
 #include "base/string_split.h"
 #include "base/string_util.h"
@@ -26,7 +27,10 @@
 #include "base/utf_string_conversions.h"
 #include "base/values.h"
 #include "webdriver_error.h"
+#include "webdriver_input_actions.h"
 #include "webdriver_session_manager.h"
+#include "webdriver_source_diff.h"
+#include "webdriver_startup.h"
 #include "webdriver_view_runner.h"
 #include "webdriver_util.h"
 #include "webdriver_view_executor.h"
@@ -53,7 +57,8 @@ Session::Session()
       desired_caps_(NULL),
       required_caps_(NULL),
       view_runner_(ViewRunner::CreateRunner()),
-      sticky_modifiers_(0)
+      sticky_modifiers_(0),
+      input_state_(new InputState())
 {
     SessionManager::GetInstance()->Add(this);
     logger_.AddHandler(session_log_.get());
@@ -66,6 +71,7 @@ Session::Session()
 
 Session::~Session() {
     SessionManager::GetInstance()->Remove(id_);
+    STLDeleteValues(&source_snapshots_);
 }
 
 bool Session::InitActualCapabilities() {
@@ -261,6 +267,11 @@ Error* Session::Init(const base::DictionaryValue* desired_capabilities_dict,
         return new Error(kUnknownError, "Cannot start session thread");
     }
 
+    // View types support may be deferred until first session is created.
+    if (DeferredViewSupport::GetInstance()->HasPending())
+        RunSessionTask(base::Bind(&DeferredViewSupport::RunPending,
+                                  base::Unretained(DeferredViewSupport::GetInstance())));
+
     if (!temp_dir_.CreateUniqueTempDir()) {
         delete this;
         return new Error(
@@ -295,6 +306,12 @@ Error* Session::Init(const base::DictionaryValue* desired_capabilities_dict,
         delete this;
         return error;
     }
+    capabilities_.caps->SetBoolean(Capabilities::kBulkTextInput, capabilities_.bulk_text_input);
+    capabilities_.caps->SetString(Capabilities::kPageLoadStrategy,
+                                  PageLoadStrategyToString(capabilities_.page_load_strategy));
+    capabilities_.caps->SetString(Capabilities::kScreenshotSource,
+                                  ScreenshotSourceToString(capabilities_.screenshot_source));
+    capabilities_.caps->SetBoolean(Capabilities::kReuseScreenshots, capabilities_.reuse_screenshots);
     logger_.set_min_log_level(capabilities_.log_levels[LogType::kDriver]);
     if (capabilities_.log_levels[LogType::kPerformance] != kOffLogLevel) {
         session_perf_log_->set_min_log_level(capabilities_.log_levels[LogType::kPerformance]);
@@ -341,6 +358,8 @@ Error* Session::AfterExecuteCommand() {
 void Session::Terminate() {
     logger_.Log(kInfoLogLevel, "Session("+id_+") terminate.");
 
+    // streams using session from own threads finish their current task
+    SessionManager::GetInstance()->BeginTerminate(id_);
     life_cycle_actions_->BeforeTerminate();
 
     delete this;
@@ -411,9 +430,7 @@ const Capabilities& Session::capabilities() const {
 }
 
 base::ListValue* Session::GetLog() const {
-    base::ListValue* ret_val = session_log_->entries_list()->DeepCopy();
-    session_log_->clear_entries_list();
-    return ret_val;
+    return session_log_->TakeEntries();
 }
 
 void Session::AddPerfLogEntry(LogLevel level, const std::string& message) {
@@ -429,9 +446,7 @@ LogLevel Session::GetMinPerfLogLevel() const {
 }
 
 base::ListValue* Session::GetPerfLog() const {
-    base::ListValue* ret_val = session_perf_log_->entries_list()->DeepCopy();
-    session_perf_log_->clear_entries_list();
-    return ret_val;
+    return session_perf_log_->TakeEntries();
 }
 
 void Session::RunSessionTask(const base::Closure& task) {
@@ -459,6 +474,7 @@ bool Session::AddNewView(ViewHandle* handle, ViewId* viewId) {
 
     // TODO: check if view id already exist and return false
 
+    base::AutoLock auto_lock(executors_lock_);
     views_[newView.id()] = ViewHandlePtr(handle);
 
     *viewId = newView;
@@ -468,12 +484,15 @@ bool Session::AddNewView(ViewHandle* handle, ViewId* viewId) {
 
 bool Session::ReplaceViewHandle(const ViewId& viewId, ViewHandle* handle) {
     ViewsMap::iterator it;
+    base::AutoLock auto_lock(executors_lock_);
 
     it = views_.find(viewId.id());
     if (it == views_.end())
         return false;
 
     it->second = ViewHandlePtr(handle);
+    // executor was created for previous handle
+    executors_.erase(viewId.id());
 
     return true;
 }
@@ -492,9 +511,45 @@ ViewId Session::GetViewForHandle(ViewHandle* handle) const {
     return view_to_return;
 };
 
+scoped_refptr<ViewCmdExecutor> Session::GetViewExecutor(const ViewId& viewId) {
+    base::AutoLock auto_lock(executors_lock_);
+    ExecutorsMap::iterator it = executors_.find(viewId.id());
+    if (it == executors_.end())
+        return NULL;
+
+    ViewHandle* handle = GetViewHandle(viewId);
+    if (NULL == handle || !handle->is_valid()) {
+        // view is gone, executor references destroyed object
+        executors_.erase(it);
+        return NULL;
+    }
+    return it->second;
+}
+
+scoped_refptr<ViewCmdExecutor> Session::SetViewExecutor(const ViewId& viewId, ViewCmdExecutor* executor) {
+    base::AutoLock auto_lock(executors_lock_);
+    if (views_.find(viewId.id()) == views_.end())
+        return NULL;
+
+    // other thread could create executor for same view meanwhile
+    std::pair<ExecutorsMap::iterator, bool> inserted =
+            executors_.insert(std::make_pair(viewId.id(), scoped_refptr<ViewCmdExecutor>(executor)));
+    return inserted.first->second;
+}
+
 void Session::RemoveView(const ViewId& viewId) {
     elements_.erase(viewId.id());
-    views_.erase(viewId.id());
+    {
+        base::AutoLock auto_lock(executors_lock_);
+        executors_.erase(viewId.id());
+        views_.erase(viewId.id());
+    }
+
+    std::map<std::string, SourceSnapshot*>::iterator snapshot = source_snapshots_.find(viewId.id());
+    if (snapshot != source_snapshots_.end()) {
+        delete snapshot->second;
+        source_snapshots_.erase(snapshot);
+    }
 }
 
 void Session::UpdateViews(const std::set<ViewId>& views) {
@@ -543,6 +598,28 @@ ElementId Session::GetElementIdForHandle(const ViewId& viewId, const ElementHand
     return ElementId();
 }
 
+void Session::GetElements(const ViewId& viewId, std::vector<std::pair<ElementId, ElementHandle*> >* elements) const {
+    ViewsElementsMap::const_iterator viewIt = elements_.find(viewId.id());
+    if (viewIt == elements_.end())
+        return;
+
+    const ElementsMap& viewElements = viewIt->second;
+    elements->reserve(elements->size() + viewElements.size());
+    for (ElementsMap::const_iterator elementIt = viewElements.begin(); elementIt != viewElements.end(); ++elementIt) {
+        elements->push_back(std::make_pair(ElementId(elementIt->first), elementIt->second.get()));
+    }
+}
+
+void Session::UpdateSourceSnapshot(const ViewId& viewId,
+                                   const std::string* source,
+                                   int base_revision,
+                                   base::DictionaryValue* result) {
+    SourceSnapshot*& snapshot = source_snapshots_[viewId.id()];
+    if (NULL == snapshot)
+        snapshot = new SourceSnapshot();
+    snapshot->Update(*source, base_revision, result);
+}
+
 bool Session::AddElement(const ViewId& viewId, ElementHandle* handle, ElementId* elementId) {
     ElementId targetElement(GenerateRandomID());
     ElementsMap& elements = elements_[viewId.id()];
@@ -24,10 +24,22 @@ bool SessionManager::Remove(const std::string& id) {
     it = map_.find(id);
     if (it == map_.end())
         return false;
-    map_.erase(it);
+    // session is deleted once removed, even if it was not terminated
+    terminating_.insert(id);
+    WaitForSessionUses(id);
+    terminating_.erase(id);
+    map_.erase(id);
     return true;
 }
 
+void SessionManager::BeginTerminate(const std::string& id) {
+    base::AutoLock lock(map_lock_);
+    if (map_.find(id) == map_.end())
+        return;
+    terminating_.insert(id);
+    WaitForSessionUses(id);
+}
+
 Session* SessionManager::GetSession(const std::string& id) const {
     std::map<std::string, Session*>::const_iterator it;
     base::AutoLock lock(map_lock_);
@@ -43,7 +55,34 @@ std::map<std::string, Session*> SessionManager::GetSessions()
     return map_;
 }
 
-SessionManager::SessionManager() {}
+bool SessionManager::RunWithSession(const std::string& id,
+                                    const base::Callback<void(Session*)>& task) {
+    Session* session = NULL;
+    {
+        base::AutoLock lock(map_lock_);
+        std::map<std::string, Session*>::const_iterator it = map_.find(id);
+        if (it == map_.end() || terminating_.count(id))
+            return false;
+        session = it->second;
+        ++uses_[id];
+    }
+
+    task.Run(session);
+
+    base::AutoLock lock(map_lock_);
+    if (0 == --uses_[id]) {
+        uses_.erase(id);
+        uses_released_.Broadcast();
+    }
+    return true;
+}
+
+void SessionManager::WaitForSessionUses(const std::string& id) {
+    while (uses_.find(id) != uses_.end())
+        uses_released_.Wait();
+}
+
+SessionManager::SessionManager() : uses_released_(&map_lock_) {}
 
 SessionManager::~SessionManager() {}
 
@@ -0,0 +1,215 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#include "webdriver_source_diff.h"
+
+#include <string.h>
+
+#include "base/string_number_conversions.h"
+#include "base/values.h"
+#include "third_party/pugixml/pugixml.hpp"
+
+namespace webdriver {
+
+namespace {
+
+const char kElementIdAttribute[] = "elementId";
+
+const uint64 kFnvOffsetBasis = 14695981039346656037ULL;
+const uint64 kFnvPrime = 1099511628211ULL;
+
+uint64 HashBytes(uint64 hash, const char* data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<uint8>(data[i]);
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+// Terminating zero is hashed too, so "ab"+"c" and "a"+"bc" differ.
+uint64 HashString(uint64 hash, const char* str) {
+    return HashBytes(hash, str, strlen(str) + 1);
+}
+
+uint64 HashValue(uint64 hash, uint64 value) {
+    return HashBytes(hash, reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Returns children of |parent| that are present under same parent in |other|.
+template <class NodeMapType>
+std::vector<std::string> KeptChildren(const std::string& parent,
+                                      const std::vector<std::string>& children,
+                                      const NodeMapType& other) {
+    std::vector<std::string> kept;
+    for (size_t i = 0; i < children.size(); ++i) {
+        typename NodeMapType::const_iterator it = other.find(children[i]);
+        if (it != other.end() && it->second.parent == parent)
+            kept.push_back(children[i]);
+    }
+    return kept;
+}
+
+class StringXmlWriter : public pugi::xml_writer {
+public:
+    explicit StringXmlWriter(std::string* out) : out_(out) {}
+    virtual ~StringXmlWriter() {}
+
+    virtual void write(const void* data, size_t size) {
+        out_->append(static_cast<const char*>(data), size);
+    }
+
+private:
+    std::string* out_;
+};
+
+}  // namespace
+
+SourceSnapshot::SourceSnapshot()
+    : revision_(0),
+      valid_(false) {}
+
+SourceSnapshot::~SourceSnapshot() {}
+
+void SourceSnapshot::Update(const std::string& source,
+                            int base_revision,
+                            base::DictionaryValue* result) {
+    pugi::xml_document doc;
+    pugi::xml_parse_result parsed = doc.load_buffer(source.data(), source.size());
+    pugi::xml_node root = doc.document_element();
+
+    NodeMap nodes;
+    XmlNodeMap xml_nodes;
+    std::string root_key;
+    bool is_xml = parsed && root;
+    if (is_xml)
+        root_key = IndexNode(root, std::string(), 0, &nodes, &xml_nodes);
+
+    bool incremental = is_xml && valid_ &&
+                       (base_revision == revision_) && (root_key == root_);
+
+    ++revision_;
+    result->SetInteger("revision", revision_);
+    result->SetBoolean("full", !incremental);
+
+    if (incremental) {
+        base::ListValue* changed = new base::ListValue();
+        DiffNode(root_key, nodes, xml_nodes, changed);
+
+        // report only topmost removed nodes, their subtrees are gone with them
+        base::ListValue* removed = new base::ListValue();
+        for (NodeMap::const_iterator it = nodes_.begin(); it != nodes_.end(); ++it) {
+            if (nodes.count(it->first))
+                continue;
+            if (it->second.parent.empty() || nodes.count(it->second.parent))
+                removed->Append(base::Value::CreateStringValue(it->first));
+        }
+
+        result->Set("changed", changed);
+        result->Set("removed", removed);
+    } else {
+        result->SetString("source", source);
+    }
+
+    valid_ = is_xml;
+    root_ = root_key;
+    nodes_.swap(nodes);
+}
+
+// static
+std::string SourceSnapshot::IndexNode(const pugi::xml_node& node,
+                                      const std::string& parent,
+                                      int index,
+                                      NodeMap* nodes,
+                                      XmlNodeMap* xml_nodes) {
+    std::string key;
+    pugi::xml_attribute id = node.attribute(kElementIdAttribute);
+    if (id && *id.value() && !nodes->count(id.value()))
+        key = id.value();
+    else
+        key = parent + "/" + base::IntToString(index);
+
+    NodeInfo& info = (*nodes)[key];
+    info.parent = parent;
+    info.index = index;
+    (*xml_nodes)[key] = node;
+
+    uint64 own_hash = HashString(kFnvOffsetBasis, node.name());
+    for (pugi::xml_attribute attr = node.first_attribute(); attr; attr = attr.next_attribute()) {
+        own_hash = HashString(own_hash, attr.name());
+        own_hash = HashString(own_hash, attr.value());
+    }
+
+    std::vector<uint64> child_hashes;
+    int child_index = 0;
+    for (pugi::xml_node child = node.first_child(); child; child = child.next_sibling()) {
+        if (pugi::node_pcdata == child.type() || pugi::node_cdata == child.type()) {
+            own_hash = HashString(own_hash, child.value());
+        } else if (pugi::node_element == child.type()) {
+            // references to map elements stay valid while map grows
+            std::string child_key = IndexNode(child, key, child_index++, nodes, xml_nodes);
+            info.children.push_back(child_key);
+            child_hashes.push_back((*nodes)[child_key].hash);
+        }
+    }
+
+    uint64 hash = own_hash;
+    for (size_t i = 0; i < child_hashes.size(); ++i)
+        hash = HashValue(hash, child_hashes[i]);
+
+    info.own_hash = own_hash;
+    info.hash = hash;
+    return key;
+}
+
+void SourceSnapshot::DiffNode(const std::string& key,
+                              const NodeMap& nodes,
+                              const XmlNodeMap& xml_nodes,
+                              base::ListValue* changed) const {
+    const NodeInfo& info = nodes.find(key)->second;
+    NodeMap::const_iterator old = nodes_.find(key);
+
+    // node moved to other parent is reported as changed, with its new place
+    if (old != nodes_.end() && old->second.parent == info.parent) {
+        if (old->second.hash == info.hash)
+            return;
+
+        // Same node and kept children are in same order: change is below.
+        // New children are reported as changed, removed ones by Update().
+        if (old->second.own_hash == info.own_hash &&
+            KeptChildren(key, old->second.children, nodes) ==
+            KeptChildren(key, info.children, nodes_)) {
+            for (size_t i = 0; i < info.children.size(); ++i)
+                DiffNode(info.children[i], nodes, xml_nodes, changed);
+            return;
+        }
+    }
+
+    std::string subtree;
+    StringXmlWriter writer(&subtree);
+    xml_nodes.find(key)->second.print(writer, "", pugi::format_raw);
+
+    base::DictionaryValue* entry = new base::DictionaryValue();
+    entry->SetString("id", key);
+    entry->SetString("parent", info.parent);
+    entry->SetInteger("index", info.index);
+    entry->SetString("source", subtree);
+    changed->Append(entry);
+}
+
+}  // namespace webdriver
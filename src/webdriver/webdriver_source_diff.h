@@ -0,0 +1,102 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef WEBDRIVER_SOURCE_DIFF_H_
+#define WEBDRIVER_SOURCE_DIFF_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+
+namespace base {
+class DictionaryValue;
+class ListValue;
+}
+
+namespace pugi {
+class xml_node;
+}
+
+namespace webdriver {
+
+// Keeps structure of last page source of one view and reports changes of
+// next source against it. Nodes are identified by "elementId" attribute
+// assigned by native serializers, or by position in parent otherwise.
+// Every node carries structural hash of its subtree, so unchanged subtrees
+// are skipped without comparing their content.
+class SourceSnapshot {
+public:
+    SourceSnapshot();
+    ~SourceSnapshot();
+
+    // Replaces snapshot with |source| and fills |result| with:
+    //  "revision" - revision of new snapshot;
+    //  "full" - true if whole source is returned in "source", it happens
+    //     when |base_revision| is not current revision or source is not XML;
+    //  "removed" - list of ids of removed nodes;
+    //  "changed" - list of new or replaced subtrees in document order, each
+    //     with "id" of node, "parent" id, "index" among element children of
+    //     parent and "source". Node with same id, if any, is to be removed
+    //     before subtree is put to its place.
+    void Update(const std::string& source, int base_revision, base::DictionaryValue* result);
+
+    int revision() const { return revision_; }
+
+private:
+    struct NodeInfo {
+        NodeInfo() : hash(0), own_hash(0), index(0) {}
+
+        // hash of node name, attributes, text and hashes of children
+        uint64 hash;
+        // hash of node name, attributes and text only
+        uint64 own_hash;
+        std::string parent;
+        // position among element children of parent
+        int index;
+        std::vector<std::string> children;
+    };
+    typedef std::map<std::string, NodeInfo> NodeMap;
+    typedef std::map<std::string, pugi::xml_node> XmlNodeMap;
+
+    // Adds |node| and its element children to |nodes|, returns key of node.
+    static std::string IndexNode(const pugi::xml_node& node,
+                                 const std::string& parent,
+                                 int index,
+                                 NodeMap* nodes,
+                                 XmlNodeMap* xml_nodes);
+
+    // Appends subtrees under |key| that differ from snapshot to |changed|.
+    void DiffNode(const std::string& key,
+                  const NodeMap& nodes,
+                  const XmlNodeMap& xml_nodes,
+                  base::ListValue* changed) const;
+
+    int revision_;
+    bool valid_;
+    std::string root_;
+    NodeMap nodes_;
+
+    DISALLOW_COPY_AND_ASSIGN(SourceSnapshot);
+};
+
+}  // namespace webdriver
+
+#endif  // WEBDRIVER_SOURCE_DIFF_H_
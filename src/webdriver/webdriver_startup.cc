@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Copyright © 1992-2014 Cisco and/or its affiliates. All rights reserved.
+** All rights reserved.
+** 
+** $CISCO_BEGIN_LICENSE:LGPL$
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** $CISCO_END_LICENSE$
+**
+****************************************************************************/
+
+#include "webdriver_startup.h"
+
+#include "base/stringprintf.h"
+#include "webdriver_logging.h"
+
+namespace webdriver {
+
+StartupTimings::StartupTimings()
+    : last_mark_(base::TimeTicks::Now()) {}
+
+StartupTimings::~StartupTimings() {}
+
+// static
+StartupTimings* StartupTimings::GetInstance() {
+    return Singleton<StartupTimings>::get();
+}
+
+void StartupTimings::Begin() {
+    base::AutoLock lock(lock_);
+    last_mark_ = base::TimeTicks::Now();
+}
+
+void StartupTimings::Mark(const std::string& phase) {
+    base::AutoLock lock(lock_);
+    base::TimeTicks now = base::TimeTicks::Now();
+    phases_.push_back(Phase(phase, now - last_mark_));
+    last_mark_ = now;
+}
+
+void StartupTimings::Add(const std::string& phase, const base::TimeDelta& duration) {
+    base::AutoLock lock(lock_);
+    phases_.push_back(Phase(phase, duration));
+}
+
+void StartupTimings::Report(const std::string& title) {
+    std::vector<Phase> phases;
+    {
+        base::AutoLock lock(lock_);
+        phases.swap(phases_);
+    }
+    if (phases.empty())
+        return;
+
+    base::TimeDelta total;
+    std::string report = title + " timings:";
+    std::vector<Phase>::const_iterator it;
+    for (it = phases.begin(); it != phases.end(); ++it) {
+        total += it->second;
+        report += base::StringPrintf("\n  %s: %.1f ms",
+                                     it->first.c_str(), it->second.InMillisecondsF());
+    }
+    report += base::StringPrintf("\n  total: %.1f ms", total.InMillisecondsF());
+    GlobalLogger::Log(kInfoLogLevel, report);
+}
+
+DeferredViewSupport::DeferredViewSupport()
+    : running_(false),
+      finished_(&lock_) {}
+
+DeferredViewSupport::~DeferredViewSupport() {}
+
+// static
+DeferredViewSupport* DeferredViewSupport::GetInstance() {
+    return Singleton<DeferredViewSupport>::get();
+}
+
+void DeferredViewSupport::Add(const std::string& name, const base::Closure& initializer) {
+    base::AutoLock lock(lock_);
+    pending_.push_back(Initializer(name, initializer));
+}
+
+bool DeferredViewSupport::HasPending() const {
+    base::AutoLock lock(lock_);
+    return !pending_.empty() || running_;
+}
+
+void DeferredViewSupport::RunPending() {
+    std::vector<Initializer> pending;
+    {
+        base::AutoLock lock(lock_);
+        // other session may be registering view types right now
+        while (running_)
+            finished_.Wait();
+        pending.swap(pending_);
+        if (pending.empty())
+            return;
+        running_ = true;
+    }
+
+    StartupTimings* timings = StartupTimings::GetInstance();
+    std::vector<Initializer>::const_iterator it;
+    for (it = pending.begin(); it != pending.end(); ++it) {
+        base::TimeTicks start = base::TimeTicks::Now();
+        it->second.Run();
+        timings->Add(it->first, base::TimeTicks::Now() - start);
+    }
+
+    {
+        base::AutoLock lock(lock_);
+        running_ = false;
+        finished_.Broadcast();
+    }
+    timings->Report("deferred view support");
+}
+
+}  // namespace webdriver
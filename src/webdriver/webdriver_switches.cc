@@ -30,8 +30,26 @@ const char Switches::kVNCLogin[] = "vnc-login";
 
 const char Switches::kUserInputDevice[] = "uinput";
 
+const char Switches::kViews[] = "views";
+
+const char Switches::kVisualizerXslt[] = "visualizer-xslt";
+
 const char Switches::kWhiteList[] = "white-list";
 
 const char Switches::kWebServerCfg[] = "webserver-cfg";
 
+const char Switches::kMaxBodySize[] = "max-body-size";
+
+const char Switches::kRequestTimeout[] = "request-timeout";
+
+const char Switches::kCompressionLevel[] = "compression-level";
+
+const char Switches::kCompressionThreshold[] = "compression-threshold";
+
+const char Switches::kHttpCacheDir[] = "http-cache-dir";
+
+const char Switches::kHttpCacheSize[] = "http-cache-size";
+
+const char Switches::kHttpCacheOffline[] = "http-cache-offline";
+
 }  // namespace webdriver
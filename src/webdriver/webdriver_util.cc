@@ -4,7 +4,6 @@
 
 #include "webdriver_util.h"
 
-#include "base/base64.h"
 #include "base/basictypes.h"
 #include "base/file_util.h"
 #include "base/format_macros.h"
@@ -18,6 +17,7 @@
 #include "base/string_split.h"
 #include "base/string_util.h"
 #include "base/third_party/icu/icu_utf.h"
+#include "base64_codec.h"
 
 using base::DictionaryValue;
 using base::ListValue;
@@ -35,12 +35,16 @@ std::string GenerateRandomID() {
 
 bool Base64Decode(const std::string& base64,
                   std::string* bytes) {
-    std::string copy = base64;
     // Some WebDriver client base64 encoders follow RFC 1521, which require that
-    // 'encoded lines be no more than 76 characters long'. Just remove any
-    // newlines.
-    RemoveChars(copy, "\n", &copy);
-    return base::Base64Decode(copy, bytes);
+    // 'encoded lines be no more than 76 characters long'. Decoder skips line
+    // breaks in place, without copying input.
+    bytes->clear();
+    return Base64DecodeAppend(base64.data(), base64.size(), bytes);
+}
+
+void Base64Encode(const std::string& bytes, std::string* base64) {
+    base64->clear();
+    Base64EncodeAppend(bytes.data(), bytes.size(), base64);
 }
 
 std::string JsonStringify(const Value* value) {
@@ -51,63 +55,49 @@ std::string JsonStringify(const Value* value) {
 
 namespace {
 
+const size_t kMaxLength = 100;
+
 // Truncates the given string to 100 characters, adding an ellipsis if
 // truncation was necessary.
 void TruncateString(std::string* data) {
-    const size_t kMaxLength = 100;
     if (data->length() > kMaxLength) {
         data->resize(kMaxLength);
         data->replace(kMaxLength - 3, 3, "...");
     }
 }
 
-// Truncates all strings contained in the given value.
-void TruncateContainedStrings(Value* value) {
-    ListValue* list;
-    if (value->IsType(Value::TYPE_DICTIONARY)) {
-        DictionaryValue* dict = static_cast<DictionaryValue*>(value);
-        DictionaryValue::key_iterator key = dict->begin_keys();
-        for (; key != dict->end_keys(); ++key) {
-            Value* child;
-            if (!dict->GetWithoutPathExpansion(*key, &child))
-                continue;
-            std::string data;
-            if (child->GetAsString(&data)) {
-                TruncateString(&data);
-                dict->SetWithoutPathExpansion(*key, Value::CreateStringValue(data));
-            } else {
-                TruncateContainedStrings(child);
-            }
+// Copies the given value with all contained strings truncated. Unlike
+// DeepCopy() followed by truncation, copy never holds long strings.
+Value* CopyWithTruncatedStrings(const Value* value) {
+    const ListValue* list;
+    const DictionaryValue* dict;
+    if (value->IsType(Value::TYPE_STRING)) {
+        // parsed values keep strings in own Value subclass, so go through
+        // GetAsString() rather than cast to StringValue
+        std::string data;
+        value->GetAsString(&data);
+        TruncateString(&data);
+        return Value::CreateStringValue(data);
+    } else if (value->GetAsDictionary(&dict)) {
+        DictionaryValue* copy = new DictionaryValue();
+        for (DictionaryValue::Iterator it(*dict); it.HasNext(); it.Advance()) {
+            copy->SetWithoutPathExpansion(
+                it.key(), CopyWithTruncatedStrings(&it.value()));
         }
+        return copy;
     } else if (value->GetAsList(&list)) {
-        for (size_t i = 0; i < list->GetSize(); ++i) {
-            Value* child;
-            if (!list->Get(i, &child))
-                continue;
-            std::string data;
-            if (child->GetAsString(&data)) {
-                TruncateString(&data);
-                list->Set(i, Value::CreateStringValue(data));
-            } else {
-                TruncateContainedStrings(child);
-            }
-        }
+        ListValue* copy = new ListValue();
+        for (ListValue::const_iterator it = list->begin(); it != list->end(); ++it)
+            copy->Append(CopyWithTruncatedStrings(*it));
+        return copy;
     }
+    return value->DeepCopy();
 }
 
 }  // namespace
 
 std::string JsonStringifyForDisplay(const Value* value) {
-    scoped_ptr<Value> copy;
-    if (value->IsType(Value::TYPE_STRING)) {
-        std::string data;
-        value->GetAsString(&data);
-        TruncateString(&data);
-        copy.reset(Value::CreateStringValue(data));
-    } else {
-        copy.reset(value->DeepCopy());
-        TruncateContainedStrings(copy.get());
-    }
+    scoped_ptr<Value> copy(CopyWithTruncatedStrings(value));
     std::string json;
     base::JSONWriter::WriteWithOptions(copy.get(),
                                      base::JSONWriter::OPTIONS_PRETTY_PRINT,
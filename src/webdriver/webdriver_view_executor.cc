@@ -19,7 +19,9 @@
 
 #include "webdriver_view_executor.h"
 
+#include "webdriver_error.h"
 #include "webdriver_session.h"
+
 namespace webdriver {
 
 ViewCmdExecutor::ViewCmdExecutor(Session* session, ViewId viewId)
@@ -28,6 +30,48 @@ ViewCmdExecutor::ViewCmdExecutor(Session* session, ViewId viewId)
 
 ViewCmdExecutor::~ViewCmdExecutor() {}
 
+void ViewCmdExecutor::GetScreenShotImage(ScreenshotFormat format, std::string* data, Error** error) {
+    if (kPngScreenshot != format) {
+        *error = new Error(kCommandNotSupported, "Current view supports only PNG screenshots.");
+        return;
+    }
+    GetScreenShot(data, error);
+}
+
+void ViewCmdExecutor::GetRepaintCount(int* count, Error** error) {
+    *error = new Error(kCommandNotSupported, "Current view doesnt track repaints.");
+}
+
+void ViewCmdExecutor::PerformActions(const base::ListValue* actions, Error** error) {
+    InputTimeline timeline;
+    InputTimelineBuilder builder(this, *session_->input_state(), session_->get_mouse_position());
+    if (!builder.Build(actions, &timeline, error))
+        return;
+
+    PlayInputTimeline(timeline, error);
+    if (!*error) {
+        *session_->input_state() = builder.state();
+        session_->set_mouse_position(builder.mouse_position());
+    }
+}
+
+void ViewCmdExecutor::ReleaseActions(Error** error) {
+    InputTimeline timeline;
+    InputTimelineBuilder builder(this, *session_->input_state(), session_->get_mouse_position());
+    builder.BuildRelease(&timeline);
+
+    if (!timeline.empty())
+        PlayInputTimeline(timeline, error);
+    if (!*error) {
+        *session_->input_state() = builder.state();
+        session_->set_mouse_position(builder.mouse_position());
+    }
+}
+
+void ViewCmdExecutor::PlayInputTimeline(const InputTimeline& timeline, Error** error) {
+    *error = new Error(kCommandNotSupported, "Current view doesnt support input actions.");
+}
+
 ViewCmdExecutorCreator::ViewCmdExecutorCreator() {}
 
 ViewCmdExecutorFactory* ViewCmdExecutorFactory::instance = NULL;
@@ -73,6 +117,24 @@ ViewCmdExecutor* ViewCmdExecutorFactory::CreateExecutor(Session* session, ViewId
 	return NULL;
 }
 
+ExecutorPtr ViewCmdExecutorFactory::GetExecutor(Session* session) const {
+	return GetExecutor(session, session->current_view());
+}
+
+ExecutorPtr ViewCmdExecutorFactory::GetExecutor(Session* session, const ViewId& viewId) const {
+	ExecutorPtr executor = session->GetViewExecutor(viewId);
+	if (NULL != executor.get())
+		return executor;
+
+	executor = CreateExecutor(session, viewId);
+	if (NULL == executor.get())
+		return executor;
+
+	// use executor cached by other thread, if it was first
+	ExecutorPtr cached = session->SetViewExecutor(viewId, executor.get());
+	return (NULL != cached.get()) ? cached : executor;
+}
+
 bool ViewCmdExecutorFactory::CanHandleView(Session* session, ViewId viewId, ViewType* viewType) const {
 	CreatorsList::const_iterator creator;
 
@@ -40,12 +40,10 @@ void ViewTransitionManager::HandleOldView(Session* session, const ViewId& viewId
 }
 
 void URLTransitionAction_CloseOldView::HandleOldView(Session* session, const ViewId& viewId) const {
-	typedef scoped_ptr<ViewCmdExecutor> ExecutorPtr;        
-
     Error* error = NULL;
     scoped_ptr<Error> ignore_error(NULL);
 
-    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->CreateExecutor(session, viewId));
+    ExecutorPtr executor(ViewCmdExecutorFactory::GetInstance()->GetExecutor(session, viewId));
 
     if (NULL == executor.get()) {
         return;
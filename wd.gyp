@@ -57,6 +57,8 @@
         ['platform == "desktop"', {
           'dependencies': [
             'wd_test.gyp:test_WD_hybrid_noWebkit',
+            'wd_test.gyp:test_vnc_client',
+            'wd_test.gyp:test_input_timeline',
           ],
           'conditions': [
             ['<(WD_CONFIG_WEBKIT) == 1', {
@@ -68,6 +70,7 @@
         ['platform == "desktop" and OS == "linux"', {
           'dependencies': [
             'wd_test.gyp:test_WD_hybrid_noWebkit_with_shared_libs',
+            'wd_test.gyp:test_uinput_manager',
           ],
         } ],
 
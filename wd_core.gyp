@@ -21,6 +21,7 @@
       ],
 
       'sources': [
+        'src/webdriver/commands/actions_command.cc',
         'src/webdriver/commands/alert_commands.cc',
         'src/webdriver/commands/appcache_status_command.cc',
         'src/webdriver/commands/command.cc',
@@ -56,6 +57,8 @@
         'src/webdriver/commands/browser_connection_command.cc',
         'src/webdriver/webdriver_route_patterns.cc',
         'src/webdriver/frame_path.cc',
+        'src/webdriver/base64_codec.cc',
+        'src/webdriver/http_compression.cc',
         'src/webdriver/http_response.cc',
         'src/webdriver/value_conversion_traits.cc',
         'src/webdriver/webdriver_access.cc',
@@ -64,14 +67,19 @@
         'src/webdriver/webdriver_element_id.cc',
         'src/webdriver/webdriver_view_id.cc',
         'src/webdriver/webdriver_error.cc',
+        'src/webdriver/webdriver_input_actions.cc',
         'src/webdriver/webdriver_logging.cc',
+        'src/webdriver/webdriver_network_rules.cc',
+        'src/webdriver/webdriver_async_script.cc',
         'src/webdriver/webdriver_server.cc',
         'src/webdriver/webdriver_route_table.cc',
         'src/webdriver/webdriver_view_enumerator.cc',
         'src/webdriver/webdriver_view_factory.cc',
         'src/webdriver/webdriver_view_executor.cc',
         'src/webdriver/webdriver_session.cc',
+        'src/webdriver/webdriver_source_diff.cc',
         'src/webdriver/webdriver_session_manager.cc',
+        'src/webdriver/webdriver_startup.cc',
         'src/webdriver/webdriver_switches.cc',
         'src/webdriver/webdriver_util.cc',
         'src/webdriver/webdriver_view_runner.cc',
@@ -89,6 +97,12 @@
             'src/third_party/mongoose/mongoose.c',
           ],
         } ],
+
+        [ '<(WD_CONFIG_ZLIB) == 1', {
+          'link_settings': {
+            'libraries': [ '-lz' ],
+          },
+        } ],
         
       ],
   } , {
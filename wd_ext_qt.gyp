@@ -31,6 +31,7 @@
         'src/webdriver/extension_qt/q_view_runner.cc',
         'src/webdriver/extension_qt/q_proxy_parser.cc',
         'src/webdriver/extension_qt/q_key_converter.cc',
+        'src/webdriver/extension_qt/q_input_timeline_player.cc',
         'src/webdriver/extension_qt/q_session_lifecycle_actions.cc',
         'src/webdriver/extension_qt/widget_view_util.cc',
         'src/webdriver/extension_qt/common_util.cc',
@@ -53,6 +54,8 @@
         'src/webdriver/extension_qt/uinput_manager.cc',
         'src/third_party/des/d3des.c',
         'src/vnc/vncserverparameters.cc',
+        'src/vnc/rfb_framebuffer.h',
+        'src/vnc/rfb_framebuffer.cc',
         'src/webdriver/extension_qt/vnc_event_dispatcher.cc',
         'src/webdriver/extension_qt/wd_event_dispatcher.cc',
         'src/webdriver/extension_qt/uinput_event_dispatcher.cc',
@@ -64,6 +67,16 @@
           'dependencies': [
             'src/third_party/mimetypes-qt4/mimetypes-qt4.gyp:mimetypes-qt4',
           ],
+        } ],
+
+        # in-process XSLT for visualizer
+        ['<(WD_CONFIG_XSLT) == 1', {
+          'include_dirs': [
+            '<(LIBXML2_INC_PATH)',
+          ],
+          'link_settings': {
+            'libraries': [ '-lxslt', '-lxml2' ],
+          },
         } ]
       ], # conditions
 
@@ -74,6 +87,8 @@
 
       'sources': [
         'src/webdriver/extension_qt/web_view_creator.cc',
+        'src/webdriver/extension_qt/q_network_cache.h',
+        'src/webdriver/extension_qt/q_network_cache.cc',
         'src/webdriver/extension_qt/web_view_executor.cc',
         'src/webdriver/extension_qt/web_view_enumerator.cc',
         'src/webdriver/extension_qt/web_view_visualizer.h',
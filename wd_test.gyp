@@ -531,6 +531,67 @@
           ],
         } ],
       ],
+    }, {
+      'target_name': 'test_vnc_client',
+      'type': 'executable',
+
+      'dependencies': [
+        'base.gyp:chromium_base',
+        'wd_core.gyp:WebDriver_core',
+        'wd_ext_qt.gyp:WebDriver_extension_qt_base',
+      ],
+
+      'include_dirs': [
+        'src/',
+      ],
+
+      'sources': [
+        'src/Test/StandaloneTest.h',
+        'src/Test/VNCClientTest.cc',
+      ],
+
+      'conditions': [
+        [ '<(WD_BUILD_MONGOOSE) == 0', {
+          'sources': [
+            'src/third_party/mongoose/mongoose.c',
+          ],
+        } ],
+      ],
+    }, {
+      'target_name': 'test_uinput_manager',
+      'type': 'executable',
+
+      'dependencies': [
+        'base.gyp:chromium_base',
+        'wd_core.gyp:WebDriver_core',
+        'wd_ext_qt.gyp:WebDriver_extension_qt_base',
+      ],
+
+      'sources': [
+        'src/Test/StandaloneTest.h',
+        'src/Test/UInputManagerTest.cc',
+      ],
+
+      'conditions': [
+        [ '<(WD_BUILD_MONGOOSE) == 0', {
+          'sources': [
+            'src/third_party/mongoose/mongoose.c',
+          ],
+        } ],
+      ],
+    }, {
+      'target_name': 'test_input_timeline',
+      'type': 'executable',
+
+      'dependencies': [
+        'base.gyp:chromium_base',
+        'wd_core.gyp:WebDriver_core',
+      ],
+
+      'sources': [
+        'src/Test/StandaloneTest.h',
+        'src/Test/InputTimelineTest.cc',
+      ],
     },
   ],
 }
@@ -499,7 +499,9 @@ VisualizerController.prototype.showVisualizationWindow = function(source, size)
   if (isQt) {
     var xsltProcessor = this.xsltProcessors.get(this.webPage);
     var receivedDoc = (new DOMParser()).parseFromString(source, 'application/xml');
-    receivedDoc = xsltProcessor.transformToDocument(receivedDoc);
+    // driver started with --visualizer-xslt sends already transformed html
+    if (receivedDoc.documentElement.nodeName.toLowerCase() != 'html')
+      receivedDoc = xsltProcessor.transformToDocument(receivedDoc);
     var visualizerDoc = this.visualizationWin.document;
     visualizerDoc.replaceChild(receivedDoc.documentElement, visualizerDoc.documentElement);
   } else {